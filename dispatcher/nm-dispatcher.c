@@ -41,6 +41,7 @@ static gboolean debug = FALSE;
 static gboolean persist = FALSE;
 static guint quit_id;
 static guint request_id_counter = 0;
+static int max_parallel = 8;
 
 typedef struct Request Request;
 
@@ -53,6 +54,17 @@ typedef struct {
 	Request *current_request;
 	GQueue *requests_waiting;
 	int num_requests_pending;
+
+	struct {
+		guint64 num_requests;
+		gint64 total_usec;
+		gint64 max_usec;
+		gint64 queued_total_usec;
+		gint64 queued_max_usec;
+
+		/* path -> ScriptStats */
+		GHashTable *scripts;
+	} stats;
 } Handler;
 
 typedef struct {
@@ -67,6 +79,13 @@ GType handler_get_type (void);
 
 G_DEFINE_TYPE(Handler, handler, G_TYPE_OBJECT)
 
+typedef struct {
+	guint64 num_runs;
+	guint64 num_failed;
+	gint64 total_usec;
+	gint64 max_usec;
+} ScriptStats;
+
 static gboolean
 handle_action (NMDBusDispatcher *dbus_dispatcher,
                GDBusMethodInvocation *context,
@@ -87,13 +106,27 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
                gboolean request_debug,
                gpointer user_data);
 
+static gboolean
+handle_get_statistics (NMDBusDispatcher *dbus_dispatcher,
+                       GDBusMethodInvocation *context,
+                       gpointer user_data);
+
+static void
+_script_stats_free (gpointer ptr)
+{
+	g_slice_free (ScriptStats, ptr);
+}
+
 static void
 handler_init (Handler *h)
 {
 	h->requests_waiting = g_queue_new ();
+	h->stats.scripts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, _script_stats_free);
 	h->dbus_dispatcher = nmdbus_dispatcher_skeleton_new ();
 	g_signal_connect (h->dbus_dispatcher, "handle-action",
 	                  G_CALLBACK (handle_action), h);
+	g_signal_connect (h->dbus_dispatcher, "handle-get-statistics",
+	                  G_CALLBACK (handle_get_statistics), h);
 }
 
 static void
@@ -111,9 +144,11 @@ typedef struct {
 	DispatchResult result;
 	char *error;
 	gboolean wait;
+	gboolean parallel;
 	gboolean dispatched;
 	guint watch_id;
 	guint timeout_id;
+	gint64 start_time;
 } ScriptInfo;
 
 struct Request {
@@ -131,6 +166,10 @@ struct Request {
 	guint idx;
 	int num_scripts_done;
 	int num_scripts_nowait;
+	int num_scripts_parallel;
+
+	gint64 start_time;
+	gint64 run_time;
 };
 
 /*****************************************************************************/
@@ -199,6 +238,7 @@ request_free (Request *request)
 {
 	g_assert_cmpuint (request->num_scripts_done, ==, request->scripts->len);
 	g_assert_cmpuint (request->num_scripts_nowait, ==, 0);
+	g_assert_cmpuint (request->num_scripts_parallel, ==, 0);
 
 	g_free (request->action);
 	g_free (request->iface);
@@ -261,10 +301,53 @@ next_request (Handler *h, Request *request)
 	_LOG_R_I (request, "start running ordered scripts...");
 
 	h->current_request = request;
+	request->run_time = g_get_monotonic_time ();
 
 	return TRUE;
 }
 
+static void
+request_stats_update (Request *request)
+{
+	Handler *handler = request->handler;
+	gint64 now = g_get_monotonic_time ();
+	gint64 usec;
+
+	usec = now - request->start_time;
+	handler->stats.num_requests++;
+	handler->stats.total_usec += usec;
+	handler->stats.max_usec = MAX (handler->stats.max_usec, usec);
+
+	/* how long the request waited in @requests_waiting for its
+	 * turn to run the ordered scripts. */
+	if (request->run_time) {
+		usec = request->run_time - request->start_time;
+		handler->stats.queued_total_usec += usec;
+		handler->stats.queued_max_usec = MAX (handler->stats.queued_max_usec, usec);
+	}
+}
+
+static void
+script_stats_update (ScriptInfo *script)
+{
+	GHashTable *stats = script->request->handler->stats.scripts;
+	ScriptStats *s;
+	gint64 usec;
+
+	s = g_hash_table_lookup (stats, script->script);
+	if (!s) {
+		s = g_slice_new0 (ScriptStats);
+		g_hash_table_insert (stats, g_strdup (script->script), s);
+	}
+
+	usec = g_get_monotonic_time () - script->start_time;
+	s->num_runs++;
+	if (script->result != DISPATCH_RESULT_SUCCESS)
+		s->num_failed++;
+	s->total_usec += usec;
+	s->max_usec = MAX (s->max_usec, usec);
+}
+
 /**
  * complete_request:
  * @request: the request
@@ -303,6 +386,8 @@ complete_request (Request *request)
 
 	_LOG_R_D (request, "completed (%u scripts)", request->scripts->len);
 
+	request_stats_update (request);
+
 	if (handler->current_request == request)
 		handler->current_request = NULL;
 
@@ -397,6 +482,8 @@ script_watch_cb (GPid pid, int status, gpointer user_data)
 	script->request->num_scripts_done++;
 	if (!script->wait)
 		script->request->num_scripts_nowait--;
+	if (script->parallel)
+		script->request->num_scripts_parallel--;
 
 	if (WIFEXITED (status)) {
 		err = WEXITSTATUS (status);
@@ -426,6 +513,8 @@ script_watch_cb (GPid pid, int status, gpointer user_data)
 
 	g_spawn_close_pid (script->pid);
 
+	script_stats_update (script);
+
 	complete_script (script);
 }
 
@@ -439,6 +528,8 @@ script_timeout_cb (gpointer user_data)
 	script->request->num_scripts_done++;
 	if (!script->wait)
 		script->request->num_scripts_nowait--;
+	if (script->parallel)
+		script->request->num_scripts_parallel--;
 
 	_LOG_S_W (script, "complete: timeout (kill script)");
 
@@ -454,6 +545,8 @@ again:
 
 	g_spawn_close_pid (script->pid);
 
+	script_stats_update (script);
+
 	complete_script (script);
 
 	return FALSE;
@@ -533,13 +626,20 @@ script_dispatch (ScriptInfo *script)
 	argv[2] = request->action;
 	argv[3] = NULL;
 
-	_LOG_S_D (script, "run script%s", script->wait ? "" : " (no-wait)");
+	_LOG_S_D (script, "run script%s",
+	          script->wait
+	          ? (script->parallel ? " (parallel)" : "")
+	          : " (no-wait)");
+
+	script->start_time = g_get_monotonic_time ();
 
 	if (g_spawn_async ("/", argv, request->envp, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL, &script->pid, &error)) {
 		script->watch_id = g_child_watch_add (script->pid, (GChildWatchFunc) script_watch_cb, script);
 		script->timeout_id = g_timeout_add_seconds (SCRIPT_TIMEOUT, script_timeout_cb, script);
 		if (!script->wait)
 			request->num_scripts_nowait++;
+		if (script->parallel)
+			request->num_scripts_parallel++;
 		return TRUE;
 	} else {
 		_LOG_S_W (script, "complete: failed to execute script: %s", error->message);
@@ -551,6 +651,17 @@ script_dispatch (ScriptInfo *script)
 	}
 }
 
+/**
+ * dispatch_one_script:
+ * @request: the current request
+ *
+ * Starts the next ordered script of @request. Consecutive "parallel" scripts
+ * are started together (up to @max_parallel at a time), and the following
+ * ordered script only runs after all of them completed.
+ *
+ * Returns: %TRUE, if there are still scripts running that the next
+ *   ordered script must wait for.
+ */
 static gboolean
 dispatch_one_script (Request *request)
 {
@@ -560,11 +671,20 @@ dispatch_one_script (Request *request)
 	while (request->idx < request->scripts->len) {
 		ScriptInfo *script;
 
-		script = g_ptr_array_index (request->scripts, request->idx++);
-		if (script_dispatch (script))
+		script = g_ptr_array_index (request->scripts, request->idx);
+
+		if (request->num_scripts_parallel > 0) {
+			if (   !script->parallel
+			    || request->num_scripts_parallel >= max_parallel)
+				return TRUE;
+		}
+
+		request->idx++;
+		if (   script_dispatch (script)
+		    && !script->parallel)
 			return TRUE;
 	}
-	return FALSE;
+	return request->num_scripts_parallel > 0;
 }
 
 static int
@@ -585,6 +705,119 @@ _compare_basenames (gconstpointer a, gconstpointer b)
 	return 0;
 }
 
+typedef struct {
+	char *path;
+	gboolean wait;
+	gboolean parallel;
+} ScriptEntry;
+
+typedef enum {
+	SCRIPT_SUBDIR_NONE,
+	SCRIPT_SUBDIR_PRE_UP,
+	SCRIPT_SUBDIR_PRE_DOWN,
+	_SCRIPT_SUBDIR_NUM,
+} ScriptSubdir;
+
+static const char *const script_subdir_names[_SCRIPT_SUBDIR_NUM] = {
+	[SCRIPT_SUBDIR_NONE]     = NULL,
+	[SCRIPT_SUBDIR_PRE_UP]   = "pre-up.d",
+	[SCRIPT_SUBDIR_PRE_DOWN] = "pre-down.d",
+};
+
+/* The sorted lists of scripts (ScriptEntry) for each subdirectory. They
+ * are kept as long as the directory monitors don't report any change
+ * to the dispatcher directories. */
+static struct {
+	GPtrArray *monitors;
+	GPtrArray *entries[_SCRIPT_SUBDIR_NUM];
+	gboolean initialized;
+	gboolean enabled;
+} script_cache;
+
+static void
+script_entry_free (gpointer ptr)
+{
+	ScriptEntry *entry = ptr;
+
+	g_free (entry->path);
+	g_slice_free (ScriptEntry, entry);
+}
+
+static void
+script_cache_invalidate (void)
+{
+	guint i;
+
+	for (i = 0; i < _SCRIPT_SUBDIR_NUM; i++)
+		nm_clear_pointer (&script_cache.entries[i], g_ptr_array_unref);
+}
+
+static void
+script_cache_monitor_changed_cb (GFileMonitor *monitor,
+                                 GFile *file,
+                                 GFile *other_file,
+                                 GFileMonitorEvent event_type,
+                                 gpointer user_data)
+{
+	script_cache_invalidate ();
+}
+
+static void
+script_cache_init (void)
+{
+	static const char *const bases[] = { NMLIBDIR, NMCONFDIR };
+	static const char *const subdirs[] = { NULL, "pre-up.d", "pre-down.d", "no-wait.d", "parallel.d" };
+	guint i, j;
+
+	if (script_cache.initialized)
+		return;
+	script_cache.initialized = TRUE;
+
+	/* Watch all directories which affect the result of find_scripts(),
+	 * including the target directories of "no-wait" and "parallel"
+	 * symlinks. If any of the monitors cannot be created, don't cache
+	 * but scan the directories for each request. */
+	script_cache.monitors = g_ptr_array_new_with_free_func (g_object_unref);
+	for (i = 0; i < G_N_ELEMENTS (bases); i++) {
+		for (j = 0; j < G_N_ELEMENTS (subdirs); j++) {
+			gs_free_error GError *error = NULL;
+			gs_unref_object GFile *file = NULL;
+			gs_free char *dirname = NULL;
+			GFileMonitor *monitor;
+
+			dirname = g_build_filename (bases[i], "dispatcher.d", subdirs[j], NULL);
+			file = g_file_new_for_path (dirname);
+			monitor = g_file_monitor_directory (file, G_FILE_MONITOR_WATCH_MOVES, NULL, &error);
+			if (!monitor) {
+				g_message ("find-scripts: Failed to monitor directory '%s': %s. Don't cache scripts",
+				           dirname, error->message);
+				nm_clear_pointer (&script_cache.monitors, g_ptr_array_unref);
+				return;
+			}
+			g_signal_connect (monitor, "changed", G_CALLBACK (script_cache_monitor_changed_cb), NULL);
+			g_ptr_array_add (script_cache.monitors, monitor);
+		}
+	}
+	script_cache.enabled = TRUE;
+}
+
+static void
+script_cache_shutdown (void)
+{
+	guint i;
+
+	script_cache_invalidate ();
+	if (script_cache.monitors) {
+		for (i = 0; i < script_cache.monitors->len; i++) {
+			g_signal_handlers_disconnect_by_func (script_cache.monitors->pdata[i],
+			                                      script_cache_monitor_changed_cb,
+			                                      NULL);
+		}
+		nm_clear_pointer (&script_cache.monitors, g_ptr_array_unref);
+	}
+	script_cache.enabled = FALSE;
+}
+
 static void
 _find_scripts (GHashTable *scripts, const char *base, const char *subdir)
 {
@@ -614,34 +847,77 @@ _find_scripts (GHashTable *scripts, const char *base, const char *subdir)
 	g_dir_close (dir);
 }
 
-static GSList *
-find_scripts (const char *str_action)
+static void
+script_get_mode (const char *path, gboolean *out_wait, gboolean *out_parallel)
+{
+	gs_free char *link = NULL;
+	gs_free char *dir = NULL;
+	gs_free char *real = NULL;
+	char *tmp;
+
+	*out_wait = TRUE;
+	*out_parallel = FALSE;
+
+	link = g_file_read_link (path, NULL);
+	if (!link)
+		return;
+
+	if (!g_path_is_absolute (link)) {
+		dir = g_path_get_dirname (path);
+		tmp = g_build_path ("/", dir, link, NULL);
+		g_free (link);
+		g_free (dir);
+		link = tmp;
+	}
+
+	dir = g_path_get_dirname (link);
+	real = realpath (dir, NULL);
+	if (!real)
+		return;
+
+	if (g_str_has_suffix (real, "/parallel.d")) {
+		*out_parallel = TRUE;
+		return;
+	}
+
+	/* same as before parallel.d was added: a symlink to a script
+	 * outside no-wait.d is not waited for. */
+	if (!g_str_has_suffix (real, "/no-wait.d"))
+		*out_wait = FALSE;
+}
+
+static int
+_compare_entry_basenames (gconstpointer a, gconstpointer b)
+{
+	const ScriptEntry *entry_a = *((const ScriptEntry *const *) a);
+	const ScriptEntry *entry_b = *((const ScriptEntry *const *) b);
+
+	return _compare_basenames (entry_a->path, entry_b->path);
+}
+
+static GPtrArray *
+_find_scripts_scan (const char *subdir)
 {
 	gs_unref_hashtable GHashTable *scripts = NULL;
-	GSList *script_list = NULL;
+	GPtrArray *entries;
 	GHashTableIter iter;
-	const char *subdir = NULL;
 	char *path;
 	char *filename;
 
-	if (   strcmp (str_action, NMD_ACTION_PRE_UP) == 0
-	    || strcmp (str_action, NMD_ACTION_VPN_PRE_UP) == 0)
-		subdir = "pre-up.d";
-	else if (   strcmp (str_action, NMD_ACTION_PRE_DOWN) == 0
-	         || strcmp (str_action, NMD_ACTION_VPN_PRE_DOWN) == 0)
-		subdir = "pre-down.d";
-
 	scripts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 
 	_find_scripts (scripts, NMLIBDIR, subdir);
 	_find_scripts (scripts, NMCONFDIR, subdir);
 
+	entries = g_ptr_array_new_full (g_hash_table_size (scripts), script_entry_free);
+
 	g_hash_table_iter_init (&iter, scripts);
 	while (g_hash_table_iter_next (&iter, (gpointer *) &filename, (gpointer *) &path)) {
 		struct stat st;
 		char *link_target;
 		int err;
 		const char *err_msg = NULL;
+		ScriptEntry *entry;
 
 		link_target = g_file_read_link (path, NULL);
 		if (g_strcmp0 (link_target, "/dev/null") == 0) {
@@ -659,40 +935,49 @@ find_scripts (const char *str_action)
 			g_warning ("find-scripts: Cannot execute '%s': %s", path, err_msg);
 		else {
 			/* success */
-			script_list = g_slist_prepend (script_list, g_strdup (path));
+			entry = g_slice_new (ScriptEntry);
+			entry->path = g_strdup (path);
+			script_get_mode (path, &entry->wait, &entry->parallel);
+			g_ptr_array_add (entries, entry);
 			continue;
 		}
 	}
 
-	return g_slist_sort (script_list, _compare_basenames);
+	g_ptr_array_sort (entries, _compare_entry_basenames);
+	return entries;
 }
 
-static gboolean
-script_must_wait (const char *path)
+/**
+ * find_scripts:
+ * @str_action: the dispatcher action
+ *
+ * Returns: (transfer container): the sorted list of #ScriptEntry
+ *   for @str_action.
+ */
+static GPtrArray *
+find_scripts (const char *str_action)
 {
-	gs_free char *link = NULL;
-	gs_free char *dir = NULL;
-	gs_free char *real = NULL;
-	char *tmp;
+	ScriptSubdir subdir = SCRIPT_SUBDIR_NONE;
+	GPtrArray *entries;
+
+	if (   strcmp (str_action, NMD_ACTION_PRE_UP) == 0
+	    || strcmp (str_action, NMD_ACTION_VPN_PRE_UP) == 0)
+		subdir = SCRIPT_SUBDIR_PRE_UP;
+	else if (   strcmp (str_action, NMD_ACTION_PRE_DOWN) == 0
+	         || strcmp (str_action, NMD_ACTION_VPN_PRE_DOWN) == 0)
+		subdir = SCRIPT_SUBDIR_PRE_DOWN;
 
+	script_cache_init ();
 
-	link = g_file_read_link (path, NULL);
-	if (link) {
-		if (!g_path_is_absolute (link)) {
-			dir = g_path_get_dirname (path);
-			tmp = g_build_path ("/", dir, link, NULL);
-			g_free (link);
-			g_free (dir);
-			link = tmp;
-		}
+	if (!script_cache.enabled)
+		return _find_scripts_scan (script_subdir_names[subdir]);
 
-		dir = g_path_get_dirname (link);
-		real = realpath (dir, NULL);
-		if (real && !g_str_has_suffix (real, "/no-wait.d"))
-			return FALSE;
+	entries = script_cache.entries[subdir];
+	if (!entries) {
+		entries = _find_scripts_scan (script_subdir_names[subdir]);
+		script_cache.entries[subdir] = entries;
 	}
-
-	return TRUE;
+	return g_ptr_array_ref (entries);
 }
 
 static gboolean
@@ -716,8 +1001,7 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
                gpointer user_data)
 {
 	Handler *h = user_data;
-	GSList *sorted_scripts = NULL;
-	GSList *iter;
+	gs_unref_ptrarray GPtrArray *sorted_scripts = NULL;
 	Request *request;
 	char **p;
 	guint i, num_nowait = 0;
@@ -727,6 +1011,7 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 
 	request = g_slice_new0 (Request);
 	request->request_id = ++request_id_counter;
+	request->start_time = g_get_monotonic_time ();
 	request->handler = h;
 	request->debug = request_debug || debug;
 	request->context = context;
@@ -749,17 +1034,18 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 	                                                    &request->iface,
 	                                                    &error_message);
 
-	request->scripts = g_ptr_array_new_full (5, script_info_free);
-	for (iter = sorted_scripts; iter; iter = g_slist_next (iter)) {
+	request->scripts = g_ptr_array_new_full (sorted_scripts->len, script_info_free);
+	for (i = 0; i < sorted_scripts->len; i++) {
+		const ScriptEntry *entry = sorted_scripts->pdata[i];
 		ScriptInfo *s;
 
 		s = g_slice_new0 (ScriptInfo);
 		s->request = request;
-		s->script = iter->data;
-		s->wait = script_must_wait (s->script);
+		s->script = g_strdup (entry->path);
+		s->wait = entry->wait;
+		s->parallel = entry->parallel;
 		g_ptr_array_add (request->scripts, s);
 	}
-	g_slist_free (sorted_scripts);
 
 	_LOG_R_I (request, "new request (%u scripts)", request->scripts->len);
 	if (   _LOG_R_D_enabled (request)
@@ -832,6 +1118,43 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 	return TRUE;
 }
 
+static gboolean
+handle_get_statistics (NMDBusDispatcher *dbus_dispatcher,
+                       GDBusMethodInvocation *context,
+                       gpointer user_data)
+{
+	Handler *h = user_data;
+	GVariantBuilder requests;
+	GVariantBuilder scripts;
+	GHashTableIter iter;
+	const char *path;
+	const ScriptStats *stats;
+
+	g_variant_builder_init (&requests, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&requests, "{sv}", "num-requests", g_variant_new_uint64 (h->stats.num_requests));
+	g_variant_builder_add (&requests, "{sv}", "num-pending", g_variant_new_uint32 (h->num_requests_pending));
+	g_variant_builder_add (&requests, "{sv}", "num-queued", g_variant_new_uint32 (g_queue_get_length (h->requests_waiting)));
+	g_variant_builder_add (&requests, "{sv}", "total-usec", g_variant_new_uint64 (h->stats.total_usec));
+	g_variant_builder_add (&requests, "{sv}", "max-usec", g_variant_new_uint64 (h->stats.max_usec));
+	g_variant_builder_add (&requests, "{sv}", "queued-total-usec", g_variant_new_uint64 (h->stats.queued_total_usec));
+	g_variant_builder_add (&requests, "{sv}", "queued-max-usec", g_variant_new_uint64 (h->stats.queued_max_usec));
+
+	g_variant_builder_init (&scripts, G_VARIANT_TYPE ("a(stttt)"));
+	g_hash_table_iter_init (&iter, h->stats.scripts);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &path, (gpointer *) &stats)) {
+		g_variant_builder_add (&scripts, "(stttt)",
+		                       path,
+		                       stats->num_runs,
+		                       stats->num_failed,
+		                       (guint64) stats->total_usec,
+		                       (guint64) stats->max_usec);
+	}
+
+	g_dbus_method_invocation_return_value (context,
+	                                       g_variant_new ("(a{sv}a(stttt))", &requests, &scripts));
+	return TRUE;
+}
+
 static gboolean ever_acquired_name = FALSE;
 
 static void
@@ -935,6 +1258,7 @@ main (int argc, char **argv)
 	GOptionEntry entries[] = {
 		{ "debug", 0, 0, G_OPTION_ARG_NONE, &debug, "Output to console rather than syslog", NULL },
 		{ "persist", 0, 0, G_OPTION_ARG_NONE, &persist, "Don't quit after a short timeout", NULL },
+		{ "max-parallel", 0, 0, G_OPTION_ARG_INT, &max_parallel, "Maximum number of parallel scripts to run at once (default 8)", "N" },
 		{ NULL }
 	};
 
@@ -950,6 +1274,9 @@ main (int argc, char **argv)
 
 	g_option_context_free (opt_ctx);
 
+	if (max_parallel < 1)
+		max_parallel = 1;
+
 	g_unix_signal_add (SIGTERM, signal_handler, GINT_TO_POINTER (SIGTERM));
 	g_unix_signal_add (SIGINT, signal_handler, GINT_TO_POINTER (SIGINT));
 
@@ -997,7 +1324,10 @@ main (int argc, char **argv)
 
 	g_main_loop_run (loop);
 
+	script_cache_shutdown ();
+
 	g_queue_free (handler->requests_waiting);
+	g_hash_table_unref (handler->stats.scripts);
 	g_object_unref (handler);
 
 	if (!debug)
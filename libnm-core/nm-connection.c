@@ -64,7 +64,9 @@ static guint signals[LAST_SIGNAL] = { 0 };
 typedef struct {
 	NMConnection *self;
 
-	GHashTable *settings;
+	/* the settings, indexed by their NMMetaSettingType. */
+	NMSetting *settings[_NM_META_SETTING_TYPE_NUM];
+	guint n_settings;
 
 	/* D-Bus path of the connection, if any */
 	char *path;
@@ -77,18 +79,79 @@ static NMConnectionPrivate *nm_connection_get_private (NMConnection *connection)
 
 /*****************************************************************************/
 
-static gpointer
-_gtype_to_hash_key (GType gtype)
+static NMMetaSettingType
+_get_meta_type (GType setting_type)
+{
+	const NMMetaSettingInfo *setting_info;
+
+	setting_info = nm_meta_setting_infos_by_gtype (setting_type);
+	if (!setting_info)
+		return NM_META_SETTING_TYPE_UNKNOWN;
+
+	nm_assert (setting_info->meta_type < _NM_META_SETTING_TYPE_NUM);
+	return setting_info->meta_type;
+}
+
+static NMMetaSettingType
+_setting_get_meta_type (NMSetting *setting)
+{
+	const NMMetaSettingInfo *setting_info = NM_SETTING_GET_CLASS (setting)->setting_info;
+
+	nm_assert (setting_info);
+	nm_assert (setting_info->get_setting_gtype () == G_OBJECT_TYPE (setting));
+
+	return setting_info->meta_type;
+}
+
+static int
+_meta_type_sort (gconstpointer p_a, gconstpointer p_b, gpointer unused)
 {
-#if NM_MORE_ASSERTS
-	_nm_unused const gsize *const test_gtype_typedef = &gtype;
+	const NMMetaSettingInfo *a = &nm_meta_setting_infos[*((const NMMetaSettingType *) p_a)];
+	const NMMetaSettingInfo *b = &nm_meta_setting_infos[*((const NMMetaSettingType *) p_b)];
 
-	nm_assert ((GType) (GPOINTER_TO_SIZE (GSIZE_TO_POINTER (gtype))) == gtype);
-	G_STATIC_ASSERT_EXPR (sizeof (gpointer) >= sizeof (gsize));
-	G_STATIC_ASSERT_EXPR (sizeof (gsize) == sizeof (GType));
-#endif
+	NM_CMP_FIELD (a, b, setting_priority);
+	return strcmp (a->setting_name, b->setting_name);
+}
+
+/* Returns the meta types sorted by setting priority and name. This is the
+ * order in which the settings of a connection are iterated. */
+static const NMMetaSettingType *
+_meta_types_by_priority (void)
+{
+	static NMMetaSettingType types[_NM_META_SETTING_TYPE_NUM];
+	static gsize initialized = 0;
+
+	if (g_once_init_enter (&initialized)) {
+		NMMetaSettingType t;
+
+		for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++)
+			types[t] = t;
+		g_qsort_with_data (types, _NM_META_SETTING_TYPE_NUM, sizeof (types[0]), _meta_type_sort, NULL);
+		g_once_init_leave (&initialized, 1);
+	}
+	return types;
+}
+
+/* Fills @settings with the settings of @priv in priority order.
+ * @settings must have room for _NM_META_SETTING_TYPE_NUM entries. */
+static guint
+_get_settings_sorted (NMConnectionPrivate *priv, NMSetting **settings)
+{
+	const NMMetaSettingType *types;
+	guint i, n;
 
-	return GSIZE_TO_POINTER (gtype);
+	if (priv->n_settings == 0)
+		return 0;
+
+	types = _meta_types_by_priority ();
+	for (i = 0, n = 0; i < _NM_META_SETTING_TYPE_NUM; i++) {
+		NMSetting *setting = priv->settings[types[i]];
+
+		if (setting)
+			settings[n++] = setting;
+	}
+	nm_assert (n == priv->n_settings);
+	return n;
 }
 
 /*****************************************************************************/
@@ -108,9 +171,20 @@ _setting_release (NMConnection *connection, NMSetting *setting)
 }
 
 static gboolean
-_setting_release_hfr (gpointer key, gpointer value, gpointer user_data)
+_settings_clear (NMConnectionPrivate *priv)
 {
-	_setting_release (user_data, value);
+	NMMetaSettingType t;
+
+	if (priv->n_settings == 0)
+		return FALSE;
+
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		gs_unref_object NMSetting *setting = g_steal_pointer (&priv->settings[t]);
+
+		if (setting)
+			_setting_release (priv->self, setting);
+	}
+	priv->n_settings = 0;
 	return TRUE;
 }
 
@@ -118,19 +192,22 @@ static void
 _nm_connection_add_setting (NMConnection *connection, NMSetting *setting)
 {
 	NMConnectionPrivate *priv;
-	GType setting_type;
-	NMSetting *s_old;
+	NMMetaSettingType meta_type;
+	gs_unref_object NMSetting *s_old = NULL;
 
 	nm_assert (NM_IS_CONNECTION (connection));
 	nm_assert (NM_IS_SETTING (setting));
 
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
-	setting_type = G_OBJECT_TYPE (setting);
+	meta_type = _setting_get_meta_type (setting);
 
-	if ((s_old = g_hash_table_lookup (priv->settings, _gtype_to_hash_key (setting_type))))
+	s_old = g_steal_pointer (&priv->settings[meta_type]);
+	if (s_old)
 		_setting_release (connection, s_old);
+	else
+		priv->n_settings++;
 
-	g_hash_table_insert (priv->settings, _gtype_to_hash_key (setting_type), setting);
+	priv->settings[meta_type] = setting;
 
 	g_signal_connect (setting, "notify", (GCallback) setting_changed_cb, connection);
 }
@@ -159,16 +236,21 @@ gboolean
 _nm_connection_remove_setting (NMConnection *connection, GType setting_type)
 {
 	NMConnectionPrivate *priv;
-	NMSetting *setting;
+	NMMetaSettingType meta_type;
+	gs_unref_object NMSetting *setting = NULL;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
 	g_return_val_if_fail (g_type_is_a (setting_type, NM_TYPE_SETTING), FALSE);
 
+	meta_type = _get_meta_type (setting_type);
+	if (meta_type == NM_META_SETTING_TYPE_UNKNOWN)
+		return FALSE;
+
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
-	setting = g_hash_table_lookup (priv->settings, _gtype_to_hash_key (setting_type));
+	setting = g_steal_pointer (&priv->settings[meta_type]);
 	if (setting) {
-		g_signal_handlers_disconnect_by_func (setting, setting_changed_cb, connection);
-		g_hash_table_remove (priv->settings, _gtype_to_hash_key (setting_type));
+		priv->n_settings--;
+		_setting_release (connection, setting);
 		g_signal_emit (connection, signals[CHANGED], 0);
 		return TRUE;
 	}
@@ -190,25 +272,39 @@ nm_connection_remove_setting (NMConnection *connection, GType setting_type)
 }
 
 static gpointer
-_connection_get_setting (NMConnection *connection, GType setting_type)
+_connection_get_setting_by_meta_type (NMConnection *connection, NMMetaSettingType meta_type)
 {
 	NMSetting *setting;
 
 	nm_assert (NM_IS_CONNECTION (connection));
-	nm_assert (g_type_is_a (setting_type, NM_TYPE_SETTING));
+	nm_assert (meta_type < _NM_META_SETTING_TYPE_NUM);
 
-	setting = g_hash_table_lookup (NM_CONNECTION_GET_PRIVATE (connection)->settings,
-	                               _gtype_to_hash_key (setting_type));
-	nm_assert (!setting || G_TYPE_CHECK_INSTANCE_TYPE (setting, setting_type));
+	setting = NM_CONNECTION_GET_PRIVATE (connection)->settings[meta_type];
+	nm_assert (!setting || _setting_get_meta_type (setting) == meta_type);
 	return setting;
 }
 
 static gpointer
-_connection_get_setting_check (NMConnection *connection, GType setting_type)
+_connection_get_setting_by_meta_type_check (NMConnection *connection, NMMetaSettingType meta_type)
 {
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 
-	return _connection_get_setting (connection, setting_type);
+	return _connection_get_setting_by_meta_type (connection, meta_type);
+}
+
+static gpointer
+_connection_get_setting (NMConnection *connection, GType setting_type)
+{
+	NMMetaSettingType meta_type;
+
+	nm_assert (NM_IS_CONNECTION (connection));
+	nm_assert (g_type_is_a (setting_type, NM_TYPE_SETTING));
+
+	meta_type = _get_meta_type (setting_type);
+	if (meta_type == NM_META_SETTING_TYPE_UNKNOWN)
+		return NULL;
+
+	return _connection_get_setting_by_meta_type (connection, meta_type);
 }
 
 /**
@@ -225,9 +321,10 @@ _connection_get_setting_check (NMConnection *connection, GType setting_type)
 NMSetting *
 nm_connection_get_setting (NMConnection *connection, GType setting_type)
 {
+	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 	g_return_val_if_fail (g_type_is_a (setting_type, NM_TYPE_SETTING), NULL);
 
-	return _connection_get_setting_check (connection, setting_type);
+	return _connection_get_setting (connection, setting_type);
 }
 
 NMSettingIPConfig *
@@ -236,10 +333,10 @@ nm_connection_get_setting_ip_config (NMConnection *connection,
 {
 	nm_assert_addr_family (addr_family);
 
-	return NM_SETTING_IP_CONFIG (_connection_get_setting (connection,
-	                                                        (addr_family == AF_INET)
-	                                                      ? NM_TYPE_SETTING_IP4_CONFIG
-	                                                      : NM_TYPE_SETTING_IP6_CONFIG));
+	return NM_SETTING_IP_CONFIG (_connection_get_setting_by_meta_type (connection,
+	                                                                     (addr_family == AF_INET)
+	                                                                   ? NM_META_SETTING_TYPE_IP4_CONFIG
+	                                                                   : NM_META_SETTING_TYPE_IP6_CONFIG));
 }
 
 /**
@@ -256,12 +353,13 @@ nm_connection_get_setting_ip_config (NMConnection *connection,
 NMSetting *
 nm_connection_get_setting_by_name (NMConnection *connection, const char *name)
 {
-	GType type;
+	const NMMetaSettingInfo *setting_info;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
+	g_return_val_if_fail (name, NULL);
 
-	type = nm_setting_lookup_type (name);
-	return type ? _connection_get_setting (connection, type) : NULL;
+	setting_info = nm_meta_setting_infos_by_name (name);
+	return setting_info ? _connection_get_setting_by_meta_type (connection, setting_info->meta_type) : NULL;
 }
 
 /*****************************************************************************/
@@ -426,10 +524,9 @@ _nm_connection_replace_settings (NMConnection *connection,
 		settings = g_slist_prepend (settings, setting);
 	}
 
-	if (g_hash_table_size (priv->settings) > 0) {
-		g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, connection);
+	if (_settings_clear (priv))
 		changed = TRUE;
-	} else
+	else
 		changed = (settings != NULL);
 
 	/* Note: @settings might be empty in which case the connection
@@ -491,8 +588,7 @@ nm_connection_replace_settings_from_connection (NMConnection *connection,
                                                 NMConnection *new_connection)
 {
 	NMConnectionPrivate *priv, *new_priv;
-	GHashTableIter iter;
-	NMSetting *setting;
+	NMMetaSettingType t;
 	gboolean changed;
 
 	g_return_if_fail (NM_IS_CONNECTION (connection));
@@ -511,13 +607,13 @@ nm_connection_replace_settings_from_connection (NMConnection *connection,
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 	new_priv = NM_CONNECTION_GET_PRIVATE (new_connection);
 
-	if ((changed = g_hash_table_size (priv->settings) > 0))
-		g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, connection);
+	changed = _settings_clear (priv);
 
-	if (g_hash_table_size (new_priv->settings)) {
-		g_hash_table_iter_init (&iter, new_priv->settings);
-		while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting))
-			_nm_connection_add_setting (connection, nm_setting_duplicate (setting));
+	if (new_priv->n_settings > 0) {
+		for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+			if (new_priv->settings[t])
+				_nm_connection_add_setting (connection, nm_setting_duplicate (new_priv->settings[t]));
+		}
 		changed = TRUE;
 	}
 
@@ -540,10 +636,8 @@ nm_connection_clear_settings (NMConnection *connection)
 
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 
-	if (g_hash_table_size (priv->settings) > 0) {
-		g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, connection);
+	if (_settings_clear (priv))
 		g_signal_emit (connection, signals[CHANGED], 0);
-	}
 }
 
 /**
@@ -563,23 +657,31 @@ nm_connection_compare (NMConnection *a,
                        NMConnection *b,
                        NMSettingCompareFlags flags)
 {
-	GHashTableIter iter;
-	NMSetting *src;
+	NMConnectionPrivate *priv_a, *priv_b;
+	NMMetaSettingType t;
 
 	if (a == b)
 		return TRUE;
 	if (!a || !b)
 		return FALSE;
 
+	priv_a = NM_CONNECTION_GET_PRIVATE (a);
+	priv_b = NM_CONNECTION_GET_PRIVATE (b);
+
 	/* B / A: ensure settings in B that are not in A make the comparison fail */
-	if (g_hash_table_size (NM_CONNECTION_GET_PRIVATE (a)->settings) !=
-	    g_hash_table_size (NM_CONNECTION_GET_PRIVATE (b)->settings))
+	if (priv_a->n_settings != priv_b->n_settings)
 		return FALSE;
 
 	/* A / B: ensure all settings in A match corresponding ones in B */
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (a)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &src)) {
-		NMSetting *cmp = nm_connection_get_setting (b, G_OBJECT_TYPE (src));
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		NMSetting *src = priv_a->settings[t];
+		NMSetting *cmp = priv_b->settings[t];
+
+		if (!src) {
+			if (cmp)
+				return FALSE;
+			continue;
+		}
 
 		if (   !cmp
 		    || !_nm_setting_compare (a, src, b, cmp, flags))
@@ -597,19 +699,23 @@ diff_one_connection (NMConnection *a,
                      GHashTable *diffs)
 {
 	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (a);
-	GHashTableIter iter;
-	NMSetting *a_setting = NULL;
+	NMConnectionPrivate *priv_b = b ? NM_CONNECTION_GET_PRIVATE (b) : NULL;
+	NMMetaSettingType t;
 	gboolean diff_found = FALSE;
 
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &a_setting)) {
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		NMSetting *a_setting = priv->settings[t];
 		NMSetting *b_setting = NULL;
-		const char *setting_name = nm_setting_get_name (a_setting);
+		const char *setting_name;
 		GHashTable *results;
 		gboolean new_results = TRUE;
 
-		if (b)
-			b_setting = nm_connection_get_setting (b, G_OBJECT_TYPE (a_setting));
+		if (!a_setting)
+			continue;
+
+		setting_name = nm_setting_get_name (a_setting);
+		if (priv_b)
+			b_setting = priv_b->settings[t];
 
 		results = g_hash_table_lookup (diffs, setting_name);
 		if (results)
@@ -685,14 +791,16 @@ NMSetting *
 _nm_connection_find_base_type_setting (NMConnection *connection)
 {
 	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
-	GHashTableIter iter;
+	NMMetaSettingType t;
 	NMSetting *setting = NULL;
 	NMSetting *s_iter;
 	NMSettingPriority setting_prio = NM_SETTING_PRIORITY_USER;
 	NMSettingPriority s_iter_prio;
 
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &s_iter)) {
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		if (!(s_iter = priv->settings[t]))
+			continue;
+
 		s_iter_prio = _nm_setting_get_base_type_priority (s_iter);
 		if (s_iter_prio == NM_SETTING_PRIORITY_INVALID)
 			continue;
@@ -791,15 +899,19 @@ const char *
 _nm_connection_detect_slave_type (NMConnection *connection, NMSetting **out_s_port)
 {
 	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
-	GHashTableIter iter;
+	NMMetaSettingType t;
 	const char *slave_type = NULL;
 	NMSetting *s_port = NULL, *s_iter;
 
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &s_iter)) {
-		const char *name = nm_setting_get_name (s_iter);
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		const char *name;
 		const char *i_slave_type = NULL;
 
+		if (!(s_iter = priv->settings[t]))
+			continue;
+
+		name = nm_setting_get_name (s_iter);
+
 		if (!strcmp (name, NM_SETTING_BRIDGE_PORT_SETTING_NAME))
 			i_slave_type = NM_SETTING_BRIDGE_SETTING_NAME;
 		else if (!strcmp (name, NM_SETTING_TEAM_PORT_SETTING_NAME))
@@ -1395,8 +1507,8 @@ _nm_connection_verify (NMConnection *connection, GError **error)
 	NMSettingConnection *s_con;
 	NMSettingIPConfig *s_ip4, *s_ip6;
 	NMSettingProxy *s_proxy;
-	GHashTableIter iter;
-	gpointer value;
+	NMSetting *settings[_NM_META_SETTING_TYPE_NUM];
+	guint i, n_settings;
 	GSList *all_settings = NULL, *setting_i;
 	gs_free_error GError *normalizable_error = NULL;
 	NMSettingVerifyResult normalizable_error_type = NM_SETTING_VERIFY_SUCCESS;
@@ -1417,19 +1529,17 @@ _nm_connection_verify (NMConnection *connection, GError **error)
 		return NM_SETTING_VERIFY_ERROR;
 	}
 
-	/* Build up the list of settings */
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, &value)) {
-		/* Order NMSettingConnection so that it will be verified first.
-		 * The reason is, that errors in this setting might be more fundamental
-		 * and should be checked and reported with higher priority.
-		 */
-		if (value == s_con)
-			all_settings = g_slist_append (all_settings, value);
-		else
-			all_settings = g_slist_prepend (all_settings, value);
+	/* Build up the list of settings in priority order */
+	n_settings = _get_settings_sorted (priv, settings);
+	for (i = n_settings; i > 0; i--) {
+		if (settings[i - 1] != (NMSetting *) s_con)
+			all_settings = g_slist_prepend (all_settings, settings[i - 1]);
 	}
-	all_settings = g_slist_reverse (all_settings);
+	/* Order NMSettingConnection so that it will be verified first.
+	 * The reason is, that errors in this setting might be more fundamental
+	 * and should be checked and reported with higher priority.
+	 */
+	all_settings = g_slist_prepend (all_settings, s_con);
 
 	/* Now, run the verify function of each setting */
 	for (setting_i = all_settings; setting_i; setting_i = setting_i->next) {
@@ -1572,14 +1682,19 @@ _nm_connection_verify (NMConnection *connection, GError **error)
 gboolean
 nm_connection_verify_secrets (NMConnection *connection, GError **error)
 {
-	GHashTableIter iter;
+	NMConnectionPrivate *priv;
+	NMMetaSettingType t;
 	NMSetting *setting;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
 	g_return_val_if_fail (!error || !*error, FALSE);
 
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (connection)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		if (!(setting = priv->settings[t]))
+			continue;
+
 		if (!nm_setting_verify_secrets (setting, connection, error))
 			return FALSE;
 	}
@@ -1833,11 +1948,9 @@ nm_connection_need_secrets (NMConnection *connection,
                             GPtrArray **hints)
 {
 	NMConnectionPrivate *priv;
-	GHashTableIter hiter;
-	GSList *settings = NULL;
-	GSList *iter;
+	NMSetting *settings[_NM_META_SETTING_TYPE_NUM];
+	guint i, n_settings;
 	const char *name = NULL;
-	NMSetting *setting;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 	if (hints)
@@ -1846,14 +1959,12 @@ nm_connection_need_secrets (NMConnection *connection,
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 
 	/* Get list of settings in priority order */
-	g_hash_table_iter_init (&hiter, priv->settings);
-	while (g_hash_table_iter_next (&hiter, NULL, (gpointer) &setting))
-		settings = g_slist_insert_sorted (settings, setting, _nm_setting_compare_priority);
+	n_settings = _get_settings_sorted (priv, settings);
 
-	for (iter = settings; iter; iter = g_slist_next (iter)) {
+	for (i = 0; i < n_settings; i++) {
+		NMSetting *setting = settings[i];
 		GPtrArray *secrets;
 
-		setting = NM_SETTING (iter->data);
 		secrets = _nm_setting_need_secrets (setting);
 		if (secrets) {
 			if (hints)
@@ -1866,7 +1977,6 @@ nm_connection_need_secrets (NMConnection *connection,
 		}
 	}
 
-	g_slist_free (settings);
 	return name;
 }
 
@@ -1897,13 +2007,18 @@ nm_connection_clear_secrets_with_flags (NMConnection *connection,
                                         NMSettingClearSecretsWithFlagsFn func,
                                         gpointer user_data)
 {
-	GHashTableIter iter;
+	NMConnectionPrivate *priv;
+	NMMetaSettingType t;
 	NMSetting *setting;
 
 	g_return_if_fail (NM_IS_CONNECTION (connection));
 
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (connection)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		if (!(setting = priv->settings[t]))
+			continue;
+
 		g_signal_handlers_block_by_func (setting, (GCallback) setting_changed_cb, connection);
 		_nm_setting_clear_secrets (setting, func, user_data);
 		g_signal_handlers_unblock_by_func (setting, (GCallback) setting_changed_cb, connection);
@@ -2032,8 +2147,8 @@ nm_connection_to_dbus (NMConnection *connection,
 {
 	NMConnectionPrivate *priv;
 	GVariantBuilder builder;
-	GHashTableIter iter;
-	gpointer data;
+	NMSetting *settings[_NM_META_SETTING_TYPE_NUM];
+	guint i, n_settings;
 	GVariant *setting_dict, *ret;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
@@ -2042,9 +2157,9 @@ nm_connection_to_dbus (NMConnection *connection,
 	g_variant_builder_init (&builder, NM_VARIANT_TYPE_CONNECTION);
 
 	/* Add each setting's hash to the main hash */
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, &data)) {
-		NMSetting *setting = NM_SETTING (data);
+	n_settings = _get_settings_sorted (priv, settings);
+	for (i = 0; i < n_settings; i++) {
+		NMSetting *setting = settings[i];
 
 		setting_dict = _nm_setting_to_dbus (setting, connection, flags);
 		if (setting_dict)
@@ -2082,19 +2197,6 @@ nm_connection_is_type (NMConnection *connection, const char *type)
 	return nm_streq0 (type, nm_connection_get_connection_type (connection));
 }
 
-static int
-_for_each_sort (NMSetting **p_a, NMSetting **p_b, void *unused)
-{
-	NMSetting *a = *p_a;
-	NMSetting *b = *p_b;
-	int c;
-
-	c = _nm_setting_compare_priority (a, b);
-	if (c != 0)
-		return c;
-	return strcmp (nm_setting_get_name (a), nm_setting_get_name (b));
-}
-
 /**
  * nm_connection_get_settings:
  * @connection: the #NMConnection instance
@@ -2117,34 +2219,23 @@ nm_connection_get_settings (NMConnection *connection,
 {
 	NMConnectionPrivate *priv;
 	NMSetting **arr;
-	GHashTableIter iter;
-	NMSetting *setting;
-	guint i, size;
+	guint size;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 
-	size = g_hash_table_size (priv->settings);
-
-	if (!size) {
+	if (!priv->n_settings) {
 		NM_SET_OUT (out_length, 0);
 		return NULL;
 	}
 
-	arr = g_new (NMSetting *, size + 1);
-
-	g_hash_table_iter_init (&iter, priv->settings);
-	for (i = 0; g_hash_table_iter_next (&iter, NULL, (gpointer *) &setting); i++)
-		arr[i] = setting;
-	nm_assert (i == size);
+	/* the settings are returned sorted by priority. This has an effect on
+	 * the order in which keyfile prints them. */
+	arr = g_new (NMSetting *, priv->n_settings + 1);
+	size = _get_settings_sorted (priv, arr);
 	arr[size] = NULL;
 
-	/* sort the settings. This has an effect on the order in which keyfile
-	 * prints them. */
-	if (size > 1)
-		g_qsort_with_data (arr, size, sizeof (NMSetting *), (GCompareDataFunc) _for_each_sort, NULL);
-
 	NM_SET_OUT (out_length, size);
 	return arr;
 }
@@ -2196,7 +2287,7 @@ _nm_connection_aggregate (NMConnection *connection,
                           gpointer arg)
 {
 	NMConnectionPrivate *priv;
-	GHashTableIter iter;
+	NMMetaSettingType t;
 	NMSetting *setting;
 	gboolean arg_boolean;
 	gboolean completed_early;
@@ -2220,8 +2311,10 @@ good:
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 
 	completed_early = FALSE;
-	g_hash_table_iter_init (&iter, priv->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
+	for (t = 0; t < _NM_META_SETTING_TYPE_NUM; t++) {
+		if (!(setting = priv->settings[t]))
+			continue;
+
 		if (_nm_setting_aggregate (setting, type, my_arg)) {
 			completed_early = TRUE;
 			break;
@@ -2253,16 +2346,19 @@ good:
 void
 nm_connection_dump (NMConnection *connection)
 {
-	GHashTableIter iter;
-	NMSetting *setting;
+	NMConnectionPrivate *priv;
+	NMSetting *settings[_NM_META_SETTING_TYPE_NUM];
+	guint i, n;
 	char *str;
 
 	if (!connection)
 		return;
 
-	g_hash_table_iter_init (&iter, NM_CONNECTION_GET_PRIVATE (connection)->settings);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting)) {
-		str = nm_setting_to_string (setting);
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	n = _get_settings_sorted (priv, settings);
+	for (i = 0; i < n; i++) {
+		str = nm_setting_to_string (settings[i]);
 		g_print ("%s\n", str);
 		g_free (str);
 	}
@@ -2539,7 +2635,7 @@ nm_connection_get_virtual_device_description (NMConnection *connection)
 NMSetting8021x *
 nm_connection_get_setting_802_1x (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_802_1X);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_802_1X);
 }
 
 /**
@@ -2553,7 +2649,7 @@ nm_connection_get_setting_802_1x (NMConnection *connection)
 NMSettingBluetooth *
 nm_connection_get_setting_bluetooth (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BLUETOOTH);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BLUETOOTH);
 }
 
 /**
@@ -2567,7 +2663,7 @@ nm_connection_get_setting_bluetooth (NMConnection *connection)
 NMSettingBond *
 nm_connection_get_setting_bond (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BOND);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BOND);
 }
 
 /**
@@ -2581,7 +2677,7 @@ nm_connection_get_setting_bond (NMConnection *connection)
 NMSettingTeam *
 nm_connection_get_setting_team (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TEAM);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TEAM);
 }
 
 /**
@@ -2595,7 +2691,7 @@ nm_connection_get_setting_team (NMConnection *connection)
 NMSettingTeamPort *
 nm_connection_get_setting_team_port (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TEAM_PORT);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TEAM_PORT);
 }
 
 /**
@@ -2609,7 +2705,7 @@ nm_connection_get_setting_team_port (NMConnection *connection)
 NMSettingBridge *
 nm_connection_get_setting_bridge (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BRIDGE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BRIDGE);
 }
 
 /**
@@ -2623,7 +2719,7 @@ nm_connection_get_setting_bridge (NMConnection *connection)
 NMSettingCdma *
 nm_connection_get_setting_cdma (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_CDMA);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_CDMA);
 }
 
 /**
@@ -2637,7 +2733,7 @@ nm_connection_get_setting_cdma (NMConnection *connection)
 NMSettingConnection *
 nm_connection_get_setting_connection (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_CONNECTION);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_CONNECTION);
 }
 
 /**
@@ -2651,7 +2747,7 @@ nm_connection_get_setting_connection (NMConnection *connection)
 NMSettingDcb *
 nm_connection_get_setting_dcb (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_DCB);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_DCB);
 }
 
 /**
@@ -2667,7 +2763,7 @@ nm_connection_get_setting_dcb (NMConnection *connection)
 NMSettingDummy *
 nm_connection_get_setting_dummy (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_DUMMY);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_DUMMY);
 }
 
 /**
@@ -2681,7 +2777,7 @@ nm_connection_get_setting_dummy (NMConnection *connection)
 NMSettingGeneric *
 nm_connection_get_setting_generic (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_GENERIC);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_GENERIC);
 }
 
 /**
@@ -2695,7 +2791,7 @@ nm_connection_get_setting_generic (NMConnection *connection)
 NMSettingGsm *
 nm_connection_get_setting_gsm (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_GSM);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_GSM);
 }
 
 /**
@@ -2709,7 +2805,7 @@ nm_connection_get_setting_gsm (NMConnection *connection)
 NMSettingInfiniband *
 nm_connection_get_setting_infiniband (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_INFINIBAND);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_INFINIBAND);
 }
 
 /**
@@ -2728,7 +2824,7 @@ nm_connection_get_setting_infiniband (NMConnection *connection)
 NMSettingIPConfig *
 nm_connection_get_setting_ip4_config (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_IP4_CONFIG);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_IP4_CONFIG);
 }
 
 /**
@@ -2744,7 +2840,7 @@ nm_connection_get_setting_ip4_config (NMConnection *connection)
 NMSettingIPTunnel *
 nm_connection_get_setting_ip_tunnel (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_IP_TUNNEL);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_IP_TUNNEL);
 }
 
 /**
@@ -2763,7 +2859,7 @@ nm_connection_get_setting_ip_tunnel (NMConnection *connection)
 NMSettingIPConfig *
 nm_connection_get_setting_ip6_config (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_IP6_CONFIG);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_IP6_CONFIG);
 }
 
 /**
@@ -2779,7 +2875,7 @@ nm_connection_get_setting_ip6_config (NMConnection *connection)
 NMSettingMacsec *
 nm_connection_get_setting_macsec (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_MACSEC);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_MACSEC);
 }
 
 /**
@@ -2795,7 +2891,7 @@ nm_connection_get_setting_macsec (NMConnection *connection)
 NMSettingMacvlan *
 nm_connection_get_setting_macvlan (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_MACVLAN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_MACVLAN);
 }
 
 /**
@@ -2809,7 +2905,7 @@ nm_connection_get_setting_macvlan (NMConnection *connection)
 NMSettingOlpcMesh *
 nm_connection_get_setting_olpc_mesh (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OLPC_MESH);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OLPC_MESH);
 }
 
 /**
@@ -2825,7 +2921,7 @@ nm_connection_get_setting_olpc_mesh (NMConnection *connection)
 NMSettingOvsBridge *
 nm_connection_get_setting_ovs_bridge (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_BRIDGE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_BRIDGE);
 }
 
 /**
@@ -2841,7 +2937,7 @@ nm_connection_get_setting_ovs_bridge (NMConnection *connection)
 NMSettingOvsInterface *
 nm_connection_get_setting_ovs_interface (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_INTERFACE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_INTERFACE);
 }
 
 /**
@@ -2857,7 +2953,7 @@ nm_connection_get_setting_ovs_interface (NMConnection *connection)
 NMSettingOvsPatch *
 nm_connection_get_setting_ovs_patch (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_PATCH);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_PATCH);
 }
 
 /**
@@ -2873,7 +2969,7 @@ nm_connection_get_setting_ovs_patch (NMConnection *connection)
 NMSettingOvsPort *
 nm_connection_get_setting_ovs_port (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_OVS_PORT);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_OVS_PORT);
 }
 
 /**
@@ -2887,7 +2983,7 @@ nm_connection_get_setting_ovs_port (NMConnection *connection)
 NMSettingPpp *
 nm_connection_get_setting_ppp (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_PPP);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_PPP);
 }
 
 /**
@@ -2901,7 +2997,7 @@ nm_connection_get_setting_ppp (NMConnection *connection)
 NMSettingPppoe *
 nm_connection_get_setting_pppoe (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_PPPOE);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_PPPOE);
 }
 
 /**
@@ -2917,7 +3013,7 @@ nm_connection_get_setting_pppoe (NMConnection *connection)
 NMSettingProxy *
 nm_connection_get_setting_proxy (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_PROXY);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_PROXY);
 }
 
 /**
@@ -2931,7 +3027,7 @@ nm_connection_get_setting_proxy (NMConnection *connection)
 NMSettingSerial *
 nm_connection_get_setting_serial (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_SERIAL);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_SERIAL);
 }
 
 /**
@@ -2947,7 +3043,7 @@ nm_connection_get_setting_serial (NMConnection *connection)
 NMSettingTCConfig *
 nm_connection_get_setting_tc_config (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TC_CONFIG);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TC_CONFIG);
 }
 
 /**
@@ -2963,7 +3059,7 @@ nm_connection_get_setting_tc_config (NMConnection *connection)
 NMSettingTun *
 nm_connection_get_setting_tun (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_TUN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_TUN);
 }
 
 /**
@@ -2977,7 +3073,7 @@ nm_connection_get_setting_tun (NMConnection *connection)
 NMSettingVpn *
 nm_connection_get_setting_vpn (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_VPN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_VPN);
 }
 
 /**
@@ -2993,7 +3089,7 @@ nm_connection_get_setting_vpn (NMConnection *connection)
 NMSettingVxlan *
 nm_connection_get_setting_vxlan (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_VXLAN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_VXLAN);
 }
 
 /**
@@ -3007,7 +3103,7 @@ nm_connection_get_setting_vxlan (NMConnection *connection)
 NMSettingWimax *
 nm_connection_get_setting_wimax (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIMAX);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIMAX);
 }
 
 /**
@@ -3021,7 +3117,7 @@ nm_connection_get_setting_wimax (NMConnection *connection)
 NMSettingWired *
 nm_connection_get_setting_wired (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIRED);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIRED);
 }
 
 /**
@@ -3035,7 +3131,7 @@ nm_connection_get_setting_wired (NMConnection *connection)
 NMSettingAdsl *
 nm_connection_get_setting_adsl (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_ADSL);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_ADSL);
 }
 
 /**
@@ -3049,7 +3145,7 @@ nm_connection_get_setting_adsl (NMConnection *connection)
 NMSettingWireless *
 nm_connection_get_setting_wireless (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIRELESS);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIRELESS);
 }
 
 /**
@@ -3063,7 +3159,7 @@ nm_connection_get_setting_wireless (NMConnection *connection)
 NMSettingWirelessSecurity *
 nm_connection_get_setting_wireless_security (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_WIRELESS_SECURITY);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_WIRELESS_SECURITY);
 }
 
 /**
@@ -3077,7 +3173,7 @@ nm_connection_get_setting_wireless_security (NMConnection *connection)
 NMSettingBridgePort *
 nm_connection_get_setting_bridge_port (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_BRIDGE_PORT);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_BRIDGE_PORT);
 }
 
 /**
@@ -3091,7 +3187,7 @@ nm_connection_get_setting_bridge_port (NMConnection *connection)
 NMSettingVlan *
 nm_connection_get_setting_vlan (NMConnection *connection)
 {
-	return _connection_get_setting_check (connection, NM_TYPE_SETTING_VLAN);
+	return _connection_get_setting_by_meta_type_check (connection, NM_META_SETTING_TYPE_VLAN);
 }
 
 NMSettingBluetooth *
@@ -3110,10 +3206,7 @@ _nm_connection_get_setting_bluetooth_for_nap (NMConnection *connection)
 static void
 nm_connection_private_free (NMConnectionPrivate *priv)
 {
-	NMConnection *self = priv->self;
-
-	g_hash_table_foreach_remove (priv->settings, _setting_release_hfr, self);
-	g_hash_table_destroy (priv->settings);
+	_settings_clear (priv);
 	g_free (priv->path);
 
 	g_slice_free (NMConnectionPrivate, priv);
@@ -3136,10 +3229,6 @@ nm_connection_get_private (NMConnection *connection)
 		                         priv, (GDestroyNotify) nm_connection_private_free);
 
 		priv->self = connection;
-		priv->settings = g_hash_table_new_full (nm_direct_hash,
-		                                        NULL,
-		                                        NULL,
-		                                        g_object_unref);
 	}
 
 	return priv;
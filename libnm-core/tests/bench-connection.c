@@ -0,0 +1,183 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2019 Red Hat, Inc.
+ */
+
+/* Benchmarks for the NMConnection operations that iterate over or look
+ * up settings.
+ *
+ * These are not run as part of "make check". The number of iterations
+ * can be tuned via the environment variable:
+ *
+ *   NMTST_BENCH_ITERATIONS  number of iterations per operation
+ *                           (default 20000).
+ */
+
+#include "nm-default.h"
+
+#include "nm-utils/nm-test-utils.h"
+
+/*****************************************************************************/
+
+static guint
+_bench_iterations (void)
+{
+	return _nm_utils_ascii_str_to_int64 (g_getenv ("NMTST_BENCH_ITERATIONS"), 10, 1, G_MAXUINT32, 20000);
+}
+
+static void
+_bench_report (const char *name, guint n, gint64 duration_usec)
+{
+	g_print ("bench: %s: %u iterations in %"G_GINT64_FORMAT" msec (%.0f nsec/op)\n",
+	         name,
+	         n,
+	         duration_usec / 1000,
+	         ((double) duration_usec) * 1000.0 / n);
+}
+
+static NMConnection *
+_create_connection (void)
+{
+	NMConnection *connection;
+	NMSettingIPConfig *s_ip4;
+	NMSettingIPConfig *s_ip6;
+	NMSettingMatch *s_match;
+	NMIPAddress *addr;
+
+	connection = nmtst_create_minimal_connection ("bench-connection", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+
+	s_ip4 = NM_SETTING_IP_CONFIG (nm_setting_ip4_config_new ());
+	g_object_set (s_ip4,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL,
+	              NULL);
+	addr = nm_ip_address_new (AF_INET, "192.168.1.5", 24, NULL);
+	nm_setting_ip_config_add_address (s_ip4, addr);
+	nm_ip_address_unref (addr);
+	nm_setting_ip_config_add_dns (s_ip4, "192.168.1.1");
+	nm_setting_ip_config_add_dns_search (s_ip4, "example.com");
+	nm_connection_add_setting (connection, NM_SETTING (s_ip4));
+
+	s_ip6 = NM_SETTING_IP_CONFIG (nm_setting_ip6_config_new ());
+	g_object_set (s_ip6,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP6_CONFIG_METHOD_AUTO,
+	              NULL);
+	nm_connection_add_setting (connection, NM_SETTING (s_ip6));
+
+	nm_connection_add_setting (connection, nm_setting_proxy_new ());
+	nm_connection_add_setting (connection, nm_setting_ethtool_new ());
+	nm_connection_add_setting (connection, nm_setting_dcb_new ());
+
+	s_match = NM_SETTING_MATCH (nm_setting_match_new ());
+	nm_setting_match_add_interface_name (s_match, "eth*");
+	nm_connection_add_setting (connection, NM_SETTING (s_match));
+
+	nmtst_connection_normalize (connection);
+	return connection;
+}
+
+/*****************************************************************************/
+
+static void
+test_bench_compare (void)
+{
+	gs_unref_object NMConnection *a = _create_connection ();
+	gs_unref_object NMConnection *b = nmtst_clone_connection (a);
+	guint n = _bench_iterations ();
+	gint64 t;
+	guint i;
+
+	t = g_get_monotonic_time ();
+	for (i = 0; i < n; i++)
+		g_assert (nm_connection_compare (a, b, NM_SETTING_COMPARE_FLAG_EXACT));
+	_bench_report ("compare", n, g_get_monotonic_time () - t);
+}
+
+static void
+test_bench_diff (void)
+{
+	gs_unref_object NMConnection *a = _create_connection ();
+	gs_unref_object NMConnection *b = nmtst_clone_connection (a);
+	guint n = _bench_iterations ();
+	gint64 t;
+	guint i;
+
+	g_object_set (nm_connection_get_setting_connection (b),
+	              NM_SETTING_CONNECTION_ID, "bench-connection-2",
+	              NULL);
+
+	t = g_get_monotonic_time ();
+	for (i = 0; i < n; i++) {
+		gs_unref_hashtable GHashTable *diffs = NULL;
+
+		g_assert (!nm_connection_diff (a, b, NM_SETTING_COMPARE_FLAG_EXACT, &diffs));
+		g_assert (diffs);
+	}
+	_bench_report ("diff", n, g_get_monotonic_time () - t);
+}
+
+static void
+test_bench_to_dbus (void)
+{
+	gs_unref_object NMConnection *connection = _create_connection ();
+	guint n = _bench_iterations ();
+	gint64 t;
+	guint i;
+
+	t = g_get_monotonic_time ();
+	for (i = 0; i < n; i++) {
+		gs_unref_variant GVariant *variant = NULL;
+
+		variant = nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL);
+		g_assert (variant);
+	}
+	_bench_report ("to-dbus", n, g_get_monotonic_time () - t);
+}
+
+static void
+test_bench_get_setting (void)
+{
+	gs_unref_object NMConnection *connection = _create_connection ();
+	guint n = _bench_iterations () * 100;
+	gint64 t;
+	guint i;
+
+	t = g_get_monotonic_time ();
+	for (i = 0; i < n; i++) {
+		g_assert (nm_connection_get_setting_connection (connection));
+		g_assert (nm_connection_get_setting_ip4_config (connection));
+		g_assert (!nm_connection_get_setting_wireless (connection));
+		g_assert (nm_connection_get_setting_by_name (connection, NM_SETTING_WIRED_SETTING_NAME));
+	}
+	_bench_report ("get-setting", n, g_get_monotonic_time () - t);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init (&argc, &argv, TRUE);
+
+	g_test_add_func ("/bench/connection/compare", test_bench_compare);
+	g_test_add_func ("/bench/connection/diff", test_bench_diff);
+	g_test_add_func ("/bench/connection/to-dbus", test_bench_to_dbus);
+	g_test_add_func ("/bench/connection/get-setting", test_bench_get_setting);
+
+	return g_test_run ();
+}
@@ -134,7 +134,37 @@ void nm_device_set_dhcp_anycast_address (NMDevice *device, const char *addr);
 gboolean nm_device_dhcp4_renew (NMDevice *device, gboolean release);
 gboolean nm_device_dhcp6_renew (NMDevice *device, gboolean release);
 
-void nm_device_recheck_available_connections (NMDevice *device);
+/**
+ * NMDeviceAvailableDeps:
+ * @NM_DEVICE_AVAILABLE_DEPS_NONE: no input changed.
+ * @NM_DEVICE_AVAILABLE_DEPS_CARRIER: the carrier of the device changed.
+ * @NM_DEVICE_AVAILABLE_DEPS_SCAN: the scan results of the device changed
+ *   (access points, peers, networks).
+ * @NM_DEVICE_AVAILABLE_DEPS_OTHER: anything else. Rechecking with this flag
+ *   re-evaluates all profiles.
+ * @NM_DEVICE_AVAILABLE_DEPS_ALL: all of the above.
+ *
+ * The inputs on which the availability of a profile on a device depends.
+ */
+typedef enum {
+	NM_DEVICE_AVAILABLE_DEPS_NONE                   = 0,
+	NM_DEVICE_AVAILABLE_DEPS_CARRIER                = (1LL << 0),
+	NM_DEVICE_AVAILABLE_DEPS_SCAN                   = (1LL << 1),
+	NM_DEVICE_AVAILABLE_DEPS_OTHER                  = (1LL << 2),
+
+	NM_DEVICE_AVAILABLE_DEPS_ALL                    = (  NM_DEVICE_AVAILABLE_DEPS_CARRIER
+	                                                   | NM_DEVICE_AVAILABLE_DEPS_SCAN
+	                                                   | NM_DEVICE_AVAILABLE_DEPS_OTHER),
+} NMDeviceAvailableDeps;
+
+void nm_device_recheck_available_connections_full (NMDevice *device,
+                                                   NMDeviceAvailableDeps deps_changed);
+
+static inline void
+nm_device_recheck_available_connections (NMDevice *device)
+{
+	nm_device_recheck_available_connections_full (device, NM_DEVICE_AVAILABLE_DEPS_ALL);
+}
 
 void nm_device_master_check_slave_physical_port (NMDevice *self, NMDevice *slave,
                                                  NMLogDomain log_domain);
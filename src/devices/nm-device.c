@@ -308,6 +308,13 @@ typedef struct _NMDevicePrivate {
 	char *        assume_state_connection_uuid;
 
 	GHashTable *  available_connections;
+
+	/* the profiles whose connection type the device supports, mapped to the
+	 * NMDeviceAvailableDeps their availability depends on. Only these
+	 * profiles can ever be compatible. Only valid if available_compat_valid
+	 * is set. */
+	GHashTable *  available_compat;
+	bool          available_compat_valid:1;
 	char *        hw_addr;
 	char *        hw_addr_perm;
 	char *        hw_addr_initial;
@@ -430,6 +437,12 @@ typedef struct _NMDevicePrivate {
 		NMIPConfig *ext_ip_config_x[2];
 	};
 
+	/* Whether ext_ip_config_x[] and the internal configurations are up to
+	 * date with all route events so far. In that case, device_ipx_changed()
+	 * applies route changes directly and the queued IP config change does
+	 * not need to capture the configuration from platform again. */
+	bool ext_ip_config_tracked_x[2];
+
 	/* VPNs which use this device */
 	union {
 		struct {
@@ -575,8 +588,8 @@ typedef struct _NMDevicePrivate {
 	guint check_delete_unrealized_id;
 
 	struct {
-		guint timeout_id;
 		guint refresh_rate_ms;
+		bool refresh_enabled;
 		guint64 tx_bytes;
 		guint64 rx_bytes;
 	} stats;
@@ -595,6 +608,7 @@ static const GDBusSignalInfo signal_info_state_changed;
 static void nm_device_set_proxy_config (NMDevice *self, const char *pac_url);
 
 static gboolean update_ext_ip_config (NMDevice *self, int addr_family, gboolean intersect_configs);
+static void _stats_refresh_update (NMDevice *self, gboolean enabled);
 
 static gboolean nm_device_set_ip_config (NMDevice *self,
                                          int addr_family,
@@ -1553,6 +1567,9 @@ _set_ip_ifindex (NMDevice *self,
 			nm_platform_link_set_up (platform, priv->ip_ifindex, NULL);
 	}
 
+	if (priv->stats.refresh_enabled)
+		_stats_refresh_update (self, TRUE);
+
 	/* We don't care about any saved values from the old iface */
 	g_hash_table_remove_all (priv->ip6_saved_properties);
 }
@@ -1815,22 +1832,6 @@ _stats_update_counters_from_pllink (NMDevice *self, const NMPlatformLink *pllink
 	_stats_update_counters (self, pllink->tx_bytes, pllink->rx_bytes);
 }
 
-static gboolean
-_stats_timeout_cb (gpointer user_data)
-{
-	NMDevice *self = user_data;
-	int ifindex;
-
-	ifindex = nm_device_get_ip_ifindex (self);
-
-	_LOGT (LOGD_DEVICE, "stats: refresh %d", ifindex);
-
-	if (ifindex > 0)
-		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
-
-	return G_SOURCE_CONTINUE;
-}
-
 static guint
 _stats_refresh_rate_real (guint refresh_rate_ms)
 {
@@ -1848,6 +1849,22 @@ _stats_refresh_rate_real (guint refresh_rate_ms)
 	return refresh_rate_ms;
 }
 
+static void
+_stats_refresh_update (NMDevice *self, gboolean enabled)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	/* the refresh timer is shared by all devices with the same rate, see
+	 * nm_platform_link_stats_refresh_set(). */
+	priv->stats.refresh_enabled = enabled;
+	nm_platform_link_stats_refresh_set (nm_device_get_platform (self),
+	                                    self,
+	                                    priv->ip_ifindex,
+	                                    enabled
+	                                      ? _stats_refresh_rate_real (priv->stats.refresh_rate_ms)
+	                                      : 0);
+}
+
 static void
 _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 {
@@ -1873,7 +1890,7 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (_stats_refresh_rate_real (old_rate) == refresh_rate_ms)
 		return;
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_refresh_update (self, TRUE);
 
 	if (!refresh_rate_ms)
 		return;
@@ -1884,8 +1901,6 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	ifindex = nm_device_get_ip_ifindex (self);
 	if (ifindex > 0)
 		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
-
-	priv->stats.timeout_id = g_timeout_add (refresh_rate_ms, _stats_timeout_cb, self);
 }
 
 /*****************************************************************************/
@@ -3468,7 +3483,7 @@ carrier_changed (NMDevice *self, gboolean carrier)
 	if (priv->state <= NM_DEVICE_STATE_UNMANAGED)
 		return;
 
-	nm_device_recheck_available_connections (self);
+	nm_device_recheck_available_connections_full (self, NM_DEVICE_AVAILABLE_DEPS_CARRIER);
 
 	/* ignore-carrier devices ignore all carrier-down events */
 	if (priv->ignore_carrier && !carrier)
@@ -4268,7 +4283,6 @@ realize_start_setup (NMDevice *self,
 	static guint32 id = 0;
 	NMDeviceCapabilities capabilities = 0;
 	NMConfig *config;
-	guint real_rate;
 
 	/* plink is a NMPlatformLink type, however, we require it to come from the platform
 	 * cache (where else would it come from?). */
@@ -4370,10 +4384,8 @@ realize_start_setup (NMDevice *self,
 
 	nm_device_set_carrier_from_platform (self);
 
-	nm_assert (!priv->stats.timeout_id);
-	real_rate = _stats_refresh_rate_real (priv->stats.refresh_rate_ms);
-	if (real_rate)
-		priv->stats.timeout_id = g_timeout_add (real_rate, _stats_timeout_cb, self);
+	nm_assert (!priv->stats.refresh_enabled);
+	_stats_refresh_update (self, TRUE);
 
 	klass->realize_start_notify (self, plink);
 
@@ -4560,9 +4572,11 @@ nm_device_unrealize (NMDevice *self, gboolean remove_resources, GError **error)
 		_notify (self, PROP_PHYSICAL_PORT_ID);
 	}
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_refresh_update (self, FALSE);
 	_stats_update_counters (self, 0, 0);
 
+	priv->available_compat_valid = FALSE;
+
 	priv->hw_addr_len_ = 0;
 	if (nm_clear_g_free (&priv->hw_addr))
 		_notify (self, PROP_HW_ADDRESS);
@@ -5784,6 +5798,22 @@ nm_device_check_connection_compatible (NMDevice *self, NMConnection *connection,
 	return NM_DEVICE_GET_CLASS (self)->check_connection_compatible (self, connection, error);
 }
 
+/**
+ * nm_device_get_connection_type_check_compatible:
+ * @self: an #NMDevice
+ *
+ * Returns: the connection.type that a profile must have so that
+ *   nm_device_check_connection_compatible() can accept it, or %NULL
+ *   if the device accepts more than one connection type.
+ */
+const char *
+nm_device_get_connection_type_check_compatible (NMDevice *self)
+{
+	g_return_val_if_fail (NM_IS_DEVICE (self), NULL);
+
+	return NM_DEVICE_GET_CLASS (self)->connection_type_check_compatible;
+}
+
 gboolean
 nm_device_check_slave_connection_compatible (NMDevice *self, NMConnection *slave)
 {
@@ -7263,6 +7293,10 @@ ip_config_merge_and_apply (NMDevice *self,
 		if (priv->queued_ip_config_id_x[IS_IPv4])
 			update_ext_ip_config (self, addr_family, FALSE);
 		ensure_con_ip_config (self, addr_family);
+
+		/* the internal configurations might have changed. The next queued
+		 * change subtracts them again from the captured configuration. */
+		priv->ext_ip_config_tracked_x[IS_IPv4] = FALSE;
 	}
 
 	if (!IS_IPv4) {
@@ -10983,6 +11017,7 @@ nm_device_reactivate_ip4_config (NMDevice *self,
 	if (priv->ip_state_4 != NM_DEVICE_IP_STATE_NONE) {
 		g_clear_object (&priv->con_ip_config_4);
 		g_clear_object (&priv->ext_ip_config_4);
+		priv->ext_ip_config_tracked_x[1] = FALSE;
 		g_clear_object (&priv->dev_ip_config_4.current);
 		g_clear_object (&priv->dev2_ip_config_4.current);
 		priv->con_ip_config_4 = nm_device_ip4_config_new (self);
@@ -11055,6 +11090,7 @@ nm_device_reactivate_ip6_config (NMDevice *self,
 	if (priv->ip_state_6 != NM_DEVICE_IP_STATE_NONE) {
 		g_clear_object (&priv->con_ip_config_6);
 		g_clear_object (&priv->ext_ip_config_6);
+		priv->ext_ip_config_tracked_x[0] = FALSE;
 		g_clear_object (&priv->ac_ip6_config.current);
 		g_clear_object (&priv->dhcp6.ip6_config.current);
 		g_clear_object (&priv->dev2_ip_config_6.current);
@@ -12830,16 +12866,130 @@ intersect_ext_config (NMDevice *self,
 	}
 }
 
+static guint
+ext_ip_config_get_applied_configs (NMDevice *self,
+                                   int addr_family,
+                                   AppliedConfig *configs[static 3])
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	if (addr_family == AF_INET) {
+		configs[0] = &priv->dev_ip_config_4;
+		configs[1] = &priv->dev2_ip_config_4;
+		return 2;
+	}
+
+	configs[0] = &priv->ac_ip6_config;
+	configs[1] = &priv->dhcp6.ip6_config;
+	configs[2] = &priv->dev2_ip_config_6;
+	return 3;
+}
+
+/* Apply a route change from platform to ext_ip_config_x[], in the same way
+ * as update_ext_ip_config() would when capturing the configuration again.
+ * Returns %FALSE if the change cannot be applied and the configuration must
+ * be captured again. */
+static gboolean
+ext_ip_config_track_route (NMDevice *self,
+                           int addr_family,
+                           const NMPObject *obj,
+                           NMPlatformSignalChangeType change_type)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+	NMPlatform *platform = nm_device_get_platform (self);
+	const NMPlatformIPRoute *route = NMP_OBJECT_CAST_IP_ROUTE (obj);
+	NMIPConfig *ext = priv->ext_ip_config_x[IS_IPv4];
+	AppliedConfig *applied[3];
+	guint n_applied;
+	GSList *iter;
+	guint i;
+
+	if (   !ext
+	    || (!IS_IPv4 && !priv->ext_ip6_config_captured)
+	    || nm_ip_config_get_ifindex (ext) != route->ifindex
+	    || nm_platform_link_get_master (platform, route->ifindex) > 0)
+		return FALSE;
+
+	/* default routes are compared with the metric penalty of the device.
+	 * There are few of them, capture again. */
+	if (NM_PLATFORM_IP_ROUTE_IS_DEFAULT (route))
+		return FALSE;
+
+	n_applied = ext_ip_config_get_applied_configs (self, addr_family, applied);
+
+	if (change_type == NM_PLATFORM_SIGNAL_REMOVED) {
+		/* intersecting a config without current would allocate it. Leave
+		 * that to update_ext_ip_config(). */
+		for (i = 0; i < n_applied; i++) {
+			if (   applied[i]->orig
+			    && !applied[i]->current
+			    && nm_ip_config_nmpobj_lookup (applied[i]->orig, obj))
+				return FALSE;
+		}
+
+		nm_ip_config_nmpobj_remove (ext, obj);
+		if (!IS_IPv4)
+			nm_ip6_config_nmpobj_remove (priv->ext_ip6_config_captured, obj);
+
+		/* the route was removed externally. Like with intersecting, also
+		 * drop it from the internal configurations, so that it is not added
+		 * back. Routes are only intersected while the link is up. */
+		if (!nm_platform_link_is_up (platform, route->ifindex))
+			return TRUE;
+
+		if (priv->con_ip_config_x[IS_IPv4])
+			nm_ip_config_nmpobj_remove (priv->con_ip_config_x[IS_IPv4], obj);
+		for (i = 0; i < n_applied; i++) {
+			if (applied[i]->current)
+				nm_ip_config_nmpobj_remove (applied[i]->current, obj);
+		}
+		for (iter = priv->vpn_configs_x[IS_IPv4]; iter; iter = iter->next)
+			nm_ip_config_nmpobj_remove (iter->data, obj);
+		return TRUE;
+	}
+
+	/* like nm_ip4_config_capture(), only consider routes that platform
+	 * tracks for the interface. */
+	if (!nm_platform_lookup_entry (platform, NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX, obj))
+		return TRUE;
+
+	if (!IS_IPv4)
+		nm_ip6_config_add_route (priv->ext_ip6_config_captured, NMP_OBJECT_CAST_IP6_ROUTE (obj), NULL);
+
+	/* like subtracting, the route is not external if we configured it. */
+	if (   priv->con_ip_config_x[IS_IPv4]
+	    && nm_ip_config_nmpobj_lookup (priv->con_ip_config_x[IS_IPv4], obj))
+		return TRUE;
+	for (i = 0; i < n_applied; i++) {
+		if (   applied_config_get_current (applied[i])
+		    && nm_ip_config_nmpobj_lookup (applied_config_get_current (applied[i]), obj))
+			return TRUE;
+	}
+	for (iter = priv->vpn_configs_x[IS_IPv4]; iter; iter = iter->next) {
+		if (nm_ip_config_nmpobj_lookup (iter->data, obj))
+			return TRUE;
+	}
+
+	nm_ip_config_add_route (ext, route, NULL);
+	return TRUE;
+}
+
 static gboolean
 update_ext_ip_config (NMDevice *self, int addr_family, gboolean intersect_configs)
 {
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
 	int ifindex;
 	GSList *iter;
 	gboolean is_up;
 
 	nm_assert_addr_family (addr_family);
 
+	/* without intersecting, the internal configurations may still contain
+	 * routes that are gone from platform. */
+	priv->ext_ip_config_tracked_x[IS_IPv4] = FALSE;
+
 	ifindex = nm_device_get_ip_ifindex (self);
 	if (!ifindex)
 		return FALSE;
@@ -12957,6 +13107,8 @@ update_ext_ip_config (NMDevice *self, int addr_family, gboolean intersect_config
 		}
 	}
 
+	priv->ext_ip_config_tracked_x[IS_IPv4] =    intersect_configs
+	                                          && priv->ext_ip_config_x[IS_IPv4];
 	return TRUE;
 }
 
@@ -12972,6 +13124,13 @@ update_ip_config (NMDevice *self, int addr_family)
 	else
 		priv->update_ip_config_completed_v6 = TRUE;
 
+	if (   priv->ext_ip_config_tracked_x[addr_family == AF_INET]
+	    && priv->ext_ip_config_x[addr_family == AF_INET]) {
+		/* device_ipx_changed() already applied the route changes. */
+		ip_config_merge_and_apply (self, addr_family, FALSE);
+		return;
+	}
+
 	if (update_ext_ip_config (self, addr_family, TRUE)) {
 		if (addr_family == AF_INET) {
 			if (priv->ext_ip_config_4)
@@ -13127,19 +13286,39 @@ device_ipx_changed (NMPlatform *platform,
 	const NMPlatformSignalChangeType change_type = change_type_i;
 	NMDevicePrivate *priv;
 	const NMPlatformIP6Address *addr;
+	gboolean IS_IPv4;
 
 	if (nm_device_get_ip_ifindex (self) != ifindex)
 		return;
 
-	if (!nm_device_is_real (self))
-		return;
+	priv = NM_DEVICE_GET_PRIVATE (self);
 
-	if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
-		/* ignore all platform signals until the link is initialized in platform. */
+	if (   !nm_device_is_real (self)
+	    || nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
+		/* ignore all platform signals until the link is initialized in platform.
+		 * The change is lost for the tracked configuration. */
+		priv->ext_ip_config_tracked_x[0] = FALSE;
+		priv->ext_ip_config_tracked_x[1] = FALSE;
 		return;
 	}
 
-	priv = NM_DEVICE_GET_PRIVATE (self);
+	switch (obj_type) {
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		IS_IPv4 = (obj_type == NMP_OBJECT_TYPE_IP4_ROUTE);
+		if (   priv->ext_ip_config_tracked_x[IS_IPv4]
+		    && !ext_ip_config_track_route (self,
+		                                   IS_IPv4 ? AF_INET : AF_INET6,
+		                                   NMP_OBJECT_UP_CAST (platform_object),
+		                                   change_type))
+			priv->ext_ip_config_tracked_x[IS_IPv4] = FALSE;
+		break;
+	default:
+		/* captured addresses are sorted by their role, which depends on the
+		 * other addresses. Capture them again. */
+		priv->ext_ip_config_tracked_x[obj_type == NMP_OBJECT_TYPE_IP4_ADDRESS] = FALSE;
+		break;
+	}
 
 	switch (obj_type) {
 	case NMP_OBJECT_TYPE_IP4_ADDRESS:
@@ -14034,14 +14213,93 @@ check_connection_available (NMDevice *self,
 	return FALSE;
 }
 
+static NMDeviceAvailableDeps
+available_compat_get_deps (NMDevice *self, NMConnection *connection)
+{
+	NMDeviceAvailableDeps deps = NM_DEVICE_AVAILABLE_DEPS_OTHER;
+
+	/* see check_connection_available(). */
+	if (connection_requires_carrier (connection))
+		deps |= NM_DEVICE_AVAILABLE_DEPS_CARRIER;
+
+	/* subclasses may look at anything, like scan results or the carrier. */
+	if (NM_DEVICE_GET_CLASS (self)->check_connection_available != check_connection_available)
+		deps |= NM_DEVICE_AVAILABLE_DEPS_CARRIER | NM_DEVICE_AVAILABLE_DEPS_SCAN;
+
+	return deps;
+}
+
+/* whether the device class supports the connection type of @connection.
+ * Contrary to nm_device_check_connection_compatible(), that does not depend
+ * on the state of the device or on other devices (like the parent of a VLAN),
+ * so the result can be cached until the profile changes. */
+static gboolean
+available_compat_check_type (NMDevice *self, NMConnection *connection)
+{
+	NMDeviceClass *klass = NM_DEVICE_GET_CLASS (self);
+
+	if (!klass->connection_type_check_compatible) {
+		/* the class checks the type itself, in check_connection_compatible(). */
+		return TRUE;
+	}
+
+	return !!_nm_connection_check_main_setting (connection,
+	                                            klass->connection_type_check_compatible,
+	                                            NULL);
+}
+
+static void
+available_compat_update (NMDevice *self, NMSettingsConnection *sett_conn)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	NMConnection *connection;
+
+	if (!priv->available_compat_valid)
+		return;
+
+	connection = nm_settings_connection_get_connection (sett_conn);
+	if (available_compat_check_type (self, connection)) {
+		g_hash_table_insert (priv->available_compat,
+		                     sett_conn,
+		                     GUINT_TO_POINTER (available_compat_get_deps (self, connection)));
+	} else
+		g_hash_table_remove (priv->available_compat, sett_conn);
+}
+
+static gboolean
+available_connections_recheck_one (NMDevice *self, NMSettingsConnection *sett_conn)
+{
+	if (nm_device_check_connection_available (self,
+	                                          nm_settings_connection_get_connection (sett_conn),
+	                                          NM_DEVICE_CHECK_CON_AVAILABLE_NONE,
+	                                          NULL,
+	                                          NULL))
+		return available_connections_add (self, sett_conn);
+	return available_connections_del (self, sett_conn);
+}
+
+/**
+ * nm_device_recheck_available_connections_full:
+ * @self: the #NMDevice
+ * @deps_changed: the inputs that changed.
+ *
+ * Re-evaluates the available connections of the device. When only the
+ * carrier or the scan results changed, only the profiles of a connection
+ * type that the device supports are looked at. Their compatibility is always
+ * checked again, as it depends on other devices too. Their availability
+ * is only checked again if it depends on @deps_changed, or if the profile
+ * is not available so far. Otherwise, all profiles are checked.
+ */
 void
-nm_device_recheck_available_connections (NMDevice *self)
+nm_device_recheck_available_connections_full (NMDevice *self,
+                                              NMDeviceAvailableDeps deps_changed)
 {
 	NMDevicePrivate *priv;
 	NMSettingsConnection *const*connections;
 	gboolean changed = FALSE;
 	GHashTableIter h_iter;
 	NMSettingsConnection *sett_conn;
+	gpointer p_deps;
 	guint i;
 	gs_unref_hashtable GHashTable *prune_list = NULL;
 
@@ -14049,6 +14307,34 @@ nm_device_recheck_available_connections (NMDevice *self)
 
 	priv = NM_DEVICE_GET_PRIVATE(self);
 
+	/* In state DISCONNECTED and higher, _nm_device_check_connection_available()
+	 * no longer checks whether the device itself is available. Only then
+	 * we know that the availability of profiles that don't depend on
+	 * @deps_changed stays the same. */
+	if (   !NM_FLAGS_HAS (deps_changed, NM_DEVICE_AVAILABLE_DEPS_OTHER)
+	    && priv->available_compat_valid
+	    && priv->state >= NM_DEVICE_STATE_DISCONNECTED
+	    && nm_device_is_real (self)) {
+		g_hash_table_iter_init (&h_iter, priv->available_compat);
+		while (g_hash_table_iter_next (&h_iter, (gpointer *) &sett_conn, &p_deps)) {
+			if (!nm_device_check_connection_compatible (self,
+			                                            nm_settings_connection_get_connection (sett_conn),
+			                                            NULL)) {
+				if (available_connections_del (self, sett_conn))
+					changed = TRUE;
+				continue;
+			}
+			if (   !NM_FLAGS_ANY (GPOINTER_TO_UINT (p_deps), deps_changed)
+			    && g_hash_table_contains (priv->available_connections, sett_conn)) {
+				/* still compatible, and none of the inputs it depends on changed. */
+				continue;
+			}
+			if (available_connections_recheck_one (self, sett_conn))
+				changed = TRUE;
+		}
+		goto out;
+	}
+
 	if (g_hash_table_size (priv->available_connections) > 0) {
 		prune_list = g_hash_table_new (nm_direct_hash, NULL);
 		g_hash_table_iter_init (&h_iter, priv->available_connections);
@@ -14056,12 +14342,28 @@ nm_device_recheck_available_connections (NMDevice *self)
 			g_hash_table_add (prune_list, sett_conn);
 	}
 
+	if (!priv->available_compat)
+		priv->available_compat = g_hash_table_new (nm_direct_hash, NULL);
+	else
+		g_hash_table_remove_all (priv->available_compat);
+
 	connections = nm_settings_get_connections (priv->settings, NULL);
 	for (i = 0; connections[i]; i++) {
+		NMConnection *connection;
+
 		sett_conn = connections[i];
+		connection = nm_settings_connection_get_connection (sett_conn);
+
+		/* a profile can only be available, if the device supports its type.
+		 * Remember those, so that next time we only need to look at them. */
+		if (!available_compat_check_type (self, connection))
+			continue;
+		g_hash_table_insert (priv->available_compat,
+		                     sett_conn,
+		                     GUINT_TO_POINTER (available_compat_get_deps (self, connection)));
 
 		if (nm_device_check_connection_available (self,
-		                                          nm_settings_connection_get_connection (sett_conn),
+		                                          connection,
 		                                          NM_DEVICE_CHECK_CON_AVAILABLE_NONE,
 		                                          NULL,
 		                                          NULL)) {
@@ -14071,6 +14373,7 @@ nm_device_recheck_available_connections (NMDevice *self)
 				g_hash_table_remove (prune_list, sett_conn);
 		}
 	}
+	priv->available_compat_valid = nm_device_is_real (self);
 
 	if (prune_list) {
 		g_hash_table_iter_init (&h_iter, prune_list);
@@ -14080,6 +14383,7 @@ nm_device_recheck_available_connections (NMDevice *self)
 		}
 	}
 
+out:
 	if (changed)
 		_notify (self, PROP_AVAILABLE_CONNECTIONS);
 	available_connections_check_delete_unrealized (self);
@@ -14146,6 +14450,8 @@ cp_connection_added_or_updated (NMDevice *self, NMSettingsConnection *sett_conn)
 	g_return_if_fail (NM_IS_DEVICE (self));
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (sett_conn));
 
+	available_compat_update (self, sett_conn);
+
 	if (nm_device_check_connection_available (self,
 	                                          nm_settings_connection_get_connection (sett_conn),
 	                                          _NM_DEVICE_CHECK_CON_AVAILABLE_FOR_USER_REQUEST,
@@ -14180,6 +14486,9 @@ cp_connection_removed (NMSettings *settings, NMSettingsConnection *sett_conn, gp
 
 	g_return_if_fail (NM_IS_DEVICE (self));
 
+	if (self->_priv->available_compat)
+		g_hash_table_remove (self->_priv->available_compat, sett_conn);
+
 	if (available_connections_del (self, sett_conn)) {
 		_notify (self, PROP_AVAILABLE_CONNECTIONS);
 		available_connections_check_delete_unrealized (self);
@@ -14401,6 +14710,8 @@ _cleanup_generic_post (NMDevice *self, CleanupType cleanup_type)
 	applied_config_clear (&priv->ac_ip6_config);
 	g_clear_object (&priv->ext_ip_config_6);
 	g_clear_object (&priv->ext_ip6_config_captured);
+	priv->ext_ip_config_tracked_x[0] = FALSE;
+	priv->ext_ip_config_tracked_x[1] = FALSE;
 	applied_config_clear (&priv->dev2_ip_config_6);
 	g_clear_object (&priv->ip_config_6);
 	g_clear_object (&priv->dad6_ip6_config);
@@ -15363,6 +15674,9 @@ nm_device_update_hw_address (NMDevice *self)
 	_LOGD (LOGD_PLATFORM | LOGD_DEVICE, "hw-addr: hardware address now %s", priv->hw_addr);
 	_notify (self, PROP_HW_ADDRESS);
 
+	/* profiles may be locked to a MAC address. */
+	priv->available_compat_valid = FALSE;
+
 	if (   !priv->hw_addr_initial
 	    || (   priv->hw_addr_type == HW_ADDR_TYPE_UNSET
 	        && priv->state < NM_DEVICE_STATE_PREPARE
@@ -15487,6 +15801,7 @@ nm_device_update_permanent_hw_address (NMDevice *self, gboolean force_freeze)
 	priv->hw_addr_perm = g_strdup (priv->hw_addr);
 
 notify_and_out:
+	priv->available_compat_valid = FALSE;
 	_notify (self, PROP_PERM_HW_ADDRESS);
 }
 
@@ -16034,29 +16349,58 @@ nm_device_spec_match_list (NMDevice *self, const GSList *specs)
 	return nm_device_spec_match_list_full (self, specs, FALSE);
 }
 
-int
-nm_device_spec_match_list_full (NMDevice *self, const GSList *specs, int no_match_value)
+/**
+ * nm_device_get_match_spec_data:
+ * @self: the #NMDevice
+ * @out_data: (out): the properties of @self that device match specs
+ *   can refer to.
+ *
+ * The strings are owned by @self and only valid until the device changes.
+ */
+void
+nm_device_get_match_spec_data (NMDevice *self, NMMatchSpecDeviceData *out_data)
 {
 	NMDeviceClass *klass;
-	NMMatchSpecMatchType m;
-	const char *hw_address = NULL;
+	const char *hw_address;
 	gboolean is_fake;
 
-	g_return_val_if_fail (NM_IS_DEVICE (self), FALSE);
+	g_return_if_fail (NM_IS_DEVICE (self));
+	nm_assert (out_data);
 
 	klass = NM_DEVICE_GET_CLASS (self);
 	hw_address = nm_device_get_permanent_hw_address_full (self,
 	                                                      !nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT),
 	                                                      &is_fake);
 
+	*out_data = (NMMatchSpecDeviceData) {
+		.interface_name   = nm_device_get_iface (self),
+		.device_type      = nm_device_get_type_description (self),
+		.driver           = nm_device_get_driver (self),
+		.driver_version   = nm_device_get_driver_version (self),
+		.hwaddr           = is_fake ? NULL : hw_address,
+		.s390_subchannels = klass->get_s390_subchannels ? klass->get_s390_subchannels (self) : NULL,
+		.dhcp_plugin      = nm_dhcp_manager_get_config (nm_dhcp_manager_get ()),
+	};
+}
+
+int
+nm_device_spec_match_list_full (NMDevice *self, const GSList *specs, int no_match_value)
+{
+	NMMatchSpecDeviceData data;
+	NMMatchSpecMatchType m;
+
+	g_return_val_if_fail (NM_IS_DEVICE (self), FALSE);
+
+	nm_device_get_match_spec_data (self, &data);
+
 	m = nm_match_spec_device (specs,
-	                          nm_device_get_iface (self),
-	                          nm_device_get_type_description (self),
-	                          nm_device_get_driver (self),
-	                          nm_device_get_driver_version (self),
-	                          is_fake ? NULL : hw_address,
-	                          klass->get_s390_subchannels ? klass->get_s390_subchannels (self) : NULL,
-	                          nm_dhcp_manager_get_config (nm_dhcp_manager_get ()));
+	                          data.interface_name,
+	                          data.device_type,
+	                          data.driver,
+	                          data.driver_version,
+	                          data.hwaddr,
+	                          data.s390_subchannels,
+	                          data.dhcp_plugin);
 
 	switch (m) {
 	case NM_MATCH_SPEC_MATCH:
@@ -16349,7 +16693,7 @@ dispose (GObject *object)
 
 	nm_clear_g_source (&priv->check_delete_unrealized_id);
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_refresh_update (self, FALSE);
 
 	carrier_disconnected_action_cancel (self);
 
@@ -16422,6 +16766,7 @@ finalize (GObject *object)
 
 	g_hash_table_unref (priv->ip6_saved_properties);
 	g_hash_table_unref (priv->available_connections);
+	nm_clear_pointer (&priv->available_compat, g_hash_table_unref);
 
 	nm_dbus_track_obj_path_deinit (&priv->parent_device);
 	nm_dbus_track_obj_path_deinit (&priv->act_request);
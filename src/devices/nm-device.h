@@ -584,12 +584,15 @@ gboolean nm_device_check_connection_compatible (NMDevice *device,
                                                 NMConnection *connection,
                                                 GError **error);
 
+const char *nm_device_get_connection_type_check_compatible (NMDevice *self);
+
 gboolean nm_device_check_slave_connection_compatible (NMDevice *device, NMConnection *connection);
 
 gboolean nm_device_unmanage_on_quit (NMDevice *self);
 
 gboolean nm_device_spec_match_list (NMDevice *device, const GSList *specs);
 int      nm_device_spec_match_list_full (NMDevice *self, const GSList *specs, int no_match_value);
+void     nm_device_get_match_spec_data (NMDevice *self, NMMatchSpecDeviceData *out_data);
 
 gboolean nm_device_is_activating (NMDevice *dev);
 gboolean nm_device_autoconnect_allowed (NMDevice *self);
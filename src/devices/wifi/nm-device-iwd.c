@@ -156,7 +156,7 @@ ap_add_remove (NMDeviceIwd *self,
 
 	nm_device_emit_recheck_auto_activate (NM_DEVICE (self));
 	if (recheck_available_connections)
-		nm_device_recheck_available_connections (NM_DEVICE (self));
+		nm_device_recheck_available_connections_full (NM_DEVICE (self), NM_DEVICE_AVAILABLE_DEPS_SCAN);
 }
 
 static void
@@ -203,7 +203,7 @@ remove_all_aps (NMDeviceIwd *self)
 		ap_add_remove (self, FALSE, ap, FALSE);
 
 	nm_device_emit_recheck_auto_activate (NM_DEVICE (self));
-	nm_device_recheck_available_connections (NM_DEVICE (self));
+	nm_device_recheck_available_connections_full (NM_DEVICE (self), NM_DEVICE_AVAILABLE_DEPS_SCAN);
 }
 
 static GVariant *
@@ -400,7 +400,7 @@ get_ordered_networks_cb (GObject *source, GAsyncResult *res, gpointer user_data)
 
 	if (changed) {
 		nm_device_emit_recheck_auto_activate (NM_DEVICE (self));
-		nm_device_recheck_available_connections (NM_DEVICE (self));
+		nm_device_recheck_available_connections_full (NM_DEVICE (self), NM_DEVICE_AVAILABLE_DEPS_SCAN);
 	}
 }
 
@@ -581,7 +581,7 @@ remove_all_peers (NMDeviceWifiP2P *self)
 	while ((peer = c_list_first_entry (&priv->peers_lst_head, NMWifiP2PPeer, peers_lst)))
 		peer_add_remove (self, FALSE, peer, FALSE);
 
-	nm_device_recheck_available_connections (NM_DEVICE (self));
+	nm_device_recheck_available_connections_full (NM_DEVICE (self), NM_DEVICE_AVAILABLE_DEPS_SCAN);
 }
 
 /*****************************************************************************/
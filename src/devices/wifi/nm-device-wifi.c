@@ -508,7 +508,7 @@ ap_add_remove (NMDeviceWifi *self,
 
 	nm_device_emit_recheck_auto_activate (NM_DEVICE (self));
 	if (recheck_available_connections)
-		nm_device_recheck_available_connections (NM_DEVICE (self));
+		nm_device_recheck_available_connections_full (NM_DEVICE (self), NM_DEVICE_AVAILABLE_DEPS_SCAN);
 }
 
 static void
@@ -525,7 +525,7 @@ remove_all_aps (NMDeviceWifi *self)
 	while ((ap = c_list_first_entry (&priv->aps_lst_head, NMWifiAP, aps_lst)))
 		ap_add_remove (self, FALSE, ap, FALSE);
 
-	nm_device_recheck_available_connections (NM_DEVICE (self));
+	nm_device_recheck_available_connections_full (NM_DEVICE (self), NM_DEVICE_AVAILABLE_DEPS_SCAN);
 }
 
 static gboolean
@@ -1303,10 +1303,12 @@ build_hidden_probe_list (NMDeviceWifi *self)
 	if (max_scan_ssids < 2)
 		return NULL;
 
-	connections = nm_settings_get_connections_clone (nm_device_get_settings ((NMDevice *) self),
-	                                                 &len,
-	                                                 hidden_filter_func, NULL,
-	                                                 NULL, NULL);
+	connections = nm_settings_get_connections_clone_full (nm_device_get_settings ((NMDevice *) self),
+	                                                      &len,
+	                                                      NM_SETTING_WIRELESS_SETTING_NAME,
+	                                                      NULL,
+	                                                      hidden_filter_func, NULL,
+	                                                      NULL, NULL);
 	if (!connections[0])
 		return NULL;
 
@@ -769,7 +769,7 @@ nm_dhcp_client_handle_event (gpointer unused,
 			g_variant_unref (value);
 		}
 
-		if (nm_logging_enabled (LOGL_DEBUG, LOGD_DHCP6)) {
+		if (nm_logging_output_enabled (LOGL_DEBUG, LOGD_DHCP6)) {
 			GHashTableIter hash_iter;
 			gpointer key, val;
 
@@ -172,9 +172,9 @@ NM_DEFINE_SINGLETON_GETTER (NMDnsManager, nm_dns_manager_get, NM_TYPE_DNS_MANAGE
 
 /*****************************************************************************/
 
-static void _ip_config_dns_priority_changed (gpointer config,
-                                             GParamSpec *pspec,
-                                             NMDnsIPConfigData *ip_data);
+static void _ip_config_notify (gpointer config,
+                               GParamSpec *pspec,
+                               NMDnsIPConfigData *ip_data);
 
 /*****************************************************************************/
 
@@ -256,10 +256,8 @@ _ip_config_data_new (NMDnsConfigData *data,
 	c_list_link_tail (&NM_DNS_MANAGER_GET_PRIVATE (data->self)->ip_config_lst_head, &ip_data->ip_config_lst);
 
 	g_signal_connect (ip_config,
-	                  NM_IS_IP4_CONFIG (ip_config)
-	                    ? "notify::" NM_IP4_CONFIG_DNS_PRIORITY
-	                    : "notify::" NM_IP6_CONFIG_DNS_PRIORITY,
-	                  (GCallback) _ip_config_dns_priority_changed, ip_data);
+	                  "notify",
+	                  (GCallback) _ip_config_notify, ip_data);
 
 	_ASSERT_ip_config_data (ip_data);
 	return ip_data;
@@ -277,7 +275,7 @@ _ip_config_data_free (NMDnsIPConfigData *ip_data)
 	g_strfreev (ip_data->domains.reverse);
 
 	g_signal_handlers_disconnect_by_func (ip_data->ip_config,
-	                                      _ip_config_dns_priority_changed,
+	                                      _ip_config_notify,
 	                                      ip_data);
 
 	g_object_unref (ip_data->ip_config);
@@ -1012,6 +1010,42 @@ update_resolv_conf (NMDnsManager *self,
 	return SR_SUCCESS;
 }
 
+/* The SHA1 digest of no data, that is of an IP configuration without
+ * DNS parameters. */
+static const guint8 _hash_empty[HASH_LEN] = {
+	0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55,
+	0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09,
+};
+
+static void
+_ip_config_data_update_hash (NMDnsIPConfigData *ip_data)
+{
+	nm_auto_free_checksum GChecksum *sum = NULL;
+	int mdns = NM_SETTING_CONNECTION_MDNS_DEFAULT;
+	int llmnr = NM_SETTING_CONNECTION_LLMNR_DEFAULT;
+
+	/* mDNS and LLMNR are part of the hash, but changing them emits no
+	 * property notification. Compare them explicitly. */
+	if (NM_IS_IP4_CONFIG (ip_data->ip_config)) {
+		mdns = nm_ip4_config_mdns_get (NM_IP4_CONFIG (ip_data->ip_config));
+		llmnr = nm_ip4_config_llmnr_get (NM_IP4_CONFIG (ip_data->ip_config));
+	}
+
+	if (   ip_data->hash.valid
+	    && ip_data->hash.mdns == mdns
+	    && ip_data->hash.llmnr == llmnr)
+		return;
+
+	sum = g_checksum_new (G_CHECKSUM_SHA1);
+	nm_ip_config_hash (ip_data->ip_config, sum, TRUE);
+	nm_utils_checksum_get_digest_len (sum, ip_data->hash.digest, HASH_LEN);
+
+	ip_data->hash.mdns = mdns;
+	ip_data->hash.llmnr = llmnr;
+	ip_data->hash.empty = (memcmp (ip_data->hash.digest, _hash_empty, HASH_LEN) == 0);
+	ip_data->hash.valid = TRUE;
+}
+
 static void
 compute_hash (NMDnsManager *self, const NMGlobalDnsConfig *global, guint8 buffer[HASH_LEN])
 {
@@ -1026,11 +1060,15 @@ compute_hash (NMDnsManager *self, const NMGlobalDnsConfig *global, guint8 buffer
 	else {
 		const CList *head;
 
-		/* FIXME(ip-config-checksum): this relies on the fact that an IP
-		 * configuration without DNS parameters gives a zero checksum. */
+		/* The digest of each IP configuration is cached until the configuration
+		 * changes. Configurations without DNS parameters are skipped, so that
+		 * adding an empty configuration doesn't change the hash. */
 		head = _ip_config_lst_head (self);
-		c_list_for_each_entry (ip_data, head, ip_config_lst)
-			nm_ip_config_hash (ip_data->ip_config, sum, TRUE);
+		c_list_for_each_entry (ip_data, head, ip_config_lst) {
+			_ip_config_data_update_hash (ip_data);
+			if (!ip_data->hash.empty)
+				g_checksum_update (sum, ip_data->hash.digest, HASH_LEN);
+		}
 	}
 
 	nm_utils_checksum_get_digest_len (sum, buffer, HASH_LEN);
@@ -1244,48 +1282,107 @@ get_ip_rdns_domains (NMIPConfig *ip_config)
 	return _nm_utils_strv_cleanup (strv, FALSE, FALSE, TRUE);
 }
 
-/* Check if the domain is shadowed by a parent domain with more negative priority */
-static gboolean
-domain_is_shadowed (GHashTable *ht,
-                    const char *domain, int priority,
-                    const char **out_parent, int *out_parent_priority)
+/* A trie of the domains added by rebuild_domain_lists(), with the labels
+ * in reverse order (top-level label first). The root node is the wildcard
+ * domain "". */
+typedef struct {
+	GHashTable *children;   /* label => DomainNode */
+	const char *domain;
+	int priority;           /* zero, if @domain was not added */
+	char label[];
+} DomainNode;
+
+static DomainNode *
+_domain_node_new (const char *label)
 {
-	char *parent;
-	int parent_priority;
+	DomainNode *node;
+	gsize len = strlen (label);
+
+	node = g_malloc (sizeof (DomainNode) + len + 1);
+	node->children = NULL;
+	node->domain = NULL;
+	node->priority = 0;
+	memcpy (node->label, label, len + 1);
+	return node;
+}
 
-	nm_assert (!g_hash_table_contains (ht, domain));
+static void
+_domain_node_free (gpointer data)
+{
+	DomainNode *node = data;
 
-	parent_priority = GPOINTER_TO_INT (g_hash_table_lookup (ht, ""));
-	if (parent_priority < 0 && parent_priority < priority) {
-		*out_parent = "";
-		*out_parent_priority = parent_priority;
-		return TRUE;
-	}
+	nm_clear_pointer (&node->children, g_hash_table_destroy);
+	g_free (node);
+}
 
-	parent = strchr (domain, '.');
-	while (parent && parent[1]) {
-		parent++;
-		parent_priority = GPOINTER_TO_INT (g_hash_table_lookup (ht, parent));
-		if (parent_priority < 0 && parent_priority < priority) {
-			*out_parent = parent;
-			*out_parent_priority = parent_priority;
-			return TRUE;
+/* Looks up @domain below @root. With @create, missing nodes are added.
+ * The first parent domain with a negative priority lower than @priority
+ * is returned in @out_shadowed_by. Returns %NULL if the node doesn't
+ * exist and @create is %FALSE. */
+static DomainNode *
+_domain_trie_walk (DomainNode *root,
+                   const char *domain,
+                   int priority,
+                   gboolean create,
+                   DomainNode **out_shadowed_by)
+{
+	gs_free char *buf_free = NULL;
+	DomainNode *node = root;
+	DomainNode *child;
+	char *buf;
+	gsize start, end;
+
+	NM_SET_OUT (out_shadowed_by, NULL);
+
+	if (!domain[0])
+		return root;
+
+	end = strlen (domain);
+	buf = nm_strndup_a (300, domain, end, &buf_free);
+
+	for (;;) {
+		/* a dot separates labels, unless it's the last character. */
+		start = end;
+		while (   start > 0
+		       && !(   domain[start - 1] == '.'
+		            && domain[start] != '\0'))
+			start--;
+		buf[end] = '\0';
+
+		if (   out_shadowed_by
+		    && !*out_shadowed_by
+		    && node->priority < 0
+		    && node->priority < priority)
+			*out_shadowed_by = node;
+
+		child = node->children
+		        ? g_hash_table_lookup (node->children, &buf[start])
+		        : NULL;
+		if (!child) {
+			if (!create)
+				return NULL;
+			child = _domain_node_new (&buf[start]);
+			if (!node->children)
+				node->children = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, _domain_node_free);
+			g_hash_table_insert (node->children, child->label, child);
 		}
-		parent = strchr (parent, '.');
-	}
+		node = child;
 
-	return FALSE;
+		if (start == 0)
+			return node;
+		end = start - 1;
+	}
 }
 
 static void
 rebuild_domain_lists (NMDnsManager *self)
 {
 	NMDnsIPConfigData *ip_data;
-	gs_unref_hashtable GHashTable *ht = NULL;
+	DomainNode *root;
 	gboolean default_route_found = FALSE;
 	CList *head;
 
-	ht = g_hash_table_new (nm_str_hash, g_str_equal);
+	root = _domain_node_new ("");
 
 	head = _ip_config_lst_head (self);
 	c_list_for_each_entry (ip_data, head, ip_config_lst) {
@@ -1342,13 +1439,14 @@ rebuild_domain_lists (NMDnsManager *self)
 		n = 0;
 		for (i = 0; i < n_domains; i++) {
 			const char *domain_clean;
-			const char *parent;
-			int parent_priority;
+			DomainNode *node;
+			DomainNode *parent;
 
 			domain_clean = nm_utils_parse_dns_domain (domains[i], NULL);
 
 			/* Remove domains with lower priority */
-			old_priority = GPOINTER_TO_INT (g_hash_table_lookup (ht, domain_clean));
+			node = _domain_trie_walk (root, domain_clean, priority, FALSE, &parent);
+			old_priority = node ? node->priority : 0;
 			if (old_priority) {
 				if (old_priority < priority) {
 					_LOGT ("plugin: drop domain '%s' (i=%d, p=%d) because it already exists with p=%d",
@@ -1356,16 +1454,20 @@ rebuild_domain_lists (NMDnsManager *self)
 					       priority, old_priority);
 					continue;
 				}
-			} else if (domain_is_shadowed (ht, domain_clean, priority, &parent, &parent_priority)) {
+			} else if (parent) {
+				/* shadowed by a parent domain with more negative priority */
 				_LOGT ("plugin: drop domain '%s' (i=%d, p=%d) shadowed by '%s' (p=%d)",
 				       domains[i],
 				       ip_data->data->ifindex, priority,
-				       parent, parent_priority);
+				       parent->domain, parent->priority);
 				continue;
 			}
 
 			_LOGT ("plugin: add domain '%s' (i=%d, p=%d)", domains[i], ip_data->data->ifindex, priority);
-			g_hash_table_insert (ht, (gpointer) domain_clean, GINT_TO_POINTER (priority));
+			if (!node)
+				node = _domain_trie_walk (root, domain_clean, priority, TRUE, NULL);
+			node->domain = domain_clean;
+			node->priority = priority;
 			domains[n++] = domains[i];
 		}
 		domains[n] = NULL;
@@ -1373,6 +1475,8 @@ rebuild_domain_lists (NMDnsManager *self)
 		g_strfreev (ip_data->domains.reverse);
 		ip_data->domains.reverse = get_ip_rdns_domains (ip_config);
 	}
+
+	_domain_node_free (root);
 }
 
 static void
@@ -1630,13 +1734,19 @@ plugin_child_quit (NMDnsPlugin *plugin, int exit_status, gpointer user_data)
 }
 
 static void
-_ip_config_dns_priority_changed (gpointer config,
-                                 GParamSpec *pspec,
-                                 NMDnsIPConfigData *ip_data)
+_ip_config_notify (gpointer config,
+                   GParamSpec *pspec,
+                   NMDnsIPConfigData *ip_data)
 {
 	_ASSERT_ip_config_data (ip_data);
 
-	NM_DNS_MANAGER_GET_PRIVATE (ip_data->data->self)->ip_config_lst_need_sort = TRUE;
+	ip_data->hash.valid = FALSE;
+
+	if (nm_streq (pspec->name,
+	              NM_IS_IP4_CONFIG (config)
+	                ? NM_IP4_CONFIG_DNS_PRIORITY
+	                : NM_IP6_CONFIG_DNS_PRIORITY))
+		NM_DNS_MANAGER_GET_PRIVATE (ip_data->data->self)->ip_config_lst_need_sort = TRUE;
 }
 
 gboolean
@@ -54,6 +54,14 @@ typedef struct {
 		const char **search;
 		char **reverse;
 	} domains;
+	/* cached nm_ip_config_hash() of the DNS parameters, see compute_hash(). */
+	struct {
+		guint8 digest[NM_UTILS_CHECKSUM_LENGTH_SHA1];
+		int mdns;
+		int llmnr;
+		bool valid:1;
+		bool empty:1;
+	} hash;
 } NMDnsIPConfigData;
 
 typedef struct _NMDnsConfigData {
@@ -55,18 +55,36 @@ typedef struct {
 	CList configs_lst_head;
 } InterfaceConfig;
 
+typedef enum {
+	LINK_OP_DNS,
+	LINK_OP_DOMAINS,
+	LINK_OP_MULTICAST_DNS,
+	LINK_OP_LLMNR,
+	_LINK_OP_NUM,
+} LinkOp;
+
+static const char *const _link_op_names[_LINK_OP_NUM] = {
+	[LINK_OP_DNS]           = "SetLinkDNS",
+	[LINK_OP_DOMAINS]       = "SetLinkDomains",
+	[LINK_OP_MULTICAST_DNS] = "SetLinkMulticastDNS",
+	[LINK_OP_LLMNR]         = "SetLinkLLMNR",
+};
+
+/* The last configuration pushed to systemd-resolved for a link. Only the
+ * operations whose argument changed are sent again. */
 typedef struct {
-	CList request_queue_lst;
-	const char *operation;
-	GVariant *argument;
-} RequestItem;
+	int ifindex;
+	GVariant *args[_LINK_OP_NUM];
+	guint8 dirty;           /* bitmask of LinkOp that need to be sent */
+	bool seen:1;
+} LinkState;
 
 /*****************************************************************************/
 
 typedef struct {
 	GDBusConnection *dbus_connection;
 	GCancellable *cancellable;
-	CList request_queue_lst_head;
+	GHashTable *links;      /* ifindex => LinkState */
 	guint name_owner_changed_id;
 	bool send_updates_warn_ratelimited:1;
 	bool try_start_blocked:1;
@@ -95,24 +113,57 @@ G_DEFINE_TYPE (NMDnsSystemdResolved, nm_dns_systemd_resolved, NM_TYPE_DNS_PLUGIN
 /*****************************************************************************/
 
 static void
-_request_item_free (RequestItem *request_item)
+_link_state_free (gpointer data)
 {
-	c_list_unlink_stale (&request_item->request_queue_lst);
-	g_variant_unref (request_item->argument);
-	g_slice_free (RequestItem, request_item);
+	LinkState *link_state = data;
+	LinkOp op;
+
+	for (op = 0; op < _LINK_OP_NUM; op++)
+		nm_clear_pointer (&link_state->args[op], g_variant_unref);
+	g_slice_free (LinkState, link_state);
 }
 
 static void
-_request_item_append (CList *request_queue_lst_head,
-                      const char *operation,
-                      GVariant *argument)
+_link_state_set (NMDnsSystemdResolved *self,
+                 int ifindex,
+                 LinkOp op,
+                 GVariant *argument)
 {
-	RequestItem *request_item;
+	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
+	gs_unref_variant GVariant *arg = g_variant_ref_sink (argument);
+	LinkState *link_state;
+
+	link_state = g_hash_table_lookup (priv->links, GINT_TO_POINTER (ifindex));
+	if (!link_state) {
+		link_state = g_slice_new0 (LinkState);
+		link_state->ifindex = ifindex;
+		g_hash_table_insert (priv->links, GINT_TO_POINTER (ifindex), link_state);
+	}
+
+	link_state->seen = TRUE;
 
-	request_item = g_slice_new (RequestItem);
-	request_item->operation = operation;
-	request_item->argument = g_variant_ref_sink (argument);
-	c_list_link_tail (request_queue_lst_head, &request_item->request_queue_lst);
+	if (   link_state->args[op]
+	    && g_variant_equal (link_state->args[op], arg))
+		return;
+
+	g_variant_ref (arg);
+	nm_clear_pointer (&link_state->args[op], g_variant_unref);
+	link_state->args[op] = arg;
+	link_state->dirty |= (1u << op);
+}
+
+/* Marks the configuration of all links to be sent again, for example
+ * because systemd-resolved was restarted and lost it. */
+static void
+_link_state_set_all_dirty (NMDnsSystemdResolved *self)
+{
+	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
+	GHashTableIter iter;
+	LinkState *link_state;
+
+	g_hash_table_iter_init (&iter, priv->links);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &link_state))
+		link_state->dirty = (1u << _LINK_OP_NUM) - 1;
 }
 
 /*****************************************************************************/
@@ -140,6 +191,8 @@ call_done (GObject *source, GAsyncResult *r, gpointer user_data)
 	priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
 
 	if (!v) {
+		/* only changes are sent. Resend everything on the next update. */
+		_link_state_set_all_dirty (self);
 		if (!priv->send_updates_warn_ratelimited) {
 			priv->send_updates_warn_ratelimited = TRUE;
 			_LOGW ("send-updates failed to update systemd-resolved: %s", error->message);
@@ -186,22 +239,9 @@ update_add_ip_config (NMDnsSystemdResolved *self,
 	}
 }
 
-static void
-free_pending_updates (NMDnsSystemdResolved *self)
-{
-	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
-	RequestItem *request_item;
-
-	while ((request_item = c_list_first_entry (&priv->request_queue_lst_head,
-	                                           RequestItem,
-	                                           request_queue_lst)))
-		_request_item_free (request_item);
-}
-
 static void
 prepare_one_interface (NMDnsSystemdResolved *self, InterfaceConfig *ic)
 {
-	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
 	GVariantBuilder dns, domains;
 	NMCListElem *elem;
 	NMSettingConnectionMdns mdns = NM_SETTING_CONNECTION_MDNS_DEFAULT;
@@ -263,27 +303,37 @@ prepare_one_interface (NMDnsSystemdResolved *self, InterfaceConfig *ic)
 	}
 	nm_assert (llmnr_arg);
 
-	_request_item_append (&priv->request_queue_lst_head,
-	                      "SetLinkDNS",
-	                      g_variant_builder_end (&dns));
-	_request_item_append (&priv->request_queue_lst_head,
-	                      "SetLinkDomains",
-	                      g_variant_builder_end (&domains));
-	_request_item_append (&priv->request_queue_lst_head,
-	                      "SetLinkMulticastDNS",
-	                      g_variant_new ("(is)", ic->ifindex, mdns_arg ?: ""));
-	_request_item_append (&priv->request_queue_lst_head,
-	                      "SetLinkLLMNR",
-	                      g_variant_new ("(is)", ic->ifindex, llmnr_arg ?: ""));
+	_link_state_set (self, ic->ifindex, LINK_OP_DNS,
+	                 g_variant_builder_end (&dns));
+	_link_state_set (self, ic->ifindex, LINK_OP_DOMAINS,
+	                 g_variant_builder_end (&domains));
+	_link_state_set (self, ic->ifindex, LINK_OP_MULTICAST_DNS,
+	                 g_variant_new ("(is)", ic->ifindex, mdns_arg ?: ""));
+	_link_state_set (self, ic->ifindex, LINK_OP_LLMNR,
+	                 g_variant_new ("(is)", ic->ifindex, llmnr_arg ?: ""));
 }
 
 static void
 send_updates (NMDnsSystemdResolved *self)
 {
 	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
-	RequestItem *request_item;
+	gs_free gpointer *links_keys = NULL;
+	guint links_len;
+	guint i, n_requests;
+	LinkState *link_state;
+	GHashTableIter iter;
+	LinkOp op;
+
+	n_requests = 0;
+	g_hash_table_iter_init (&iter, priv->links);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &link_state)) {
+		for (op = 0; op < _LINK_OP_NUM; op++) {
+			if (NM_FLAGS_HAS (link_state->dirty, (1u << op)))
+				n_requests++;
+		}
+	}
 
-	if (c_list_is_empty (&priv->request_queue_lst_head)) {
+	if (n_requests == 0) {
 		/* nothing to do. */
 		return;
 	}
@@ -319,37 +369,46 @@ send_updates (NMDnsSystemdResolved *self)
 		return;
 	}
 
-	_LOGT ("send-updates: start %lu requests",
-	       c_list_length (&priv->request_queue_lst_head));
-
-	nm_clear_g_cancellable (&priv->cancellable);
-
-	priv->cancellable = g_cancellable_new ();
-
-	while ((request_item = c_list_first_entry (&priv->request_queue_lst_head,
-	                                           RequestItem,
-	                                           request_queue_lst))) {
-		/* Above we explicitly call "StartServiceByName" trying to avoid D-Bus activating systmd-resolved
-		 * multiple times. There is still a race, were we might hit this line although actually
-		 * the service just quit this very moment. In that case, we would try to D-Bus activate the
-		 * service multiple times during each call (something we wanted to avoid).
-		 *
-		 * But this is hard to avoid, because we'd have to check the error failure to detect the reason
-		 * and retry. The race is not critical, because at worst it results in logging a warning
-		 * about failure to start systemd.resolved. */
-		g_dbus_connection_call (priv->dbus_connection,
-		                        SYSTEMD_RESOLVED_DBUS_SERVICE,
-		                        SYSTEMD_RESOLVED_DBUS_PATH,
-		                        SYSTEMD_RESOLVED_MANAGER_IFACE,
-		                        request_item->operation,
-		                        request_item->argument,
-		                        NULL,
-		                        G_DBUS_CALL_FLAGS_NONE,
-		                        -1,
-		                        priv->cancellable,
-		                        call_done,
-		                        self);
-		_request_item_free (request_item);
+	_LOGT ("send-updates: start %u requests", n_requests);
+
+	/* Requests still in flight are not cancelled: they carry changes that
+	 * are not repeated by this batch. */
+	if (!priv->cancellable)
+		priv->cancellable = g_cancellable_new ();
+
+	links_keys = nm_utils_hash_keys_to_array (priv->links,
+	                                          nm_cmp_int2ptr_p_with_data,
+	                                          NULL,
+	                                          &links_len);
+	for (i = 0; i < links_len; i++) {
+		link_state = g_hash_table_lookup (priv->links, links_keys[i]);
+
+		for (op = 0; op < _LINK_OP_NUM; op++) {
+			if (!NM_FLAGS_HAS (link_state->dirty, (1u << op)))
+				continue;
+
+			/* Above we explicitly call "StartServiceByName" trying to avoid D-Bus activating systmd-resolved
+			 * multiple times. There is still a race, were we might hit this line although actually
+			 * the service just quit this very moment. In that case, we would try to D-Bus activate the
+			 * service multiple times during each call (something we wanted to avoid).
+			 *
+			 * But this is hard to avoid, because we'd have to check the error failure to detect the reason
+			 * and retry. The race is not critical, because at worst it results in logging a warning
+			 * about failure to start systemd.resolved. */
+			g_dbus_connection_call (priv->dbus_connection,
+			                        SYSTEMD_RESOLVED_DBUS_SERVICE,
+			                        SYSTEMD_RESOLVED_DBUS_PATH,
+			                        SYSTEMD_RESOLVED_MANAGER_IFACE,
+			                        _link_op_names[op],
+			                        link_state->args[op],
+			                        NULL,
+			                        G_DBUS_CALL_FLAGS_NONE,
+			                        -1,
+			                        priv->cancellable,
+			                        call_done,
+			                        self);
+		}
+		link_state->dirty = 0;
 	}
 }
 
@@ -360,17 +419,17 @@ update (NMDnsPlugin *plugin,
         const char *hostname)
 {
 	NMDnsSystemdResolved *self = NM_DNS_SYSTEMD_RESOLVED (plugin);
+	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
 	gs_unref_hashtable GHashTable *interfaces = NULL;
-	gs_free gpointer *interfaces_keys = NULL;
-	guint interfaces_len;
-	guint i;
+	GHashTableIter iter;
+	InterfaceConfig *ic;
+	LinkState *link_state;
 	NMDnsIPConfigData *ip_data;
 
 	interfaces = g_hash_table_new_full (nm_direct_hash, NULL,
 	                                    NULL, (GDestroyNotify) _interface_config_free);
 
 	c_list_for_each_entry (ip_data, ip_config_lst_head, ip_config_lst) {
-		InterfaceConfig *ic = NULL;
 		int ifindex;
 
 		ifindex = ip_data->data->ifindex;
@@ -388,16 +447,20 @@ update (NMDnsPlugin *plugin,
 		                  &nm_c_list_elem_new_stale (ip_data)->lst);
 	}
 
-	free_pending_updates (self);
-
-	interfaces_keys = nm_utils_hash_keys_to_array (interfaces,
-	                                               nm_cmp_int2ptr_p_with_data,
-	                                               NULL,
-	                                               &interfaces_len);
-	for (i = 0; i < interfaces_len; i++) {
-		InterfaceConfig *ic = g_hash_table_lookup (interfaces, GINT_TO_POINTER (interfaces_keys[i]));
+	g_hash_table_iter_init (&iter, priv->links);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &link_state))
+		link_state->seen = FALSE;
 
+	g_hash_table_iter_init (&iter, interfaces);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ic))
 		prepare_one_interface (self, ic);
+
+	/* Forget links without configuration. If they get a configuration
+	 * again, it is sent in full. */
+	g_hash_table_iter_init (&iter, priv->links);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &link_state)) {
+		if (!link_state->seen)
+			g_hash_table_iter_remove (&iter);
 	}
 
 	send_updates (self);
@@ -435,8 +498,11 @@ name_owner_changed (NMDnsSystemdResolved *self,
 		_LOGT ("D-Bus name for systemd-resolved has owner %s", owner);
 
 	priv->dbus_has_owner = !!owner;
-	if (owner)
+	if (owner) {
 		priv->try_start_blocked = FALSE;
+		/* a (new) instance of systemd-resolved knows nothing about our links. */
+		_link_state_set_all_dirty (self);
+	}
 
 	send_updates (self);
 }
@@ -525,7 +591,7 @@ nm_dns_systemd_resolved_init (NMDnsSystemdResolved *self)
 {
 	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
 
-	c_list_init (&priv->request_queue_lst_head);
+	priv->links = g_hash_table_new_full (nm_direct_hash, NULL, NULL, _link_state_free);
 
 	priv->dbus_connection = nm_g_object_ref (nm_dbus_manager_get_dbus_connection (nm_dbus_manager_get ()));
 	if (!priv->dbus_connection) {
@@ -570,7 +636,7 @@ dispose (GObject *object)
 	NMDnsSystemdResolved *self = NM_DNS_SYSTEMD_RESOLVED (object);
 	NMDnsSystemdResolvedPrivate *priv = NM_DNS_SYSTEMD_RESOLVED_GET_PRIVATE (self);
 
-	free_pending_updates (self);
+	nm_clear_pointer (&priv->links, g_hash_table_destroy);
 
 	if (priv->name_owner_changed_id != 0) {
 		g_dbus_connection_signal_unsubscribe (priv->dbus_connection,
@@ -139,6 +139,7 @@ nm_main_config_reload (int signal)
 		break;
 	case SIGUSR2:
 		reload_flags = NM_CONFIG_CHANGE_CAUSE_SIGUSR2;
+		nm_logging_flight_recorder_dump ();
 		break;
 	default:
 		g_return_if_reached ();
@@ -352,6 +353,15 @@ main (int argc, char *argv[])
 		                              NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND,
 		                              NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
 		nm_logging_init (v, nm_config_get_is_debug (config));
+
+		nm_logging_init_async (nm_config_data_get_value_boolean (NM_CONFIG_GET_DATA_ORIG,
+		                                                         NM_CONFIG_KEYFILE_GROUP_LOGGING,
+		                                                         NM_CONFIG_KEYFILE_KEY_LOGGING_ASYNC,
+		                                                         FALSE),
+		                       ((gsize) nm_config_data_get_value_int64 (NM_CONFIG_GET_DATA_ORIG,
+		                                                                NM_CONFIG_KEYFILE_GROUP_LOGGING,
+		                                                                NM_CONFIG_KEYFILE_KEY_LOGGING_FLIGHT_RECORDER,
+		                                                                10, 0, 1024, 0)) * 1024 * 1024);
 	}
 
 	nm_log_info (LOGD_CORE, "NetworkManager (version " NM_DIST_VERSION ") is starting... (%s)",
@@ -390,7 +400,25 @@ main (int argc, char *argv[])
 	             );
 
 	/* Set up platform interaction layer */
-	nm_linux_platform_setup ();
+	{
+		gs_free char *ignore_route_tables = NULL;
+		gs_free char *ignore_route_protocols = NULL;
+		gs_free char *compact_route_tables = NULL;
+
+		ignore_route_tables = nm_config_data_get_value (NM_CONFIG_GET_DATA_ORIG,
+		                                                NM_CONFIG_KEYFILE_GROUP_MAIN,
+		                                                NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_IGNORE_ROUTE_TABLES,
+		                                                NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+		ignore_route_protocols = nm_config_data_get_value (NM_CONFIG_GET_DATA_ORIG,
+		                                                   NM_CONFIG_KEYFILE_GROUP_MAIN,
+		                                                   NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_IGNORE_ROUTE_PROTOCOLS,
+		                                                   NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+		compact_route_tables = nm_config_data_get_value (NM_CONFIG_GET_DATA_ORIG,
+		                                                 NM_CONFIG_KEYFILE_GROUP_MAIN,
+		                                                 NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_COMPACT_ROUTE_TABLES,
+		                                                 NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+		nm_linux_platform_setup_full (ignore_route_tables, ignore_route_protocols, compact_route_tables);
+	}
 
 	NM_UTILS_KEEP_ALIVE (config, nm_netns_get (), "NMConfig-depends-on-NMNetns");
 
@@ -177,7 +177,7 @@ nm_audit_log (NMAuditManager *self, GPtrArray *fields, const char *file,
 	}
 #endif
 
-	if (nm_logging_enabled (AUDIT_LOG_LEVEL, LOGD_AUDIT)) {
+	if (nm_logging_output_enabled (AUDIT_LOG_LEVEL, LOGD_AUDIT)) {
 		msg = build_message (fields, BACKEND_LOG);
 		_NMLOG (AUDIT_LOG_LEVEL, LOGD_AUDIT, "%s", msg);
 		g_free (msg);
@@ -243,7 +243,7 @@ nm_audit_manager_audit_enabled (NMAuditManager *self)
 		return TRUE;
 #endif
 
-	return nm_logging_enabled (AUDIT_LOG_LEVEL, LOGD_AUDIT);
+	return nm_logging_output_enabled (AUDIT_LOG_LEVEL, LOGD_AUDIT);
 }
 
 void
@@ -39,9 +39,25 @@ typedef struct {
 		 * "match-device" was unspecified. */
 		gboolean has;
 		GSList *spec;
+		NMMatchSpecDevice *compiled;
 	} match_device;
+
+	/* the values of the section, as returned by g_key_file_get_string(). */
+	GHashTable *values;
+
+	/* index into the per-device match memo. */
+	guint memo_idx;
 } MatchSectionInfo;
 
+typedef enum {
+	MATCH_MEMO_UNKNOWN = 0,
+	MATCH_MEMO_MATCH,
+	MATCH_MEMO_NO_MATCH,
+} MatchMemoResult;
+
+/* Don't let the memo grow without bounds, if devices come and go. */
+#define MATCH_MEMO_MAX_SIZE 4096
+
 struct _NMGlobalDnsDomain {
 	char *name;
 	char **servers;
@@ -86,6 +102,13 @@ typedef struct {
 	 * [device] sections. This is to speed up lookup. */
 	MatchSectionInfo *device_infos;
 
+	/* Caches the result of the match-device evaluation of all connection_infos
+	 * and device_infos. The key is built from the device properties that
+	 * match specs can refer to, so the entries never become stale. The value
+	 * is an array of MatchMemoResult, indexed by MatchSectionInfo.memo_idx. */
+	GHashTable *match_memo;
+	guint match_memo_len;
+
 	struct {
 		gboolean enabled;
 		char *uri;
@@ -1251,24 +1274,69 @@ global_dns_equal (NMGlobalDnsConfig *old, NMGlobalDnsConfig *new)
 
 /*****************************************************************************/
 
+static guint8 *
+_match_memo_get (const NMConfigData *self,
+                 NMDevice *device,
+                 NMMatchSpecDeviceData *out_data)
+{
+	NMConfigDataPrivate *priv = (NMConfigDataPrivate *) NM_CONFIG_DATA_GET_PRIVATE (self);
+	const char *fields[7];
+	GString *key;
+	guint8 *memo;
+	guint i;
+
+	nm_device_get_match_spec_data (device, out_data);
+
+	if (priv->match_memo_len == 0)
+		return NULL;
+
+	fields[0] = out_data->interface_name;
+	fields[1] = out_data->device_type;
+	fields[2] = out_data->driver;
+	fields[3] = out_data->driver_version;
+	fields[4] = out_data->hwaddr;
+	fields[5] = out_data->s390_subchannels;
+	fields[6] = out_data->dhcp_plugin;
+
+	key = g_string_sized_new (100);
+	for (i = 0; i < G_N_ELEMENTS (fields); i++) {
+		if (fields[i]) {
+			g_string_append_c (key, '+');
+			g_string_append (key, fields[i]);
+		} else
+			g_string_append_c (key, '-');
+		g_string_append_c (key, '\n');
+	}
+
+	if (!priv->match_memo)
+		priv->match_memo = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_free);
+	else {
+		memo = g_hash_table_lookup (priv->match_memo, key->str);
+		if (memo) {
+			g_string_free (key, TRUE);
+			return memo;
+		}
+		if (g_hash_table_size (priv->match_memo) >= MATCH_MEMO_MAX_SIZE)
+			g_hash_table_remove_all (priv->match_memo);
+	}
+
+	memo = g_new0 (guint8, priv->match_memo_len);
+	g_hash_table_insert (priv->match_memo, g_string_free (key, FALSE), memo);
+	return memo;
+}
+
 static const MatchSectionInfo *
 _match_section_infos_lookup (const MatchSectionInfo *match_section_infos,
-                             GKeyFile *keyfile,
                              const char *property,
-                             NMDevice *device,
-                             const NMPlatformLink *pllink,
-                             const char *match_device_type,
+                             const NMMatchSpecDeviceData *match_data,
+                             guint8 *match_memo,
                              char **out_value)
 {
-	const char *match_dhcp_plugin;
-
 	if (!match_section_infos)
 		return NULL;
 
-	match_dhcp_plugin = nm_dhcp_manager_get_config (nm_dhcp_manager_get ());
-
 	for (; match_section_infos->group_name; match_section_infos++) {
-		char *value = NULL;
+		const char *value = NULL;
 		gboolean match;
 
 		/* FIXME: Here we use g_key_file_get_string(). This should be in sync with what keyfile-reader
@@ -1278,25 +1346,30 @@ _match_section_infos_lookup (const MatchSectionInfo *match_section_infos,
 		 * string_to_value(keyfile_to_string(keyfile)) in one. Optimally, keyfile library would
 		 * expose both functions, and we would return here keyfile_to_string(keyfile).
 		 * The caller then could convert the string to the proper value via string_to_value(value). */
-		value = g_key_file_get_string (keyfile, match_section_infos->group_name, property, NULL);
+		if (match_section_infos->values)
+			value = g_hash_table_lookup (match_section_infos->values, property);
 		if (!value && !match_section_infos->stop_match)
 			continue;
 
 		if (match_section_infos->match_device.has) {
-			if (device)
-				match = nm_device_spec_match_list (device, match_section_infos->match_device.spec);
-			else if (pllink)
-				match = nm_match_spec_device_by_pllink (pllink, match_device_type, match_dhcp_plugin, match_section_infos->match_device.spec, FALSE);
-			else
+			if (!match_data)
 				match = FALSE;
+			else if (   match_memo
+			         && match_memo[match_section_infos->memo_idx] != MATCH_MEMO_UNKNOWN)
+				match = (match_memo[match_section_infos->memo_idx] == MATCH_MEMO_MATCH);
+			else {
+				match = (nm_match_spec_device_compiled_match (match_section_infos->match_device.compiled,
+				                                              match_data) == NM_MATCH_SPEC_MATCH);
+				if (match_memo)
+					match_memo[match_section_infos->memo_idx] = match ? MATCH_MEMO_MATCH : MATCH_MEMO_NO_MATCH;
+			}
 		} else
 			match = TRUE;
 
 		if (match) {
-			*out_value = value;
+			*out_value = g_strdup (value);
 			return match_section_infos;
 		}
-		g_free (value);
 	}
 	return NULL;
 }
@@ -1309,6 +1382,8 @@ nm_config_data_get_device_config (const NMConfigData *self,
 {
 	const NMConfigDataPrivate *priv;
 	const MatchSectionInfo *connection_info;
+	NMMatchSpecDeviceData match_data;
+	guint8 *match_memo = NULL;
 	char *value = NULL;
 
 	g_return_val_if_fail (self, NULL);
@@ -1316,12 +1391,13 @@ nm_config_data_get_device_config (const NMConfigData *self,
 
 	priv = NM_CONFIG_DATA_GET_PRIVATE (self);
 
+	if (device && priv->device_infos)
+		match_memo = _match_memo_get (self, device, &match_data);
+
 	connection_info = _match_section_infos_lookup (&priv->device_infos[0],
-	                                               priv->keyfile,
 	                                               property,
-	                                               device,
-	                                               NULL,
-	                                               NULL,
+	                                               device ? &match_data : NULL,
+	                                               match_memo,
 	                                               &value);
 	NM_SET_OUT (has_match, !!connection_info);
 	return value;
@@ -1336,6 +1412,7 @@ nm_config_data_get_device_config_by_pllink (const NMConfigData *self,
 {
 	const NMConfigDataPrivate *priv;
 	const MatchSectionInfo *connection_info;
+	NMMatchSpecDeviceData match_data;
 	char *value = NULL;
 
 	g_return_val_if_fail (self, NULL);
@@ -1343,12 +1420,21 @@ nm_config_data_get_device_config_by_pllink (const NMConfigData *self,
 
 	priv = NM_CONFIG_DATA_GET_PRIVATE (self);
 
+	/* we can only match by certain properties that are available on the
+	 * platform link. See nm_match_spec_device_by_pllink(). */
+	if (pllink) {
+		match_data = (NMMatchSpecDeviceData) {
+			.interface_name = pllink->name,
+			.device_type    = match_device_type,
+			.driver         = pllink->driver,
+			.dhcp_plugin    = nm_dhcp_manager_get_config (nm_dhcp_manager_get ()),
+		};
+	}
+
 	connection_info = _match_section_infos_lookup (&priv->device_infos[0],
-	                                               priv->keyfile,
 	                                               property,
+	                                               pllink ? &match_data : NULL,
 	                                               NULL,
-	                                               pllink,
-	                                               match_device_type,
 	                                               &value);
 	NM_SET_OUT (has_match, !!connection_info);
 	return value;
@@ -1376,6 +1462,8 @@ nm_config_data_get_connection_default (const NMConfigData *self,
                                        NMDevice *device)
 {
 	const NMConfigDataPrivate *priv;
+	NMMatchSpecDeviceData match_data;
+	guint8 *match_memo = NULL;
 	char *value = NULL;
 
 	g_return_val_if_fail (self, NULL);
@@ -1397,12 +1485,13 @@ nm_config_data_get_connection_default (const NMConfigData *self,
 	}
 #endif
 
+	if (device && priv->connection_infos)
+		match_memo = _match_memo_get (self, device, &match_data);
+
 	_match_section_infos_lookup (&priv->connection_infos[0],
-	                             priv->keyfile,
 	                             property,
-	                             device,
-	                             NULL,
-	                             NULL,
+	                             device ? &match_data : NULL,
+	                             match_memo,
 	                             &value);
 	return value;
 }
@@ -1422,15 +1511,32 @@ nm_config_data_get_connection_default_int64 (const NMConfigData *self,
 }
 
 static void
-_get_connection_info_init (MatchSectionInfo *connection_info, GKeyFile *keyfile, char *group)
+_get_connection_info_init (MatchSectionInfo *connection_info, GKeyFile *keyfile, char *group, guint memo_idx)
 {
+	gs_strfreev char **keys = NULL;
+	gsize i;
+
 	/* pass ownership of @group on... */
 	connection_info->group_name = group;
+	connection_info->memo_idx = memo_idx;
 
 	connection_info->match_device.spec = nm_config_get_match_spec (keyfile,
 	                                                               group,
 	                                                               NM_CONFIG_KEYFILE_KEY_MATCH_DEVICE,
 	                                                               &connection_info->match_device.has);
+	connection_info->match_device.compiled = nm_match_spec_device_compile (connection_info->match_device.spec);
+
+	keys = g_key_file_get_keys (keyfile, group, NULL, NULL);
+	if (keys && keys[0]) {
+		connection_info->values = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_free);
+		for (i = 0; keys[i]; i++) {
+			char *value;
+
+			value = g_key_file_get_string (keyfile, group, keys[i], NULL);
+			if (value)
+				g_hash_table_insert (connection_info->values, g_strdup (keys[i]), value);
+		}
+	}
 	connection_info->stop_match = nm_config_keyfile_get_boolean (keyfile,
 	                                                             group,
 	                                                             NM_CONFIG_KEYFILE_KEY_STOP_MATCH,
@@ -1447,12 +1553,14 @@ _match_section_infos_free (MatchSectionInfo *match_section_infos)
 	for (i = 0; match_section_infos[i].group_name; i++) {
 		g_free (match_section_infos[i].group_name);
 		g_slist_free_full (match_section_infos[i].match_device.spec, g_free);
+		nm_match_spec_device_free (match_section_infos[i].match_device.compiled);
+		nm_clear_pointer (&match_section_infos[i].values, g_hash_table_unref);
 	}
 	g_free (match_section_infos);
 }
 
 static MatchSectionInfo *
-_match_section_infos_construct (GKeyFile *keyfile, const char *prefix)
+_match_section_infos_construct (GKeyFile *keyfile, const char *prefix, guint *p_memo_len)
 {
 	char **groups;
 	gsize i, j, ngroups;
@@ -1491,11 +1599,11 @@ _match_section_infos_construct (GKeyFile *keyfile, const char *prefix)
 	match_section_infos = g_new0 (MatchSectionInfo, ngroups + 1 + (connection_tag ? 1 : 0));
 	for (i = 0; i < ngroups; i++) {
 		/* pass ownership of @group on... */
-		_get_connection_info_init (&match_section_infos[i], keyfile, groups[ngroups - i - 1]);
+		_get_connection_info_init (&match_section_infos[i], keyfile, groups[ngroups - i - 1], (*p_memo_len)++);
 	}
 	if (connection_tag) {
 		/* pass ownership of @connection_tag on... */
-		_get_connection_info_init (&match_section_infos[i], keyfile, connection_tag);
+		_get_connection_info_init (&match_section_infos[i], keyfile, connection_tag, (*p_memo_len)++);
 	}
 	g_free (groups);
 
@@ -1674,8 +1782,8 @@ constructed (GObject *object)
 
 	priv->keyfile = _merge_keyfiles (priv->keyfile_user, priv->keyfile_intern);
 
-	priv->connection_infos = _match_section_infos_construct (priv->keyfile, NM_CONFIG_KEYFILE_GROUPPREFIX_CONNECTION);
-	priv->device_infos = _match_section_infos_construct (priv->keyfile, NM_CONFIG_KEYFILE_GROUPPREFIX_DEVICE);
+	priv->connection_infos = _match_section_infos_construct (priv->keyfile, NM_CONFIG_KEYFILE_GROUPPREFIX_CONNECTION, &priv->match_memo_len);
+	priv->device_infos = _match_section_infos_construct (priv->keyfile, NM_CONFIG_KEYFILE_GROUPPREFIX_DEVICE, &priv->match_memo_len);
 
 	priv->connectivity.enabled = nm_config_keyfile_get_boolean (priv->keyfile,
 	                                                            NM_CONFIG_KEYFILE_GROUP_CONNECTIVITY,
@@ -1807,6 +1915,7 @@ finalize (GObject *gobject)
 
 	_match_section_infos_free (priv->connection_infos);
 	_match_section_infos_free (priv->device_infos);
+	nm_clear_pointer (&priv->match_memo, g_hash_table_unref);
 
 	g_key_file_unref (priv->keyfile);
 	if (priv->keyfile_user)
@@ -760,6 +760,9 @@ static const ConfigGroup config_groups[] = {
 			NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_CARRIER,
 			NM_CONFIG_KEYFILE_KEY_MAIN_MONITOR_CONNECTION_FILES,
 			NM_CONFIG_KEYFILE_KEY_MAIN_NO_AUTO_DEFAULT,
+			NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_COMPACT_ROUTE_TABLES,
+			NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_IGNORE_ROUTE_PROTOCOLS,
+			NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_IGNORE_ROUTE_TABLES,
 			NM_CONFIG_KEYFILE_KEY_MAIN_PLUGINS,
 			NM_CONFIG_KEYFILE_KEY_MAIN_RC_MANAGER,
 			NM_CONFIG_KEYFILE_KEY_MAIN_SLAVES_ORDER,
@@ -769,9 +772,11 @@ static const ConfigGroup config_groups[] = {
 	{
 		.group = NM_CONFIG_KEYFILE_GROUP_LOGGING,
 		.keys = NM_MAKE_STRV (
+			NM_CONFIG_KEYFILE_KEY_LOGGING_ASYNC,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_AUDIT,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_DOMAINS,
+			NM_CONFIG_KEYFILE_KEY_LOGGING_FLIGHT_RECORDER,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_LEVEL,
 		),
 	},
@@ -789,6 +794,7 @@ static const ConfigGroup config_groups[] = {
 		.keys = NM_MAKE_STRV (
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH,
+			NM_CONFIG_KEYFILE_KEY_KEYFILE_SNAPSHOT,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES,
 		),
 	},
@@ -68,14 +68,19 @@
 #define NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_CARRIER           "ignore-carrier"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_MONITOR_CONNECTION_FILES "monitor-connection-files"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_NO_AUTO_DEFAULT          "no-auto-default"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_COMPACT_ROUTE_TABLES "platform-compact-route-tables"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_IGNORE_ROUTE_PROTOCOLS "platform-ignore-route-protocols"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_IGNORE_ROUTE_TABLES "platform-ignore-route-tables"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_PLUGINS                  "plugins"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_RC_MANAGER               "rc-manager"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SLAVES_ORDER             "slaves-order"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED         "systemd-resolved"
 
+#define NM_CONFIG_KEYFILE_KEY_LOGGING_ASYNC                 "async"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_AUDIT                 "audit"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND               "backend"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_DOMAINS               "domains"
+#define NM_CONFIG_KEYFILE_KEY_LOGGING_FLIGHT_RECORDER       "flight-recorder"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_LEVEL                 "level"
 
 #define NM_CONFIG_KEYFILE_KEY_CONNECTIVITY_ENABLED          "enabled"
@@ -86,6 +91,7 @@
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH                  "path"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES     "unmanaged-devices"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME              "hostname"
+#define NM_CONFIG_KEYFILE_KEY_KEYFILE_SNAPSHOT              "snapshot"
 
 #define NM_CONFIG_KEYFILE_KEY_IFUPDOWN_MANAGED              "managed"
 
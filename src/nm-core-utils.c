@@ -1501,6 +1501,370 @@ nm_match_spec_device (const GSList *specs,
 	return _match_result (has_except, has_not_except, has_match, has_match_except);
 }
 
+/*****************************************************************************/
+
+typedef struct {
+	guint32 a;
+	guint32 b;
+	guint32 c;
+} MatchCompiledS390;
+
+typedef struct {
+	char *driver;
+	gsize driver_len;
+	GPatternSpec *version;
+} MatchCompiledDriverVersion;
+
+typedef struct {
+	bool match_all:1;
+	bool has_s390:1;
+	GHashTable *interface_names;
+	GPtrArray *interface_name_patterns;
+	GHashTable *device_types;
+	GHashTable *drivers;
+	GArray *driver_versions;
+	GHashTable *hwaddrs;
+	GArray *s390_subchannels;
+	GHashTable *dhcp_plugins;
+} MatchCompiledSet;
+
+struct _NMMatchSpecDevice {
+	MatchCompiledSet match;
+	MatchCompiledSet except;
+	bool has_except:1;
+	bool has_not_except:1;
+};
+
+static guint
+_match_hwaddr_hash (gconstpointer ptr)
+{
+	const guint8 *bin = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1481301947u);
+	nm_hash_update_mem (&h, bin, ((gsize) bin[0]) + 1);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_match_hwaddr_equal (gconstpointer a, gconstpointer b)
+{
+	const guint8 *bin_a = a;
+	const guint8 *bin_b = b;
+
+	return    bin_a[0] == bin_b[0]
+	       && memcmp (&bin_a[1], &bin_b[1], bin_a[0]) == 0;
+}
+
+static gboolean
+_match_hwaddr_aton (const char *str, guint8 *buf /* of size NM_UTILS_HWADDR_LEN_MAX + 1 */)
+{
+	gsize l;
+
+	if (!_nm_utils_hwaddr_aton (str, &buf[1], NM_UTILS_HWADDR_LEN_MAX, &l))
+		return FALSE;
+	nm_assert (l > 0 && l <= NM_UTILS_HWADDR_LEN_MAX);
+	buf[0] = l;
+
+	/* like nm_utils_hwaddr_matches(), only the last 8 bytes of an
+	 * InfiniBand address are significant. Clear the others, so that
+	 * _match_hwaddr_hash() and _match_hwaddr_equal() ignore them. */
+	if (l == INFINIBAND_ALEN)
+		memset (&buf[1], 0, INFINIBAND_ALEN - 8);
+	return TRUE;
+}
+
+static void
+_match_set_add_str (GHashTable **p_set, const char *str)
+{
+	if (!*p_set)
+		*p_set = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+	g_hash_table_add (*p_set, g_strdup (str));
+}
+
+static void
+_match_set_add_hwaddr (MatchCompiledSet *set, const char *str)
+{
+	guint8 buf[NM_UTILS_HWADDR_LEN_MAX + 1];
+
+	if (!_match_hwaddr_aton (str, buf))
+		return;
+	if (!set->hwaddrs)
+		set->hwaddrs = g_hash_table_new_full (_match_hwaddr_hash, _match_hwaddr_equal, g_free, NULL);
+	g_hash_table_add (set->hwaddrs, g_memdup (buf, buf[0] + 1));
+}
+
+static void
+_match_set_compile_one (MatchCompiledSet *set,
+                        const char *spec_str,
+                        gboolean allow_fuzzy)
+{
+	/* this must be kept in sync with match_device_eval(). Tags are
+	 * case-insensitive and stripped by _MATCH_CHECK(). */
+
+	if (spec_str[0] == '*' && spec_str[1] == '\0') {
+		set->match_all = TRUE;
+		return;
+	}
+
+	if (_MATCH_CHECK (spec_str, DEVICE_TYPE_TAG)) {
+		_match_set_add_str (&set->device_types, spec_str);
+		return;
+	}
+
+	if (_MATCH_CHECK (spec_str, MAC_TAG)) {
+		_match_set_add_hwaddr (set, spec_str);
+		return;
+	}
+
+	if (_MATCH_CHECK (spec_str, INTERFACE_NAME_TAG)) {
+		gboolean use_pattern = FALSE;
+
+		if (spec_str[0] == '=')
+			spec_str += 1;
+		else {
+			if (spec_str[0] == '~')
+				spec_str += 1;
+			use_pattern = TRUE;
+		}
+
+		_match_set_add_str (&set->interface_names, spec_str);
+		if (   use_pattern
+		    && strpbrk (spec_str, "*?")) {
+			if (!set->interface_name_patterns)
+				set->interface_name_patterns = g_ptr_array_new_with_free_func ((GDestroyNotify) g_pattern_spec_free);
+			g_ptr_array_add (set->interface_name_patterns, g_pattern_spec_new (spec_str));
+		}
+		return;
+	}
+
+	if (_MATCH_CHECK (spec_str, DRIVER_TAG)) {
+		MatchCompiledDriverVersion *dv;
+		const char *t;
+
+		t = strrchr (spec_str, '/');
+		if (!t) {
+			_match_set_add_str (&set->drivers, spec_str);
+			return;
+		}
+
+		if (!set->driver_versions)
+			set->driver_versions = g_array_new (FALSE, FALSE, sizeof (MatchCompiledDriverVersion));
+		g_array_set_size (set->driver_versions, set->driver_versions->len + 1);
+		dv = &g_array_index (set->driver_versions, MatchCompiledDriverVersion, set->driver_versions->len - 1);
+		dv->driver_len = t - spec_str;
+		dv->driver = g_strndup (spec_str, dv->driver_len);
+		dv->version = g_pattern_spec_new (&t[1]);
+		return;
+	}
+
+	if (_MATCH_CHECK (spec_str, SUBCHAN_TAG)) {
+		MatchCompiledS390 s390;
+
+		if (!match_device_s390_subchannels_parse (spec_str, &s390.a, &s390.b, &s390.c))
+			return;
+		if (!set->s390_subchannels)
+			set->s390_subchannels = g_array_new (FALSE, FALSE, sizeof (MatchCompiledS390));
+		g_array_append_val (set->s390_subchannels, s390);
+		return;
+	}
+
+	if (_MATCH_CHECK (spec_str, DHCP_PLUGIN_TAG)) {
+		_match_set_add_str (&set->dhcp_plugins, spec_str);
+		return;
+	}
+
+	if (allow_fuzzy) {
+		_match_set_add_hwaddr (set, spec_str);
+		_match_set_add_str (&set->interface_names, spec_str);
+	}
+}
+
+static void
+_match_set_clear (MatchCompiledSet *set)
+{
+	guint i;
+
+	nm_clear_pointer (&set->interface_names, g_hash_table_unref);
+	nm_clear_pointer (&set->interface_name_patterns, g_ptr_array_unref);
+	nm_clear_pointer (&set->device_types, g_hash_table_unref);
+	nm_clear_pointer (&set->drivers, g_hash_table_unref);
+	if (set->driver_versions) {
+		for (i = 0; i < set->driver_versions->len; i++) {
+			MatchCompiledDriverVersion *dv = &g_array_index (set->driver_versions, MatchCompiledDriverVersion, i);
+
+			g_free (dv->driver);
+			g_pattern_spec_free (dv->version);
+		}
+		nm_clear_pointer (&set->driver_versions, g_array_unref);
+	}
+	nm_clear_pointer (&set->hwaddrs, g_hash_table_unref);
+	nm_clear_pointer (&set->s390_subchannels, g_array_unref);
+	nm_clear_pointer (&set->dhcp_plugins, g_hash_table_unref);
+}
+
+static gboolean
+_match_set_eval (const MatchCompiledSet *set,
+                 const NMMatchSpecDeviceData *data,
+                 const guint8 *hwaddr_bin,
+                 const MatchCompiledS390 *s390)
+{
+	guint i;
+
+	if (set->match_all)
+		return TRUE;
+
+	if (   set->device_types
+	    && data->device_type
+	    && g_hash_table_contains (set->device_types, data->device_type))
+		return TRUE;
+
+	if (   set->hwaddrs
+	    && hwaddr_bin
+	    && g_hash_table_contains (set->hwaddrs, hwaddr_bin))
+		return TRUE;
+
+	if (data->interface_name) {
+		if (   set->interface_names
+		    && g_hash_table_contains (set->interface_names, data->interface_name))
+			return TRUE;
+		if (set->interface_name_patterns) {
+			for (i = 0; i < set->interface_name_patterns->len; i++) {
+				if (g_pattern_match_string (set->interface_name_patterns->pdata[i], data->interface_name))
+					return TRUE;
+			}
+		}
+	}
+
+	if (data->driver) {
+		if (   set->drivers
+		    && g_hash_table_contains (set->drivers, data->driver))
+			return TRUE;
+		if (set->driver_versions) {
+			for (i = 0; i < set->driver_versions->len; i++) {
+				const MatchCompiledDriverVersion *dv = &g_array_index (set->driver_versions, MatchCompiledDriverVersion, i);
+
+				/* like match_device_eval(), the driver part is compared
+				 * with strncmp(). */
+				if (   strncmp (dv->driver, data->driver, dv->driver_len) == 0
+				    && g_pattern_match_string (dv->version, data->driver_version ?: ""))
+					return TRUE;
+			}
+		}
+	}
+
+	if (   set->s390_subchannels
+	    && s390) {
+		for (i = 0; i < set->s390_subchannels->len; i++) {
+			const MatchCompiledS390 *s = &g_array_index (set->s390_subchannels, MatchCompiledS390, i);
+
+			if (   s->a == s390->a
+			    && s->b == s390->b
+			    && s->c == s390->c)
+				return TRUE;
+		}
+	}
+
+	if (   set->dhcp_plugins
+	    && data->dhcp_plugin
+	    && g_hash_table_contains (set->dhcp_plugins, data->dhcp_plugin))
+		return TRUE;
+
+	return FALSE;
+}
+
+/**
+ * nm_match_spec_device_compile:
+ * @specs: the list of device match specs
+ *
+ * Parses @specs once, so that they can be evaluated repeatedly with
+ * nm_match_spec_device_compiled_match(). The result is the same as
+ * with nm_match_spec_device().
+ *
+ * Returns: (transfer full): the compiled matcher. Free with
+ *   nm_match_spec_device_free(). %NULL means no specs, which never match.
+ */
+NMMatchSpecDevice *
+nm_match_spec_device_compile (const GSList *specs)
+{
+	NMMatchSpecDevice *compiled;
+	const GSList *iter;
+
+	if (!specs)
+		return NULL;
+
+	compiled = g_slice_new0 (NMMatchSpecDevice);
+	for (iter = specs; iter; iter = iter->next) {
+		const char *spec_str = iter->data;
+		gboolean except;
+
+		if (!spec_str || !*spec_str)
+			continue;
+
+		spec_str = match_except (spec_str, &except);
+		if (except) {
+			compiled->has_except = TRUE;
+			_match_set_compile_one (&compiled->except, spec_str, FALSE);
+		} else {
+			compiled->has_not_except = TRUE;
+			_match_set_compile_one (&compiled->match, spec_str, TRUE);
+		}
+	}
+	return compiled;
+}
+
+void
+nm_match_spec_device_free (NMMatchSpecDevice *compiled)
+{
+	if (!compiled)
+		return;
+	_match_set_clear (&compiled->match);
+	_match_set_clear (&compiled->except);
+	g_slice_free (NMMatchSpecDevice, compiled);
+}
+
+NMMatchSpecMatchType
+nm_match_spec_device_compiled_match (const NMMatchSpecDevice *compiled,
+                                     const NMMatchSpecDeviceData *data)
+{
+	NMMatchSpecDeviceData data_norm;
+	guint8 hwaddr_buf[NM_UTILS_HWADDR_LEN_MAX + 1];
+	const guint8 *hwaddr_bin = NULL;
+	MatchCompiledS390 s390_buf;
+	const MatchCompiledS390 *s390 = NULL;
+	gboolean has_match = FALSE;
+	gboolean has_match_except = FALSE;
+
+	nm_assert (data);
+	nm_assert (!data->hwaddr || nm_utils_hwaddr_valid (data->hwaddr, -1));
+
+	if (!compiled)
+		return NM_MATCH_SPEC_NO_MATCH;
+
+	data_norm = (NMMatchSpecDeviceData) {
+		.interface_name   = data->interface_name,
+		.device_type      = nm_str_not_empty (data->device_type),
+		.driver           = nm_str_not_empty (data->driver),
+		.driver_version   = nm_str_not_empty (data->driver_version),
+		.dhcp_plugin      = nm_str_not_empty (data->dhcp_plugin),
+	};
+
+	if (   data->hwaddr
+	    && _match_hwaddr_aton (data->hwaddr, hwaddr_buf))
+		hwaddr_bin = hwaddr_buf;
+
+	if (   data->s390_subchannels
+	    && match_device_s390_subchannels_parse (data->s390_subchannels, &s390_buf.a, &s390_buf.b, &s390_buf.c))
+		s390 = &s390_buf;
+
+	if (compiled->has_not_except)
+		has_match = _match_set_eval (&compiled->match, &data_norm, hwaddr_bin, s390);
+	if (compiled->has_except)
+		has_match_except = _match_set_eval (&compiled->except, &data_norm, hwaddr_bin, s390);
+
+	return _match_result (compiled->has_except, compiled->has_not_except, has_match, has_match_except);
+}
+
 static gboolean
 match_config_eval (const char *str, const char *tag, guint cur_nm_version)
 {
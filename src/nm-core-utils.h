@@ -227,6 +227,23 @@ NMMatchSpecMatchType nm_match_spec_device (const GSList *specs,
                                            const char *hwaddr,
                                            const char *s390_subchannels,
                                            const char *dhcp_plugin);
+typedef struct {
+	const char *interface_name;
+	const char *device_type;
+	const char *driver;
+	const char *driver_version;
+	const char *hwaddr;
+	const char *s390_subchannels;
+	const char *dhcp_plugin;
+} NMMatchSpecDeviceData;
+
+typedef struct _NMMatchSpecDevice NMMatchSpecDevice;
+
+NMMatchSpecDevice *nm_match_spec_device_compile (const GSList *specs);
+void nm_match_spec_device_free (NMMatchSpecDevice *compiled);
+NMMatchSpecMatchType nm_match_spec_device_compiled_match (const NMMatchSpecDevice *compiled,
+                                                          const NMMatchSpecDeviceData *data);
+
 NMMatchSpecMatchType nm_match_spec_config (const GSList *specs,
                                            guint nm_version,
                                            const char *env);
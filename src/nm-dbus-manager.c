@@ -57,6 +57,9 @@ typedef struct {
 
 typedef struct {
 	GVariant *value;
+
+	/* whether a PropertiesChanged signal for this property is pending. */
+	bool pending_notify:1;
 } PropertyCacheData;
 
 typedef struct {
@@ -87,6 +90,17 @@ typedef struct {
 
 	CList private_servers_lst_head;
 
+	/* exported objects with pending PropertiesChanged notifications. */
+	CList pending_notify_lst_head;
+	guint pending_notify_idle_id;
+
+	/* number of method calls on exported objects that were not yet
+	 * replied to. While there are any, notifications are not deferred. */
+	guint method_calls_in_flight;
+
+	/* NMDBusInterfaceInfoExtended -> (property name -> property index + 1) */
+	GHashTable *property_idx_by_interface;
+
 	NMDBusManagerSetPropertyHandler set_property_handler;
 	gpointer set_property_handler_data;
 
@@ -97,6 +111,7 @@ typedef struct {
 	guint objmgr_registration_id;
 	bool started:1;
 	bool shutting_down:1;
+	bool pending_notify_flushing:1;
 } NMDBusManagerPrivate;
 
 struct _NMDBusManager {
@@ -126,6 +141,8 @@ static const GDBusSignalInfo signal_info_objmgr_interfaces_added;
 static const GDBusSignalInfo signal_info_objmgr_interfaces_removed;
 static GVariantBuilder *_obj_collect_properties_all (NMDBusObject *obj,
                                                      GVariantBuilder *builder);
+static void _pending_notify_flush (NMDBusManager *self);
+static void _obj_pending_notify_clear (NMDBusObject *obj);
 
 /*****************************************************************************/
 
@@ -857,6 +874,32 @@ _reg_data_get_interface_info (RegistrationData *reg_data)
 
 /*****************************************************************************/
 
+static void
+_method_call_done (gpointer user_data, GObject *where_the_object_was)
+{
+	gs_unref_object NMDBusManager *self = user_data;
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+
+	nm_assert (priv->method_calls_in_flight > 0);
+	priv->method_calls_in_flight--;
+}
+
+/* A method handler replies either right away or later, after it changed
+ * properties. The reply must not overtake the PropertiesChanged signals for
+ * changes that happened before it. Thus emit the pending notifications now, and
+ * don't defer notifications until the invocation is gone, which happens when
+ * the reply is sent. */
+static void
+_method_call_start (NMDBusManager *self, GDBusMethodInvocation *invocation)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+
+	_pending_notify_flush (self);
+
+	priv->method_calls_in_flight++;
+	g_object_weak_ref (G_OBJECT (invocation), _method_call_done, g_object_ref (self));
+}
+
 static void
 dbus_vtable_method_call (GDBusConnection *connection,
                          const char *sender,
@@ -909,6 +952,7 @@ dbus_vtable_method_call (GDBusConnection *connection,
 			return;
 		}
 
+		_method_call_start (self, invocation);
 		priv->set_property_handler (obj,
 		                            interface_info,
 		                            property_info,
@@ -944,6 +988,7 @@ dbus_vtable_method_call (GDBusConnection *connection,
 		return;
 	}
 
+	_method_call_start (self, invocation);
 	method_info->handle (reg_data->obj,
 	                     interface_info,
 	                     method_info,
@@ -1099,6 +1144,7 @@ _obj_register (NMDBusManager *self,
 	 *
 	 * In general, it's ok to export an object with frozen signals. But you better make sure
 	 * that all properties are in a self-consistent state when exporting the object. */
+	_pending_notify_flush (self);
 	g_dbus_connection_emit_signal (priv->main_dbus_connection,
 	                               NULL,
 	                               OBJECT_MANAGER_SERVER_BASE_PATH,
@@ -1223,6 +1269,13 @@ _nm_dbus_manager_obj_unexport (NMDBusObject *obj)
 	nm_assert (&obj->internal == g_hash_table_lookup (priv->objects_by_path, &obj->internal));
 	nm_assert (c_list_contains (&priv->objects_lst_head, &obj->internal.objects_lst));
 
+	if (priv->shutting_down) {
+		/* during shutdown, objects get unexported while being disposed. Don't
+		 * read their properties anymore. */
+		_obj_pending_notify_clear (obj);
+	}
+	_pending_notify_flush (self);
+
 	_obj_unregister (self, obj);
 
 	if (!g_hash_table_remove (priv->objects_by_path, &obj->internal))
@@ -1230,15 +1283,62 @@ _nm_dbus_manager_obj_unexport (NMDBusObject *obj)
 	c_list_unlink (&obj->internal.objects_lst);
 }
 
-void
-_nm_dbus_manager_obj_notify (NMDBusObject *obj,
-                             guint n_pspecs,
-                             const GParamSpec *const*pspecs)
+static guint
+_interface_info_lookup_property_idx (NMDBusManagerPrivate *priv,
+                                     const NMDBusInterfaceInfoExtended *interface_info,
+                                     const char *property_name)
+{
+	GHashTable *idx;
+	guint i;
+
+	if (G_UNLIKELY (!priv->property_idx_by_interface)) {
+		priv->property_idx_by_interface = g_hash_table_new_full (nm_direct_hash, NULL,
+		                                                         NULL, (GDestroyNotify) g_hash_table_unref);
+	}
+
+	idx = g_hash_table_lookup (priv->property_idx_by_interface, interface_info);
+	if (G_UNLIKELY (!idx)) {
+		idx = g_hash_table_new (nm_str_hash, g_str_equal);
+		for (i = 0; interface_info->parent.properties[i]; i++) {
+			const NMDBusPropertyInfoExtended *property_info = (const NMDBusPropertyInfoExtended *) interface_info->parent.properties[i];
+
+			g_hash_table_insert (idx, (gpointer) property_info->property_name, GUINT_TO_POINTER (i + 1));
+		}
+		g_hash_table_insert (priv->property_idx_by_interface, (gpointer) interface_info, idx);
+	}
+
+	/* returns the property index plus one, or zero if the interface has no such property. */
+	return GPOINTER_TO_UINT (g_hash_table_lookup (idx, property_name));
+}
+
+static void
+_obj_pending_notify_clear (NMDBusObject *obj)
 {
-	NMDBusManager *self;
-	NMDBusManagerPrivate *priv;
 	RegistrationData *reg_data;
-	guint i, p;
+	guint i;
+
+	if (c_list_is_empty (&obj->internal.pending_notify_lst))
+		return;
+
+	c_list_unlink (&obj->internal.pending_notify_lst);
+
+	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
+		const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info (reg_data);
+
+		if (!interface_info->parent.properties)
+			continue;
+		for (i = 0; interface_info->parent.properties[i]; i++)
+			reg_data->property_cache[i].pending_notify = FALSE;
+	}
+}
+
+static void
+_obj_emit_pending_notify (NMDBusManager *self,
+                          NMDBusObject *obj)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	RegistrationData *reg_data;
+	guint i;
 	gboolean any_legacy_signals = FALSE;
 	gboolean any_legacy_properties = FALSE;
 	GVariantBuilder legacy_builder;
@@ -1246,8 +1346,11 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 
 	nm_assert (NM_IS_DBUS_OBJECT (obj));
 	nm_assert (obj->internal.path);
-	nm_assert (NM_IS_DBUS_MANAGER (obj->internal.bus_manager));
+	nm_assert (obj->internal.bus_manager == self);
 	nm_assert (!c_list_is_empty (&obj->internal.objects_lst));
+	nm_assert (c_list_contains (&priv->pending_notify_lst_head, &obj->internal.pending_notify_lst));
+
+	c_list_unlink (&obj->internal.pending_notify_lst);
 
 	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
 		if (_reg_data_get_interface_info (reg_data)->legacy_property_changed) {
@@ -1256,16 +1359,8 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 		}
 	}
 
-	self = obj->internal.bus_manager;
-	priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
-
-	/* do a naive search for the matching NMDBusPropertyInfoExtended infos. Since the number of
-	 * (interfaces x properties) is static and possibly small, this naive search is effectively
-	 * O(1). We might wanna introduce some index to lookup the properties in question faster.
-	 *
-	 * The nice part of this implementation is however, that the order in which properties
-	 * are added to the GVariant is strictly defined to be the order in which the D-Bus property-info
-	 * is declared. Getting a defined ordering with some smart lookup would be hard. */
+	/* The order in which properties are added to the GVariant is strictly defined
+	 * to be the order in which the D-Bus property-info is declared. */
 	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
 		const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info (reg_data);
 		gboolean has_properties = FALSE;
@@ -1278,32 +1373,29 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 
 		for (i = 0; interface_info->parent.properties[i]; i++) {
 			const NMDBusPropertyInfoExtended *property_info = (const NMDBusPropertyInfoExtended *) interface_info->parent.properties[i];
+			gs_unref_variant GVariant *value = NULL;
 
-			for (p = 0; p < n_pspecs; p++) {
-				const GParamSpec *pspec = pspecs[p];
-				gs_unref_variant GVariant *value = NULL;
-
-				if (!nm_streq (property_info->property_name, pspec->name))
-					continue;
+			if (!reg_data->property_cache[i].pending_notify)
+				continue;
+			reg_data->property_cache[i].pending_notify = FALSE;
 
-				value = _obj_get_property (reg_data, i, TRUE);
+			value = _obj_get_property (reg_data, i, TRUE);
 
-				if (   property_info->include_in_legacy_property_changed
-				    && any_legacy_signals) {
-					/* also track the value in the legacy_builder to emit legacy signals below. */
-					if (!any_legacy_properties) {
-						any_legacy_properties = TRUE;
-						g_variant_builder_init (&legacy_builder, G_VARIANT_TYPE ("a{sv}"));
-					}
-					g_variant_builder_add (&legacy_builder, "{sv}", property_info->parent.name, value);
+			if (   property_info->include_in_legacy_property_changed
+			    && any_legacy_signals) {
+				/* also track the value in the legacy_builder to emit legacy signals below. */
+				if (!any_legacy_properties) {
+					any_legacy_properties = TRUE;
+					g_variant_builder_init (&legacy_builder, G_VARIANT_TYPE ("a{sv}"));
 				}
+				g_variant_builder_add (&legacy_builder, "{sv}", property_info->parent.name, value);
+			}
 
-				if (!has_properties) {
-					has_properties = TRUE;
-					g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
-				}
-				g_variant_builder_add (&builder, "{sv}", property_info->parent.name, value);
+			if (!has_properties) {
+				has_properties = TRUE;
+				g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
 			}
+			g_variant_builder_add (&builder, "{sv}", property_info->parent.name, value);
 		}
 
 		if (!has_properties)
@@ -1384,6 +1476,94 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 	}
 }
 
+static void
+_pending_notify_flush (NMDBusManager *self)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	NMDBusObject *obj;
+
+	/* emitting the signals reads the properties, which might notify
+	 * again. Loop until there is nothing left. */
+	if (priv->pending_notify_flushing)
+		return;
+	priv->pending_notify_flushing = TRUE;
+	while ((obj = c_list_first_entry (&priv->pending_notify_lst_head, NMDBusObject, internal.pending_notify_lst)))
+		_obj_emit_pending_notify (self, obj);
+	priv->pending_notify_flushing = FALSE;
+
+	nm_clear_g_source (&priv->pending_notify_idle_id);
+}
+
+static gboolean
+_pending_notify_idle_cb (gpointer user_data)
+{
+	NMDBusManager *self = user_data;
+
+	NM_DBUS_MANAGER_GET_PRIVATE (self)->pending_notify_idle_id = 0;
+	_pending_notify_flush (self);
+	return G_SOURCE_REMOVE;
+}
+
+void
+_nm_dbus_manager_obj_notify (NMDBusObject *obj,
+                             guint n_pspecs,
+                             const GParamSpec *const*pspecs)
+{
+	NMDBusManager *self;
+	NMDBusManagerPrivate *priv;
+	RegistrationData *reg_data;
+	gboolean any_pending = FALSE;
+	guint p;
+
+	nm_assert (NM_IS_DBUS_OBJECT (obj));
+	nm_assert (obj->internal.path);
+	nm_assert (NM_IS_DBUS_MANAGER (obj->internal.bus_manager));
+	nm_assert (!c_list_is_empty (&obj->internal.objects_lst));
+
+	self = obj->internal.bus_manager;
+	priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+
+	/* Only mark the properties as changed. The PropertiesChanged signals are emitted
+	 * once per object and interface, on idle, or before the next other signal or
+	 * method reply is sent (so that the order of messages is preserved). */
+	c_list_for_each_entry (reg_data, &obj->internal.registration_lst_head, registration_lst) {
+		const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info (reg_data);
+
+		if (!interface_info->parent.properties)
+			continue;
+
+		for (p = 0; p < n_pspecs; p++) {
+			guint idx;
+
+			idx = _interface_info_lookup_property_idx (priv, interface_info, pspecs[p]->name);
+			if (idx == 0)
+				continue;
+			idx--;
+
+			/* drop the cached value right away, so that a Get call does not
+			 * return the stale value while the notification is pending. */
+			nm_clear_g_variant (&reg_data->property_cache[idx].value);
+			reg_data->property_cache[idx].pending_notify = TRUE;
+			any_pending = TRUE;
+		}
+	}
+
+	if (!any_pending)
+		return;
+
+	if (c_list_is_empty (&obj->internal.pending_notify_lst))
+		c_list_link_tail (&priv->pending_notify_lst_head, &obj->internal.pending_notify_lst);
+
+	if (priv->method_calls_in_flight > 0) {
+		/* a reply is still outstanding. See _method_call_start(). */
+		_pending_notify_flush (self);
+		return;
+	}
+
+	if (!priv->pending_notify_idle_id)
+		priv->pending_notify_idle_id = g_idle_add_full (G_PRIORITY_HIGH, _pending_notify_idle_cb, self, NULL);
+}
+
 void
 _nm_dbus_manager_obj_emit_signal (NMDBusObject *obj,
                                   const NMDBusInterfaceInfoExtended *interface_info,
@@ -1406,6 +1586,10 @@ _nm_dbus_manager_obj_emit_signal (NMDBusObject *obj,
 		return;
 	}
 
+	/* preserve the ordering of signals with respect to the coalesced
+	 * PropertiesChanged notifications. */
+	_pending_notify_flush (self);
+
 	g_dbus_connection_emit_signal (priv->main_dbus_connection,
 	                               NULL,
 	                               obj->internal.path,
@@ -1667,6 +1851,8 @@ nm_dbus_manager_stop (NMDBusManager *self)
 
 	priv->shutting_down = TRUE;
 
+	_pending_notify_flush (self);
+
 	/* during shutdown we also clear the set-property-handler. It's no longer
 	 * possible to set a property, because doing so would require authorization,
 	 * which is async, which is just complicated to get right. No more property
@@ -1690,6 +1876,7 @@ nm_dbus_manager_init (NMDBusManager *self)
 
 	c_list_init (&priv->private_servers_lst_head);
 	c_list_init (&priv->objects_lst_head);
+	c_list_init (&priv->pending_notify_lst_head);
 	priv->objects_by_path = g_hash_table_new ((GHashFunc) _objects_by_path_hash, (GEqualFunc) _objects_by_path_equal);
 
 	c_list_init (&priv->caller_info_lst_head);
@@ -1710,6 +1897,10 @@ dispose (GObject *object)
 
 	g_clear_pointer (&priv->objects_by_path, g_hash_table_destroy);
 
+	nm_assert (c_list_is_empty (&priv->pending_notify_lst_head));
+	nm_clear_g_source (&priv->pending_notify_idle_id);
+	g_clear_pointer (&priv->property_idx_by_interface, g_hash_table_destroy);
+
 	c_list_for_each_entry_safe (s, s_safe, &priv->private_servers_lst_head, private_servers_lst)
 		private_server_free (s);
 
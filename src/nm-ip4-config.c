@@ -810,6 +810,12 @@ nm_ip4_config_commit (const NMIP4Config *self,
 	routes = nm_dedup_multi_objs_to_ptr_array_head (nm_ip4_config_lookup_routes (self),
 	                                                NULL, NULL);
 
+	/* the prune list is based on the cache. If we know that it is out of
+	 * date for this interface, request its routes first. On failure, we
+	 * still sync with what we have. */
+	if (nm_platform_ip_route_refresh_pending (platform, AF_INET, ifindex))
+		nm_platform_ip_route_refresh (platform, AF_INET, ifindex);
+
 	routes_prune = nm_platform_ip_route_get_prune_list (platform,
 	                                                    AF_INET,
 	                                                    ifindex,
@@ -438,6 +438,18 @@ nm_ip_config_reset_routes (NMIPConfig *self)
 	_NM_IP_CONFIG_DISPATCH_VOID (self, nm_ip4_config_reset_routes, nm_ip6_config_reset_routes);
 }
 
+static inline const NMPObject *
+nm_ip_config_nmpobj_lookup (const NMIPConfig *self, const NMPObject *needle)
+{
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_nmpobj_lookup, nm_ip6_config_nmpobj_lookup, needle);
+}
+
+static inline gboolean
+nm_ip_config_nmpobj_remove (NMIPConfig *self, const NMPObject *needle)
+{
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_nmpobj_remove, nm_ip6_config_nmpobj_remove, needle);
+}
+
 static inline int
 nm_ip_config_get_dns_priority (const NMIPConfig *self)
 {
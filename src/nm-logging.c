@@ -39,6 +39,7 @@
 
 #include "nm-glib-aux/nm-time-utils.h"
 #include "nm-errors.h"
+#include "c-list/src/c-list.h"
 
 /*****************************************************************************/
 
@@ -116,6 +117,14 @@ typedef struct {
 	bool init_pre_done:1;
 	bool init_done:1;
 	bool debug_stderr:1;
+
+	/* messages are written by a separate writer thread. */
+	bool log_async:1;
+
+	/* the domains that are enabled for all levels, only to be kept
+	 * in the flight recorder (but not logged). */
+	NMLogDomain recorder_domains;
+
 	const char *prefix;
 	const char *syslog_identifier;
 
@@ -162,6 +171,64 @@ NMLogDomain _nm_logging_enabled_state[_LOGL_N_REAL] = {
 	[LOGL_ERR]  = LOGD_DEFAULT,
 };
 
+/* The domains that are actually written to the logging backend. This is
+ * the same as _nm_logging_enabled_state, unless the flight recorder is
+ * enabled. Then, _nm_logging_enabled_state contains also the recorded
+ * domains. Protected by the "log" lock, like _nm_logging_enabled_state. */
+static NMLogDomain _nm_logging_output_state[_LOGL_N_REAL] = {
+	[LOGL_INFO] = LOGD_DEFAULT,
+	[LOGL_WARN] = LOGD_DEFAULT,
+	[LOGL_ERR]  = LOGD_DEFAULT,
+};
+
+/*****************************************************************************/
+
+typedef struct {
+	CList lst;
+	const char *file;
+	const char *func;
+	const char *ifname;
+	const char *conn_uuid;
+	char *msg;
+	GTimeVal tv;
+	gint64 now_ns;
+	NMLogDomain domain;
+	NMLogDomain domain_enabled;
+	NMLogLevel level;
+	guint line;
+	int error;
+	gsize size;
+} LogEntry;
+
+/* When writing asynchronously, the writer thread consumes the queue. If
+ * the queue grows above this size, the least important messages get dropped
+ * rather than blocking the caller. */
+#define ASYNC_QUEUE_MAX_LEN 50000
+
+static struct {
+	GMutex lock;
+	GCond cond_queued;
+	GCond cond_written;
+	CList queue_lst_head;
+	guint queue_len;
+	guint num_dropped;
+	guint64 num_queued;
+	guint64 num_written;
+	bool writer_idle;
+} gl_async = {
+	.queue_lst_head = C_LIST_INIT (gl_async.queue_lst_head),
+};
+
+G_LOCK_DEFINE_STATIC (recorder);
+
+static struct {
+	CList lst_head;
+	gsize size;
+	gsize max_size;
+} gl_recorder = {
+	.lst_head = C_LIST_INIT (gl_recorder.lst_head),
+};
+
 /*****************************************************************************/
 
 static const LogLevelDesc level_desc[_LOGL_N] = {
@@ -314,7 +381,7 @@ nm_logging_setup (const char  *level,
 	g_return_val_if_fail (!error || !*error, FALSE);
 
 	cur_log_level = gl.imm.log_level;
-	memcpy (cur_log_state, _nm_logging_enabled_state, sizeof (cur_log_state));
+	memcpy (cur_log_state, _nm_logging_output_state, sizeof (cur_log_state));
 
 	new_log_level = cur_log_level;
 
@@ -434,8 +501,10 @@ nm_logging_setup (const char  *level,
 	G_LOCK (log);
 
 	gl.mut.log_level = new_log_level;
-	for (i = 0; i < G_N_ELEMENTS (new_log_state); i++)
-		_nm_logging_enabled_state[i] = new_log_state[i];
+	for (i = 0; i < G_N_ELEMENTS (new_log_state); i++) {
+		_nm_logging_output_state[i] = new_log_state[i];
+		_nm_logging_enabled_state[i] = new_log_state[i] | gl.imm.recorder_domains;
+	}
 
 	G_UNLOCK (log);
 
@@ -488,7 +557,7 @@ nm_logging_domains_to_string (void)
 	if (G_UNLIKELY (!gl_main.logging_domains_to_string)) {
 		gl_main.logging_domains_to_string = _domains_to_string (TRUE,
 		                                                        gl.imm.log_level,
-		                                                        _nm_logging_enabled_state);
+		                                                        _nm_logging_output_state);
 	}
 
 	return gl_main.logging_domains_to_string;
@@ -577,13 +646,39 @@ nm_logging_get_level (NMLogDomain domain)
 {
 	NMLogLevel sl = _LOGL_OFF;
 
+	NM_ASSERT_ON_MAIN_THREAD ();
+
 	G_STATIC_ASSERT (LOGL_TRACE == 0);
 	while (   sl > LOGL_TRACE
-	       && _nm_logging_enabled_lockfree (sl - 1, domain))
+	       && NM_FLAGS_ANY (_nm_logging_output_state[sl - 1], domain))
 		sl--;
 	return sl;
 }
 
+/**
+ * nm_logging_output_enabled:
+ * @level: the logging level
+ * @domain: the logging domain(s)
+ *
+ * Unlike nm_logging_enabled(), this ignores domains that are only
+ * enabled for the flight recorder. Use it where the logging level
+ * changes behavior (like passing debug flags to child processes),
+ * as opposed to merely gating log messages.
+ *
+ * Returns: whether messages for @level and @domain are sent to
+ *   the logging backend.
+ **/
+gboolean
+nm_logging_output_enabled (NMLogLevel level, NMLogDomain domain)
+{
+	NM_ASSERT_ON_MAIN_THREAD ();
+
+	nm_assert (((guint) level) < G_N_ELEMENTS (_nm_logging_output_state));
+
+	return    ((guint) level) < G_N_ELEMENTS (_nm_logging_output_state)
+	       && !!(_nm_logging_output_state[level] & domain);
+}
+
 gboolean
 _nm_logging_enabled_locking (NMLogLevel level,
                              NMLogDomain domain)
@@ -660,77 +755,20 @@ _iovec_set_format (struct iovec *iov, gpointer *iov_free, const char *format, ..
 
 #endif
 
-void
-_nm_log_impl (const char *file,
-              guint line,
-              const char *func,
-              gboolean mt_require_locking,
-              NMLogLevel level,
-              NMLogDomain domain,
-              int error,
-              const char *ifname,
-              const char *conn_uuid,
-              const char *fmt,
-              ...)
-{
-	va_list args;
-	char *msg;
-	GTimeVal tv;
-	int errsv;
-	const NMLogDomain *cur_log_state;
-	NMLogDomain cur_log_state_copy[_LOGL_N_REAL];
-	Global g_copy;
-	const Global *g;
+#define MESSAGE_FMT "%s%s%-7s [%ld.%04ld] %s"
+#define MESSAGE_ARG(prefix, marker, entry) \
+    (prefix), \
+    (marker), \
+    level_desc[(entry)->level].level_str, \
+    (entry)->tv.tv_sec, \
+    ((entry)->tv.tv_usec / 100), \
+    (entry)->msg
 
-	if (G_UNLIKELY (mt_require_locking)) {
-		G_LOCK (log);
-		/* we evaluate logging-enabled under lock. There is still a race that
-		 * we might log the message below *after* logging was disabled. That means,
-		 * when disabling logging, we might still log messages. */
-		if (!_nm_logging_enabled_lockfree (level, domain)) {
-			G_UNLOCK (log);
-			return;
-		}
-		g_copy = gl.imm;
-		memcpy (cur_log_state_copy, _nm_logging_enabled_state, sizeof (cur_log_state_copy));
-		G_UNLOCK (log);
-		g = &g_copy;
-		cur_log_state = cur_log_state_copy;
-	} else {
-		NM_ASSERT_ON_MAIN_THREAD ();
-		if (!_nm_logging_enabled_lockfree (level, domain))
-			return;
-		g = &gl.imm;
-		cur_log_state = _nm_logging_enabled_state;
-	}
-
-	(void) cur_log_state;
-
-	errsv = errno;
-
-	/* Make sure that %m maps to the specified error */
-	if (error != 0) {
-		if (error < 0)
-			error = -error;
-		errno = error;
-	}
-
-	va_start (args, fmt);
-	msg = g_strdup_vprintf (fmt, args);
-	va_end (args);
-
-#define MESSAGE_FMT "%s%-7s [%ld.%04ld] %s"
-#define MESSAGE_ARG(prefix, tv, msg) \
-    prefix, \
-    level_desc[level].level_str, \
-    (tv).tv_sec, \
-    ((tv).tv_usec / 100), \
-    (msg)
-
-	g_get_current_time (&tv);
-
-	if (g->debug_stderr)
-		g_printerr (MESSAGE_FMT"\n", MESSAGE_ARG (g->prefix, tv, msg));
+static void
+_log_entry_write (const Global *g, const LogEntry *entry, gboolean recorded)
+{
+	const char *marker = recorded ? "[recorded] " : "";
+	const NMLogLevel level = entry->level;
 
 	switch (g->log_backend) {
 #if SYSTEMD_JOURNAL
@@ -738,25 +776,25 @@ _nm_log_impl (const char *file,
 		{
 			gint64 now, boottime;
 #define _NUM_MAX_FIELDS_SYSLOG_FACILITY 10
-			struct iovec iov_data[12 + _NUM_MAX_FIELDS_SYSLOG_FACILITY];
+			struct iovec iov_data[13 + _NUM_MAX_FIELDS_SYSLOG_FACILITY];
 			struct iovec *iov = iov_data;
 			gpointer iov_free_data[5];
 			gpointer *iov_free = iov_free_data;
 			nm_auto_free_gstring GString *s_domain_all = NULL;
 
-			now = nm_utils_get_monotonic_timestamp_ns ();
+			now = entry->now_ns;
 			boottime = nm_utils_monotonic_timestamp_as_boottime (now, 1);
 
 			_iovec_set_format_a (iov++, 30, "PRIORITY=%d", level_desc[level].syslog_level);
-			_iovec_set_format (iov++, iov_free++, "MESSAGE="MESSAGE_FMT, MESSAGE_ARG (g->prefix, tv, msg));
+			_iovec_set_format (iov++, iov_free++, "MESSAGE="MESSAGE_FMT, MESSAGE_ARG (g->prefix, marker, entry));
 			_iovec_set_string (iov++, syslog_identifier_full (g->syslog_identifier));
 			_iovec_set_format_a (iov++, 30, "SYSLOG_PID=%ld", (long) getpid ());
 			{
 				const LogDesc *diter;
 				int i_domain = _NUM_MAX_FIELDS_SYSLOG_FACILITY;
 				const char *s_domain_1 = NULL;
-				NMLogDomain dom_all = domain;
-				NMLogDomain dom = dom_all & cur_log_state[level];
+				NMLogDomain dom_all = entry->domain;
+				NMLogDomain dom = entry->domain_enabled;
 
 				for (diter = &domain_desc[0]; diter->name; diter++) {
 					if (!NM_FLAGS_ANY (dom_all, diter->num))
@@ -794,18 +832,20 @@ _nm_log_impl (const char *file,
 					_iovec_set_format_str_a (iov++, 30, "NM_LOG_DOMAINS=%s", s_domain_1);
 			}
 			_iovec_set_format_str_a (iov++, 15, "NM_LOG_LEVEL=%s", level_desc[level].name);
-			if (func)
-				_iovec_set_format (iov++, iov_free++, "CODE_FUNC=%s", func);
-			_iovec_set_format (iov++, iov_free++, "CODE_FILE=%s", file ?: "");
-			_iovec_set_format_a (iov++, 20, "CODE_LINE=%u", line);
+			if (recorded)
+				_iovec_set_string (iov++, "NM_LOG_RECORDED=1");
+			if (entry->func)
+				_iovec_set_format (iov++, iov_free++, "CODE_FUNC=%s", entry->func);
+			_iovec_set_format (iov++, iov_free++, "CODE_FILE=%s", entry->file ?: "");
+			_iovec_set_format_a (iov++, 20, "CODE_LINE=%u", entry->line);
 			_iovec_set_format_a (iov++, 60, "TIMESTAMP_MONOTONIC=%lld.%06lld", (long long) (now / NM_UTILS_NS_PER_SECOND), (long long) ((now % NM_UTILS_NS_PER_SECOND) / 1000));
 			_iovec_set_format_a (iov++, 60, "TIMESTAMP_BOOTTIME=%lld.%06lld", (long long) (boottime / NM_UTILS_NS_PER_SECOND), (long long) ((boottime % NM_UTILS_NS_PER_SECOND) / 1000));
-			if (error != 0)
-				_iovec_set_format_a (iov++, 30, "ERRNO=%d", error);
-			if (ifname)
-				_iovec_set_format (iov++, iov_free++, "NM_DEVICE=%s", ifname);
-			if (conn_uuid)
-				_iovec_set_format (iov++, iov_free++, "NM_CONNECTION=%s", conn_uuid);
+			if (entry->error != 0)
+				_iovec_set_format_a (iov++, 30, "ERRNO=%d", entry->error);
+			if (entry->ifname)
+				_iovec_set_format (iov++, iov_free++, "NM_DEVICE=%s", entry->ifname);
+			if (entry->conn_uuid)
+				_iovec_set_format (iov++, iov_free++, "NM_CONNECTION=%s", entry->conn_uuid);
 
 			nm_assert (iov <= &iov_data[G_N_ELEMENTS (iov_data)]);
 			nm_assert (iov_free <= &iov_free_data[G_N_ELEMENTS (iov_free_data)]);
@@ -819,15 +859,306 @@ _nm_log_impl (const char *file,
 #endif
 	case LOG_BACKEND_SYSLOG:
 		syslog (level_desc[level].syslog_level,
-		        MESSAGE_FMT, MESSAGE_ARG (g->prefix, tv, msg));
+		        MESSAGE_FMT, MESSAGE_ARG (g->prefix, marker, entry));
 		break;
 	default:
 		g_log (syslog_identifier_domain (g->syslog_identifier), level_desc[level].g_log_level,
-		       MESSAGE_FMT, MESSAGE_ARG (g->prefix, tv, msg));
+		       MESSAGE_FMT, MESSAGE_ARG (g->prefix, marker, entry));
 		break;
 	}
+}
+
+/* Creates a heap copy of @src, which takes ownership of @src's message. */
+static LogEntry *
+_log_entry_steal (LogEntry *src)
+{
+	gsize l_ifname = src->ifname ? strlen (src->ifname) + 1 : 0;
+	gsize l_conn_uuid = src->conn_uuid ? strlen (src->conn_uuid) + 1 : 0;
+	LogEntry *entry;
+	char *buf;
+
+	entry = g_malloc (sizeof (LogEntry) + l_ifname + l_conn_uuid);
+	*entry = *src;
+	c_list_init (&entry->lst);
+	buf = (char *) &entry[1];
+	if (src->ifname) {
+		entry->ifname = memcpy (buf, src->ifname, l_ifname);
+		buf += l_ifname;
+	}
+	if (src->conn_uuid)
+		entry->conn_uuid = memcpy (buf, src->conn_uuid, l_conn_uuid);
+	entry->size = sizeof (LogEntry) + l_ifname + l_conn_uuid + strlen (src->msg) + 1;
+	src->msg = NULL;
+	return entry;
+}
+
+static void
+_log_entry_free (LogEntry *entry)
+{
+	c_list_unlink (&entry->lst);
+	g_free (entry->msg);
+	g_free (entry);
+}
+
+/*****************************************************************************/
+
+static gpointer
+_async_writer_thread (gpointer user_data)
+{
+	for (;;) {
+		CList lst_head = C_LIST_INIT (lst_head);
+		LogEntry *entry, *entry_safe;
+		guint num_dropped;
+		guint n;
+
+		g_mutex_lock (&gl_async.lock);
+		while (c_list_is_empty (&gl_async.queue_lst_head)) {
+			gl_async.writer_idle = TRUE;
+			g_cond_wait (&gl_async.cond_queued, &gl_async.lock);
+		}
+		gl_async.writer_idle = FALSE;
+		c_list_splice (&lst_head, &gl_async.queue_lst_head);
+		n = gl_async.queue_len;
+		gl_async.queue_len = 0;
+		num_dropped = nm_steal_int (&gl_async.num_dropped);
+		g_mutex_unlock (&gl_async.lock);
+
+		/* the global data is not modified after nm_logging_init()
+		 * and nm_logging_init_async(), no locking needed. */
+
+		if (num_dropped > 0) {
+			gs_free char *msg = g_strdup_printf ("logging: dropped %u messages because the writer is too slow", num_dropped);
+			LogEntry dropped = {
+				.file   = __FILE__,
+				.func   = G_STRFUNC,
+				.line   = __LINE__,
+				.msg    = msg,
+				.level  = LOGL_WARN,
+				.domain = LOGD_CORE,
+				.domain_enabled = LOGD_CORE,
+				.now_ns = nm_utils_get_monotonic_timestamp_ns (),
+			};
+
+			g_get_current_time (&dropped.tv);
+			_log_entry_write (&gl.imm, &dropped, FALSE);
+		}
+
+		c_list_for_each_entry_safe (entry, entry_safe, &lst_head, lst) {
+			_log_entry_write (&gl.imm, entry, FALSE);
+			_log_entry_free (entry);
+		}
+
+		g_mutex_lock (&gl_async.lock);
+		gl_async.num_written += n;
+		g_cond_broadcast (&gl_async.cond_written);
+		g_mutex_unlock (&gl_async.lock);
+	}
+	return NULL;
+}
+
+static void
+_async_wait_written (guint64 num_queued)
+{
+	g_mutex_lock (&gl_async.lock);
+	while (gl_async.num_written < num_queued)
+		g_cond_wait (&gl_async.cond_written, &gl_async.lock);
+	g_mutex_unlock (&gl_async.lock);
+}
+
+static void
+_async_flush (void)
+{
+	guint64 num_queued;
+
+	g_mutex_lock (&gl_async.lock);
+	num_queued = gl_async.num_queued;
+	g_mutex_unlock (&gl_async.lock);
+	_async_wait_written (num_queued);
+}
+
+static void
+_async_enqueue (LogEntry *entry)
+{
+	gboolean wait;
+	guint64 num_queued = 0;
+
+	/* warnings and errors are important. Don't drop them, and
+	 * wait until they are written, so that they are not lost if we
+	 * crash right after. */
+	wait = entry->level >= LOGL_WARN;
+
+	g_mutex_lock (&gl_async.lock);
+	if (   !wait
+	    && gl_async.queue_len >= ASYNC_QUEUE_MAX_LEN) {
+		gl_async.num_dropped++;
+		g_mutex_unlock (&gl_async.lock);
+		_log_entry_free (entry);
+		return;
+	}
+	c_list_link_tail (&gl_async.queue_lst_head, &entry->lst);
+	gl_async.queue_len++;
+	num_queued = ++gl_async.num_queued;
+	if (gl_async.writer_idle) {
+		gl_async.writer_idle = FALSE;
+		g_cond_signal (&gl_async.cond_queued);
+	}
+	g_mutex_unlock (&gl_async.lock);
+
+	if (wait)
+		_async_wait_written (num_queued);
+}
+
+/*****************************************************************************/
+
+static void
+_recorder_add (LogEntry *entry)
+{
+	LogEntry *old;
+
+	G_LOCK (recorder);
+	c_list_link_tail (&gl_recorder.lst_head, &entry->lst);
+	gl_recorder.size += entry->size;
+	while (gl_recorder.size > gl_recorder.max_size) {
+		old = c_list_first_entry (&gl_recorder.lst_head, LogEntry, lst);
+		gl_recorder.size -= old->size;
+		_log_entry_free (old);
+	}
+	G_UNLOCK (recorder);
+}
+
+/**
+ * nm_logging_flight_recorder_dump:
+ *
+ * Writes all messages that were kept by the flight recorder to
+ * the logging backend, and clears the recorder.
+ */
+void
+nm_logging_flight_recorder_dump (void)
+{
+	CList lst_head = C_LIST_INIT (lst_head);
+	LogEntry *entry, *entry_safe;
+	gsize size;
+	guint n;
 
-	g_free (msg);
+	NM_ASSERT_ON_MAIN_THREAD ();
+
+	if (!gl.imm.recorder_domains)
+		return;
+
+	G_LOCK (recorder);
+	c_list_splice (&lst_head, &gl_recorder.lst_head);
+	size = nm_steal_int (&gl_recorder.size);
+	G_UNLOCK (recorder);
+
+	n = c_list_length (&lst_head);
+	nm_log_info (LOGD_CORE, "logging: dump %u messages (%zu bytes) from the flight recorder", n, size);
+
+	/* the recorded messages are written synchronously. Ensure that the
+	 * pending messages of the writer thread are written first. */
+	if (gl.imm.log_async)
+		_async_flush ();
+
+	c_list_for_each_entry_safe (entry, entry_safe, &lst_head, lst) {
+		_log_entry_write (&gl.imm, entry, TRUE);
+		_log_entry_free (entry);
+	}
+
+	nm_log_info (LOGD_CORE, "logging: flight recorder dump complete");
+}
+
+/*****************************************************************************/
+
+void
+_nm_log_impl (const char *file,
+              guint line,
+              const char *func,
+              gboolean mt_require_locking,
+              NMLogLevel level,
+              NMLogDomain domain,
+              int error,
+              const char *ifname,
+              const char *conn_uuid,
+              const char *fmt,
+              ...)
+{
+	va_list args;
+	int errsv;
+	NMLogDomain domain_enabled;
+	Global g_copy;
+	const Global *g;
+	LogEntry entry;
+
+	if (G_UNLIKELY (mt_require_locking)) {
+		G_LOCK (log);
+		/* we evaluate logging-enabled under lock. There is still a race that
+		 * we might log the message below *after* logging was disabled. That means,
+		 * when disabling logging, we might still log messages. */
+		if (!_nm_logging_enabled_lockfree (level, domain)) {
+			G_UNLOCK (log);
+			return;
+		}
+		g_copy = gl.imm;
+		domain_enabled = domain & _nm_logging_output_state[level];
+		G_UNLOCK (log);
+		g = &g_copy;
+	} else {
+		NM_ASSERT_ON_MAIN_THREAD ();
+		if (!_nm_logging_enabled_lockfree (level, domain))
+			return;
+		g = &gl.imm;
+		domain_enabled = domain & _nm_logging_output_state[level];
+	}
+
+	errsv = errno;
+
+	/* Make sure that %m maps to the specified error */
+	if (error != 0) {
+		if (error < 0)
+			error = -error;
+		errno = error;
+	}
+
+	entry = (LogEntry) {
+		.file           = file,
+		.func           = func,
+		.line           = line,
+		.ifname         = ifname,
+		.conn_uuid      = conn_uuid,
+		.level          = level,
+		.domain         = domain,
+		.domain_enabled = domain_enabled,
+		.error          = error,
+	};
+
+	va_start (args, fmt);
+	entry.msg = g_strdup_vprintf (fmt, args);
+	va_end (args);
+
+	g_get_current_time (&entry.tv);
+
+	if (   !domain_enabled
+	    || g->log_async
+	    || g->log_backend == LOG_BACKEND_JOURNAL)
+		entry.now_ns = nm_utils_get_monotonic_timestamp_ns ();
+
+	if (!domain_enabled) {
+		/* the message is only enabled for the flight recorder. Keep it
+		 * in memory, the rest of the formatting happens when (and if) the
+		 * recorder gets dumped. */
+		_recorder_add (_log_entry_steal (&entry));
+		errno = errsv;
+		return;
+	}
+
+	if (g->debug_stderr)
+		g_printerr (MESSAGE_FMT"\n", MESSAGE_ARG (g->prefix, "", &entry));
+
+	if (g->log_async)
+		_async_enqueue (_log_entry_steal (&entry));
+	else {
+		_log_entry_write (g, &entry, FALSE);
+		g_free (entry.msg);
+	}
 
 	errno = errsv;
 }
@@ -1054,3 +1385,62 @@ nm_logging_init (const char *logging_backend, gboolean debug)
 		             );
 	}
 }
+
+/**
+ * nm_logging_init_async:
+ * @async: whether to write messages from a separate thread.
+ * @flight_recorder_size: if non-zero, keep up to this many bytes of
+ *   messages of all domains and levels in memory, that are otherwise not
+ *   logged. They are written by nm_logging_flight_recorder_dump().
+ *
+ * Must be called at most once, on the main thread, after nm_logging_init().
+ */
+void
+nm_logging_init_async (gboolean async, gsize flight_recorder_size)
+{
+	int i;
+
+	NM_ASSERT_ON_MAIN_THREAD ();
+
+	if (!gl.imm.init_done)
+		g_return_if_reached ();
+
+	if (   gl.imm.log_async
+	    || gl.imm.recorder_domains)
+		g_return_if_reached ();
+
+	if (!async && !flight_recorder_size)
+		return;
+
+	/* make sure the monotonic timestamp is initialized. Reading it
+	 * the first time causes a logging message, which we must not do during
+	 * _nm_log_impl(). */
+	nm_utils_get_monotonic_timestamp_ns ();
+
+	if (async) {
+		g_thread_unref (g_thread_new ("nm-log-writer", _async_writer_thread, NULL));
+		atexit (_async_flush);
+	}
+
+	if (flight_recorder_size) {
+		G_LOCK (recorder);
+		gl_recorder.max_size = flight_recorder_size;
+		G_UNLOCK (recorder);
+	}
+
+	G_LOCK (log);
+	gl.mut.log_async = async;
+	if (flight_recorder_size) {
+		/* LOGD_VPN_PLUGIN is protected, because the messages
+		 * may contain sensitive data. */
+		gl.mut.recorder_domains = LOGD_ALL & ~LOGD_VPN_PLUGIN;
+		for (i = 0; i < G_N_ELEMENTS (_nm_logging_enabled_state); i++)
+			_nm_logging_enabled_state[i] = _nm_logging_output_state[i] | gl.imm.recorder_domains;
+	}
+	G_UNLOCK (log);
+
+	if (flight_recorder_size) {
+		nm_log_info (LOGD_CORE, "logging: flight recorder keeps up to %zu bytes of messages. Send SIGUSR2 to dump them",
+		             flight_recorder_size);
+	}
+}
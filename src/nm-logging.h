@@ -186,8 +186,11 @@ void nm_logging_init_pre (const char *syslog_identifier,
                           char *prefix_take);
 
 void     nm_logging_init (const char *logging_backend, gboolean debug);
+void     nm_logging_init_async (gboolean async, gsize flight_recorder_size);
+void     nm_logging_flight_recorder_dump (void);
 
 gboolean nm_logging_syslog_enabled (void);
+gboolean nm_logging_output_enabled (NMLogLevel level, NMLogDomain domain);
 
 /*****************************************************************************/
 
@@ -1095,6 +1095,72 @@ nm_manager_get_activatable_connections (NMManager *manager,
 	                                          NULL);
 }
 
+/**
+ * nm_manager_get_autoconnect_candidates:
+ * @manager: the #NMManager
+ * @device: the device to autoconnect
+ * @out_len: (allow-none): the number of returned connections
+ *
+ * Like nm_manager_get_activatable_connections() for auto activation,
+ * with sorting. But it only returns the profiles that could plausibly
+ * be compatible with @device: if the device supports only one connection
+ * type, only profiles of that type are considered (they are kept sorted
+ * by NMSettings). Profiles for physical devices that are locked to a different
+ * interface name are skipped too.
+ * The caller still must check nm_device_can_auto_connect().
+ *
+ * Returns: (transfer container): a %NULL terminated array of connections.
+ */
+NMSettingsConnection **
+nm_manager_get_autoconnect_candidates (NMManager *manager,
+                                       NMDevice *device,
+                                       guint *out_len)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+	const GetActivatableConnectionsFilterData d = {
+		.self = manager,
+		.for_auto_activation = TRUE,
+	};
+	NMSettingsConnection *const*sorted;
+	NMSettingsConnection **list;
+	const char *connection_type;
+	const char *device_iface;
+	guint i, j, len;
+
+	connection_type = nm_device_get_connection_type_check_compatible (device);
+	if (!connection_type)
+		return nm_manager_get_activatable_connections (manager, TRUE, TRUE, out_len);
+
+	sorted = nm_settings_get_connections_sorted_by_autoconnect_priority (priv->settings,
+	                                                                     connection_type,
+	                                                                     &len);
+	device_iface = nm_device_get_iface (device);
+
+	list = g_new (NMSettingsConnection *, (gsize) len + 1);
+	for (i = 0, j = 0; i < len; i++) {
+		NMSettingsConnection *sett_conn = sorted[i];
+		NMConnection *connection = nm_settings_connection_get_connection (sett_conn);
+		const char *iface;
+
+		/* For physical devices, the interface name of the profile must match
+		 * exactly (see check_connection_compatible()). This is cheap to check
+		 * and avoids the full compatibility check for locked profiles. */
+		iface = nm_connection_get_interface_name (connection);
+		if (   iface
+		    && !nm_streq0 (iface, device_iface)
+		    && !nm_connection_is_virtual (connection))
+			continue;
+
+		if (!_get_activatable_connections_filter (priv->settings, sett_conn, (gpointer) &d))
+			continue;
+
+		list[j++] = sett_conn;
+	}
+	list[j] = NULL;
+	NM_SET_OUT (out_len, j);
+	return list;
+}
+
 static NMActiveConnection *
 active_connection_get_by_path (NMManager *self, const char *path)
 {
@@ -6702,6 +6768,9 @@ nm_manager_stop (NMManager *self)
 	_active_connection_cleanup (self);
 
 	nm_clear_g_source (&priv->devices_inited_id);
+
+	/* write out pending timestamps and seen-bssids. */
+	nm_settings_connection_flush_state_dbs ();
 }
 
 static gboolean
@@ -115,6 +115,10 @@ NMSettingsConnection **nm_manager_get_activatable_connections (NMManager *manage
                                                                gboolean sort,
                                                                guint *out_len);
 
+NMSettingsConnection **nm_manager_get_autoconnect_candidates (NMManager *manager,
+                                                              NMDevice *device,
+                                                              guint *out_len);
+
 void          nm_manager_write_device_state_all (NMManager *manager);
 gboolean      nm_manager_write_device_state (NMManager *manager, NMDevice *device);
 
@@ -1258,7 +1258,7 @@ auto_activate_device (NMPolicy *self,
 	if (!nm_device_autoconnect_allowed (device))
 		return;
 
-	connections = nm_manager_get_activatable_connections (priv->manager, TRUE, TRUE, &len);
+	connections = nm_manager_get_autoconnect_candidates (priv->manager, device, &len);
 	if (!connections[0])
 		return;
 
@@ -428,6 +428,39 @@ typedef struct {
 
 /*****************************************************************************/
 
+/* Besides the main netlink socket, which is used for all requests and which
+ * receives link and address events, there are additional sockets that only
+ * receive events for certain object types. That way, a storm of route events
+ * cannot overflow the queue with link and address events, and an overflow
+ * only requires to resync the types of that socket. */
+typedef enum {
+	EVENT_SOCKET_ROUTES,
+	EVENT_SOCKET_RULES_TC,
+	_EVENT_SOCKET_NUM,
+} EventSocketType;
+
+typedef struct {
+	const char *name;
+	int buffer_size;
+	DelayedActionType resync;
+} EventSocketInfo;
+
+static const EventSocketInfo event_socket_infos[_EVENT_SOCKET_NUM] = {
+	[EVENT_SOCKET_ROUTES] = {
+		.name        = "routes",
+		.buffer_size = 32*1024*1024,
+		.resync      = DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
+		               DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
+	},
+	[EVENT_SOCKET_RULES_TC] = {
+		.name        = "rules-tc",
+		.buffer_size = 2*1024*1024,
+		.resync      = DELAYED_ACTION_TYPE_REFRESH_ALL_ROUTING_RULES_ALL |
+		               DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS |
+		               DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS,
+	},
+};
+
 typedef struct {
 	struct nl_sock *genl;
 
@@ -440,6 +473,27 @@ typedef struct {
 	GIOChannel *event_channel;
 	guint event_id;
 
+	struct {
+		struct nl_sock *sk;
+		GIOChannel *channel;
+		guint id;
+	} event_sockets[_EVENT_SOCKET_NUM];
+
+	/* a persistent buffer for receiving from @nlh, so that we don't
+	 * allocate memory for each recvmsg() call. */
+	struct {
+		unsigned char *buf;
+		gsize len;
+		bool in_use:1;
+	} recv_buf;
+
+	/* counters for how many messages we received via @nlh, and how
+	 * often we needed to allocate memory for receiving them. */
+	struct {
+		guint64 n_msgs;
+		guint64 n_allocs;
+	} recv_stats;
+
 	guint32 pruning[_REFRESH_ALL_TYPE_NUM];
 
 	GHashTable *sysctl_get_prev_values;
@@ -462,6 +516,43 @@ typedef struct {
 
 		int is_handling;
 	} delayed_action;
+
+	/* routes in these tables or of these protocols are dropped while
+	 * parsing the netlink message and never enter the cache. */
+	struct {
+		guint32 *tables;
+		guint tables_len;
+		guint32 protocols[256 / 32];
+	} route_ignore;
+
+	/* routes in these tables are cached, but not indexed per interface.
+	 * See nmp_cache_set_compact_route_tables(). */
+	struct {
+		guint32 *tables;
+		guint tables_len;
+	} route_compact;
+
+	/* after the route event socket overflowed, the routes are dumped
+	 * per interface from an idle handler, a few interfaces at a time. */
+	struct {
+		GArray *ifindexes;
+		DelayedActionType types;
+		guint idle_id;
+
+		/* the number of interrupted dumps for the current interface. */
+		guint n_dump_intr;
+	} route_resync;
+
+	/* log the memory usage of the cache after each refresh. Enabled
+	 * via the NM_PLATFORM_CACHE_STATS environment variable. */
+	bool log_cache_stats:1;
+
+	/* whether kernel supports NETLINK_GET_STRICT_CHK. Only then it
+	 * honors the filter attributes of a dump request. */
+	bool nlh_strict_check_supported:1;
+
+	/* set when reading @nlh reported NLM_F_DUMP_INTR. */
+	bool nlh_dump_intr:1;
 } NMLinuxPlatformPrivate;
 
 struct _NMLinuxPlatform {
@@ -475,6 +566,12 @@ struct _NMLinuxPlatformClass {
 
 G_DEFINE_TYPE (NMLinuxPlatform, nm_linux_platform, NM_TYPE_PLATFORM)
 
+NM_GOBJECT_PROPERTIES_DEFINE_BASE (
+	PROP_IGNORE_ROUTE_TABLES,
+	PROP_IGNORE_ROUTE_PROTOCOLS,
+	PROP_COMPACT_ROUTE_TABLES,
+);
+
 #define NM_LINUX_PLATFORM_GET_PRIVATE(self) _NM_GET_PRIVATE (self, NMLinuxPlatform, NM_IS_LINUX_PLATFORM, NMPlatform)
 
 /*****************************************************************************/
@@ -542,7 +639,9 @@ static void cache_on_change (NMPlatform *platform,
                              const NMPObject *obj_old,
                              const NMPObject *obj_new);
 static void cache_prune_all (NMPlatform *platform);
+static void route_resync_stop (NMPlatform *platform, DelayedActionType action_type);
 static gboolean event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks);
+static gboolean event_handler_read_event_sockets (NMPlatform *platform);
 static struct nl_sock *_genl_sock (NMLinuxPlatform *platform);
 
 /*****************************************************************************/
@@ -3036,9 +3135,42 @@ _new_from_nl_addr (struct nlmsghdr *nlh, gboolean id_only)
 	return g_steal_pointer (&obj);
 }
 
-/* Copied and heavily modified from libnl3's rtnl_route_parse() and parse_multipath(). */
+static gboolean
+_route_ignore_protocol (NMPlatform *platform, guint8 protocol)
+{
+	NMLinuxPlatformPrivate *priv;
+
+	if (!platform)
+		return FALSE;
+
+	priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	return NM_FLAGS_ANY (priv->route_ignore.protocols[protocol / 32u], 1u << (protocol % 32u));
+}
+
+static gboolean
+_route_ignore_table (NMPlatform *platform, guint32 table)
+{
+	NMLinuxPlatformPrivate *priv;
+	guint i;
+
+	if (!platform)
+		return FALSE;
+
+	priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	for (i = 0; i < priv->route_ignore.tables_len; i++) {
+		if (priv->route_ignore.tables[i] == table)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/* Copied and heavily modified from libnl3's rtnl_route_parse() and parse_multipath().
+ *
+ * If @route_ignore is set, routes that the user asked us to ignore are dropped.
+ * That is not done for replies to RTM_GETROUTE requests, which describe the
+ * route that a lookup resolved to and which never enter the cache. */
 static NMPObject *
-_new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only)
+_new_from_nl_route (NMPlatform *platform, struct nlmsghdr *nlh, gboolean id_only, gboolean route_ignore)
 {
 	static const struct nla_policy policy[] = {
 		[RTA_TABLE]     = { .type = NLA_U32 },
@@ -3086,12 +3218,25 @@ _new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only)
 	if (rtm->rtm_type != RTN_UNICAST)
 		return NULL;
 
+	/* drop routes that the user asked us to ignore, before doing any
+	 * further parsing. They never enter the cache. */
+	if (   route_ignore
+	    && _route_ignore_protocol (platform, rtm->rtm_protocol))
+		return NULL;
+
 	if (nlmsg_parse_arr (nlh,
 	                     sizeof (struct rtmsg),
 	                     tb,
 	                     policy) < 0)
 		return NULL;
 
+	if (   route_ignore
+	    && _route_ignore_table (platform,
+	                            tb[RTA_TABLE]
+	                            ? nla_get_u32 (tb[RTA_TABLE])
+	                            : (guint32) rtm->rtm_table))
+		return NULL;
+
 	/*****************************************************************/
 
 	is_v4 = rtm->rtm_family == AF_INET;
@@ -3596,11 +3741,13 @@ _new_from_nl_tfilter (struct nlmsghdr *nlh, gboolean id_only)
  *   If a cache is given, the object is completed with information from the cache.
  * @nlh: the netlink message header
  * @id_only: whether only to create an empty object with only the ID fields set.
+ * @is_route_get: whether the message is the reply to a RTM_GETROUTE request
+ *   of nm_platform_ip_route_get().
  *
  * Returns: %NULL or a newly created NMPObject instance.
  **/
 static NMPObject *
-nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only)
+nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only, gboolean is_route_get)
 {
 	struct nlmsghdr *msghdr;
 
@@ -3622,7 +3769,7 @@ nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_m
 	case RTM_NEWROUTE:
 	case RTM_DELROUTE:
 	case RTM_GETROUTE:
-		return _new_from_nl_route (msghdr, id_only);
+		return _new_from_nl_route (platform, msghdr, id_only, !is_route_get);
 	case RTM_NEWRULE:
 	case RTM_DELRULE:
 	case RTM_GETRULE:
@@ -5030,6 +5177,29 @@ delayed_action_handle_WAIT_FOR_NL_RESPONSE (NMPlatform *platform)
 	event_handler_read_netlink (platform, TRUE);
 }
 
+static void
+_log_cache_stats (NMPlatform *platform)
+{
+	NMPCacheStats stats[NMP_OBJECT_TYPE_MAX + 1];
+	NMPObjectType obj_type;
+
+	nmp_cache_get_stats (nm_platform_get_cache (platform), stats);
+
+	for (obj_type = NMP_OBJECT_TYPE_UNKNOWN + 1; obj_type <= NMP_OBJECT_TYPE_MAX; obj_type++) {
+		const NMPCacheStats *s = &stats[obj_type];
+
+		if (s->n_objects == 0)
+			continue;
+
+		_LOGI ("cache-stats: %s: %u objects (%zu bytes), %u index entries (%zu bytes), %u index heads (%zu bytes), %zu bytes per object",
+		       nmp_class_from_type (obj_type)->obj_type_name,
+		       s->n_objects, s->bytes_objects,
+		       s->n_entries, s->bytes_entries,
+		       s->n_heads, s->bytes_heads,
+		       (s->bytes_objects + s->bytes_entries + s->bytes_heads) / s->n_objects);
+	}
+}
+
 static gboolean
 delayed_action_handle_one (NMPlatform *platform)
 {
@@ -5079,6 +5249,8 @@ delayed_action_handle_one (NMPlatform *platform)
 		}
 
 		delayed_action_handle_REFRESH_ALL (platform, flags);
+		if (priv->log_cache_stats)
+			_log_cache_stats (platform);
 		return TRUE;
 	}
 
@@ -5686,6 +5858,42 @@ _nl_msg_new_dump (NMPObjectType obj_type,
 	return g_steal_pointer (&nlmsg);
 }
 
+static struct nl_msg *
+_nl_msg_new_route_dump_by_ifindex (NMPObjectType obj_type,
+                                   int ifindex)
+{
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+	const NMPClass *klass;
+
+	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                NMP_OBJECT_TYPE_IP6_ROUTE));
+	nm_assert (ifindex > 0);
+
+	klass = nmp_class_from_type (obj_type);
+
+	nlmsg = nlmsg_alloc_simple (klass->rtm_gettype, NLM_F_DUMP);
+
+	/* with NETLINK_GET_STRICT_CHK, kernel requires the full header
+	 * instead of a struct rtgenmsg. */
+	{
+		const struct rtmsg rtm = {
+			.rtm_family = klass->addr_family,
+		};
+
+		if (nlmsg_append_struct (nlmsg, &rtm) < 0)
+			g_return_val_if_reached (NULL);
+	}
+
+	/* with NETLINK_GET_STRICT_CHK, kernel only dumps the routes
+	 * whose nexthop is on this interface. */
+	NLA_PUT_U32 (nlmsg, RTA_OIF, ifindex);
+
+	return g_steal_pointer (&nlmsg);
+
+nla_put_failure:
+	g_return_val_if_reached (NULL);
+}
+
 static void
 do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type)
 {
@@ -5698,6 +5906,14 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 
 	action_type_prune = action_type;
 
+	/* process the events that were queued before the dump. Once the dump is in
+	 * progress, the event socket is no longer read until the dump completes, and
+	 * these older events would be applied on top of the dump result. */
+	event_handler_read_event_sockets (platform);
+
+	/* a full dump supersedes a pending per-interface resync. */
+	route_resync_stop (platform, action_type);
+
 	/* calling nmp_cache_dirty_set_all_main() with a non-main lookup-index requires an extra
 	 * cache lookup for every entry.
 	 *
@@ -5778,6 +5994,290 @@ do_request_one_type_by_needle_object (NMPlatform *platform, const NMPObject *obj
 	delayed_action_handle_all (platform, FALSE);
 }
 
+/* whether we can dump and prune the routes of one interface. Kernel needs
+ * to support strict checking, otherwise it ignores the filter. And routes in
+ * compact tables are not indexed per interface, so they could not be pruned. */
+static gboolean
+_route_dump_by_ifindex_supported (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	return    priv->nlh_strict_check_supported
+	       && !nmp_cache_has_compact_route_tables (nm_platform_get_cache (platform));
+}
+
+/* dump the routes of one interface and prune only the routes of that
+ * interface from the cache. If that is not supported, request and prune
+ * all routes instead.
+ *
+ * Returns: 0 on success, -NME_NL_DUMP_INTR if the dump was interrupted
+ *   and should be repeated, or another negative error code. */
+static int
+do_request_routes_by_ifindex (NMPlatform *platform,
+                              NMPObjectType obj_type,
+                              int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	RefreshAllType refresh_all_type;
+	DelayedActionType action_type;
+	NMPLookup lookup;
+	int *out_refresh_all_in_progress;
+	gboolean by_ifindex;
+	int nle;
+
+	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                NMP_OBJECT_TYPE_IP6_ROUTE));
+	nm_assert (ifindex > 0);
+
+	if (obj_type == NMP_OBJECT_TYPE_IP4_ROUTE) {
+		refresh_all_type = REFRESH_ALL_TYPE_IP4_ROUTES;
+		action_type = DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES;
+	} else {
+		refresh_all_type = REFRESH_ALL_TYPE_IP6_ROUTES;
+		action_type = DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES;
+	}
+
+	/* a full dump is scheduled or in progress. It covers this interface too. */
+	if (delayed_action_refresh_all_in_progress (platform, action_type))
+		return 0;
+
+	_LOGD ("do-request-routes: %s for ifindex %d",
+	       nmp_class_from_type (obj_type)->obj_type_name,
+	       ifindex);
+
+	event_handler_read_netlink (platform, FALSE);
+
+	by_ifindex = _route_dump_by_ifindex_supported (platform);
+
+	if (by_ifindex)
+		nlmsg = _nl_msg_new_route_dump_by_ifindex (obj_type, ifindex);
+	else
+		nlmsg = _nl_msg_new_dump (obj_type, AF_UNSPEC);
+	if (!nlmsg)
+		return -NME_UNSPEC;
+
+	out_refresh_all_in_progress = &priv->delayed_action.refresh_all_in_progress[refresh_all_type];
+	nm_assert (*out_refresh_all_in_progress >= 0);
+	*out_refresh_all_in_progress += 1;
+
+	/* strict checking also affects how kernel validates other requests, like
+	 * RTM_GETROUTE for nm_platform_ip_route_get(). Enable it only while sending
+	 * the dump request. Kernel evaluates the flag when the dump starts. */
+	nle = 0;
+	if (by_ifindex)
+		nle = nl_socket_set_strict_check (priv->nlh, TRUE);
+	if (nle >= 0) {
+		nle = _nl_send_nlmsg (platform,
+		                      nlmsg,
+		                      &seq_result,
+		                      NULL,
+		                      DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS,
+		                      out_refresh_all_in_progress);
+		if (   by_ifindex
+		    && nl_socket_set_strict_check (priv->nlh, FALSE) < 0)
+			nm_assert_not_reached ();
+	}
+	if (nle < 0) {
+		nm_assert (*out_refresh_all_in_progress > 0);
+		*out_refresh_all_in_progress -= 1;
+		_LOGD ("do-request-routes: failed sending netlink request \"%s\" (%d)",
+		       nm_strerror (nle), -nle);
+		return nle;
+	}
+
+	/* the response is not yet read, so we can mark the partition
+	 * dirty only now. */
+	if (by_ifindex)
+		nmp_lookup_init_object (&lookup, obj_type, ifindex);
+	else
+		nmp_lookup_init_obj_type (&lookup, obj_type);
+	nmp_cache_dirty_set_all_main (nm_platform_get_cache (platform),
+	                              &lookup);
+
+	priv->nlh_dump_intr = FALSE;
+
+	delayed_action_handle_all (platform, FALSE);
+
+	if (priv->nlh_dump_intr) {
+		/* the dump is incomplete. Don't leave the partition marked dirty, it
+		 * would be pruned by the next refresh of a different partition. */
+		nmp_cache_dirty_unset_all_main (nm_platform_get_cache (platform),
+		                                &lookup);
+		return -NME_NL_DUMP_INTR;
+	}
+
+	/* kernel rejects the filter with ENODEV if the interface is gone.
+	 * Then there are no routes for it either. */
+	if (!NM_IN_SET (seq_result, WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK, -ENODEV))
+		return -NME_UNSPEC;
+
+	cache_prune_one_type (platform, &lookup);
+	return 0;
+}
+
+#define ROUTE_RESYNC_IFINDEXES_PER_RUN 8
+
+/* if the routes of an interface change while we dump them, the dump is
+ * repeated. Give up after a few attempts and request all routes instead. */
+#define ROUTE_RESYNC_MAX_DUMP_INTR     3
+
+static int
+route_resync_find_ifindex (NMPlatform *platform, int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint i;
+
+	if (!priv->route_resync.types)
+		return -1;
+
+	for (i = 0; i < priv->route_resync.ifindexes->len; i++) {
+		if (g_array_index (priv->route_resync.ifindexes, int, i) == ifindex)
+			return i;
+	}
+	return -1;
+}
+
+static void
+route_resync_stop (NMPlatform *platform, DelayedActionType action_type)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	if (!NM_FLAGS_ANY (priv->route_resync.types, action_type))
+		return;
+
+	priv->route_resync.types &= ~action_type;
+	if (priv->route_resync.types)
+		return;
+
+	_LOGD ("route-resync: done");
+	g_array_set_size (priv->route_resync.ifindexes, 0);
+	nm_clear_g_source (&priv->route_resync.idle_id);
+}
+
+static gboolean
+route_resync_cb (gpointer user_data)
+{
+	NMPlatform *platform = user_data;
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint n;
+
+	/* each run dumps the routes of a few interfaces and then yields
+	 * to the mainloop, so that we keep up reading events. */
+	for (n = 0; n < ROUTE_RESYNC_IFINDEXES_PER_RUN; n++) {
+		GArray *ifindexes = priv->route_resync.ifindexes;
+		DelayedActionType types = priv->route_resync.types;
+		DelayedActionType iflags;
+		gboolean repeat = FALSE;
+		int ifindex;
+
+		if (   !types
+		    || ifindexes->len == 0)
+			break;
+
+		ifindex = g_array_index (ifindexes, int, ifindexes->len - 1);
+
+		FOR_EACH_DELAYED_ACTION (iflags, types) {
+			int r;
+
+			if (!NM_FLAGS_HAS (priv->route_resync.types, iflags))
+				continue;
+
+			r = do_request_routes_by_ifindex (platform,
+			                                  iflags == DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES
+			                                  ? NMP_OBJECT_TYPE_IP4_ROUTE
+			                                  : NMP_OBJECT_TYPE_IP6_ROUTE,
+			                                  ifindex);
+			if (   r == -NME_NL_DUMP_INTR
+			    && priv->route_resync.n_dump_intr < ROUTE_RESYNC_MAX_DUMP_INTR) {
+				priv->route_resync.n_dump_intr++;
+				repeat = TRUE;
+			} else if (r < 0) {
+				/* fall back to a full dump. That also clears @iflags from
+				 * the pending types. */
+				_LOGD ("route-resync: failed for ifindex %d%s. Request all routes",
+				       ifindex,
+				       r == -NME_NL_DUMP_INTR ? " (dump repeatedly interrupted)" : "");
+				delayed_action_schedule (platform, iflags, NULL);
+				delayed_action_handle_all (platform, FALSE);
+			}
+		}
+
+		/* handling the delayed actions might have stopped the resync. */
+		if (!priv->route_resync.types)
+			break;
+
+		if (!repeat) {
+			g_array_set_size (ifindexes, ifindexes->len - 1);
+			priv->route_resync.n_dump_intr = 0;
+		}
+	}
+
+	if (   !priv->route_resync.types
+	    || priv->route_resync.ifindexes->len == 0) {
+		priv->route_resync.idle_id = 0;
+		route_resync_stop (platform, DELAYED_ACTION_TYPE_REFRESH_ALL);
+		return G_SOURCE_REMOVE;
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+/* instead of requesting all routes after we lost route events,
+ * dump them interface by interface. Only routes with an ifindex
+ * are in the cache, so the interfaces of all cached links and routes
+ * cover the whole route cache. */
+static gboolean
+route_resync_start (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gs_unref_hashtable GHashTable *ifindexes_set = NULL;
+	NMDedupMultiIter iter;
+	const NMPObject *obj;
+	GHashTableIter h_iter;
+	gpointer ptr;
+
+	if (!_route_dump_by_ifindex_supported (platform))
+		return FALSE;
+
+	ifindexes_set = g_hash_table_new (nm_direct_hash, NULL);
+
+	nmp_cache_iter_for_each (&iter,
+	                         nm_platform_lookup_obj_type (platform, NMP_OBJECT_TYPE_LINK),
+	                         &obj)
+		g_hash_table_add (ifindexes_set, GINT_TO_POINTER (obj->link.ifindex));
+	nmp_cache_iter_for_each (&iter,
+	                         nm_platform_lookup_obj_type (platform, NMP_OBJECT_TYPE_IP4_ROUTE),
+	                         &obj)
+		g_hash_table_add (ifindexes_set, GINT_TO_POINTER (obj->ip_route.ifindex));
+	nmp_cache_iter_for_each (&iter,
+	                         nm_platform_lookup_obj_type (platform, NMP_OBJECT_TYPE_IP6_ROUTE),
+	                         &obj)
+		g_hash_table_add (ifindexes_set, GINT_TO_POINTER (obj->ip_route.ifindex));
+
+	if (!priv->route_resync.ifindexes)
+		priv->route_resync.ifindexes = g_array_new (FALSE, FALSE, sizeof (int));
+	g_array_set_size (priv->route_resync.ifindexes, 0);
+
+	g_hash_table_iter_init (&h_iter, ifindexes_set);
+	while (g_hash_table_iter_next (&h_iter, &ptr, NULL)) {
+		int ifindex = GPOINTER_TO_INT (ptr);
+
+		if (ifindex > 0)
+			g_array_append_val (priv->route_resync.ifindexes, ifindex);
+	}
+
+	_LOGD ("route-resync: request routes for %u interfaces", priv->route_resync.ifindexes->len);
+
+	priv->route_resync.types = DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
+	                           DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES;
+	priv->route_resync.n_dump_intr = 0;
+	if (!priv->route_resync.idle_id)
+		priv->route_resync.idle_id = g_idle_add (route_resync_cb, platform);
+	return TRUE;
+}
+
 static void
 event_seq_check_refresh_all (NMPlatform *platform, guint32 seq_number)
 {
@@ -5846,6 +6346,27 @@ event_seq_check (NMPlatform *platform, guint32 seq_number, WaitForNlResponseResu
 #endif
 }
 
+/* whether a nm_platform_ip_route_get() request waits for the message
+ * with this sequence number. */
+static gboolean
+_route_get_response_pending (NMPlatform *platform, guint32 seq_number)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint i;
+
+	if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
+		return FALSE;
+
+	for (i = 0; i < priv->delayed_action.list_wait_for_nl_response->len; i++) {
+		const DelayedActionWaitForNlResponseData *data = &g_array_index (priv->delayed_action.list_wait_for_nl_response, DelayedActionWaitForNlResponseData, i);
+
+		if (   data->response_type == DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET
+		    && data->seq_number == seq_number)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 static void
 event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_events)
 {
@@ -5856,6 +6377,7 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 	char buf_nlmsghdr[400];
 	gboolean is_del = FALSE;
 	gboolean is_dump = FALSE;
+	gboolean is_route_get = FALSE;
 	NMPCache *cache = nm_platform_get_cache (platform);
 
 	msghdr = nlmsg_hdr (msg);
@@ -5896,13 +6418,24 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 		is_del = TRUE;
 	}
 
-	obj = nmp_object_new_from_nl (platform, cache, msg, is_del);
+	if (   msghdr->nlmsg_type == RTM_NEWROUTE
+	    && msghdr->nlmsg_seq != 0)
+		is_route_get = _route_get_response_pending (platform, msghdr->nlmsg_seq);
+
+	obj = nmp_object_new_from_nl (platform, cache, msg, is_del, is_route_get);
 	if (!obj) {
 		_LOGT ("event-notification: %s: ignore",
 		       nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
 		return;
 	}
 
+	if (msghdr->nlmsg_type == RTM_DELLINK) {
+		/* routes, rules and tc objects are received on separate sockets. Process
+		 * their pending events first, otherwise objects of the removed link
+		 * would be re-added to the cache after we purged them. */
+		event_handler_read_event_sockets (platform);
+	}
+
 	if (   !is_del
 	    && NM_IN_SET (msghdr->nlmsg_type, RTM_NEWADDR,
 	                                      RTM_NEWLINK,
@@ -6092,6 +6625,30 @@ do_add_link_with_lookup (NMPlatform *platform,
 	return wait_for_nl_response_to_nmerr (seq_result);
 }
 
+static int
+do_add_addrroute_complete (NMPlatform *platform,
+                           const NMPObject *obj_id,
+                           WaitForNlResponseResult seq_result,
+                           const char *errmsg,
+                           gboolean suppress_netlink_failure)
+{
+	char s_buf[256];
+
+	nm_assert (seq_result);
+
+	_NMLOG ((   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
+	         || (   suppress_netlink_failure
+	             && seq_result < 0))
+	            ? LOGL_DEBUG
+	            : LOGL_WARN,
+	        "do-add-%s[%s]: %s",
+	        NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
+	        nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+	        wait_for_nl_response_to_string (seq_result, errmsg, s_buf, sizeof (s_buf)));
+
+	return wait_for_nl_response_to_nmerr (seq_result);
+}
+
 static int
 do_add_addrroute (NMPlatform *platform,
                   const NMPObject *obj_id,
@@ -6101,7 +6658,7 @@ do_add_addrroute (NMPlatform *platform,
 	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
 	gs_free char *errmsg = NULL;
 	int nle;
-	char s_buf[256];
+	int r;
 
 	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
 	                      NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS,
@@ -6120,17 +6677,7 @@ do_add_addrroute (NMPlatform *platform,
 
 	delayed_action_handle_all (platform, FALSE);
 
-	nm_assert (seq_result);
-
-	_NMLOG ((   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
-	         || (   suppress_netlink_failure
-	             && seq_result < 0))
-	            ? LOGL_DEBUG
-	            : LOGL_WARN,
-	        "do-add-%s[%s]: %s",
-	        NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
-	        nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
-	        wait_for_nl_response_to_string (seq_result, errmsg, s_buf, sizeof (s_buf)));
+	r = do_add_addrroute_complete (platform, obj_id, seq_result, errmsg, suppress_netlink_failure);
 
 	if (NMP_OBJECT_GET_TYPE (obj_id) == NMP_OBJECT_TYPE_IP6_ADDRESS) {
 		/* In rare cases, the object is not yet ready as we received the ACK from
@@ -6144,32 +6691,19 @@ do_add_addrroute (NMPlatform *platform,
 			do_request_one_type_by_needle_object (platform, obj_id);
 	}
 
-	return wait_for_nl_response_to_nmerr (seq_result);
+	return r;
 }
 
 static gboolean
-do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
+do_delete_object_complete (NMPlatform *platform,
+                           const NMPObject *obj_id,
+                           WaitForNlResponseResult seq_result,
+                           const char *errmsg)
 {
-	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
-	gs_free char *errmsg = NULL;
-	int nle;
 	char s_buf[256];
 	gboolean success;
 	const char *log_detail = "";
 
-	event_handler_read_netlink (platform, FALSE);
-
-	nle = _nl_send_nlmsg (platform, nlmsg, &seq_result, &errmsg, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
-	if (nle < 0) {
-		_LOGE ("do-delete-%s[%s]: failure sending netlink request \"%s\" (%d)",
-		       NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
-		       nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
-		       nm_strerror (nle), -nle);
-		return FALSE;
-	}
-
-	delayed_action_handle_all (platform, FALSE);
-
 	nm_assert (seq_result);
 
 	success = TRUE;
@@ -6194,6 +6728,32 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 	        wait_for_nl_response_to_string (seq_result, errmsg, s_buf, sizeof (s_buf)),
 	        log_detail);
 
+	return success;
+}
+
+static gboolean
+do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
+{
+	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	gs_free char *errmsg = NULL;
+	int nle;
+	gboolean success;
+
+	event_handler_read_netlink (platform, FALSE);
+
+	nle = _nl_send_nlmsg (platform, nlmsg, &seq_result, &errmsg, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+	if (nle < 0) {
+		_LOGE ("do-delete-%s[%s]: failure sending netlink request \"%s\" (%d)",
+		       NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
+		       nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+		       nm_strerror (nle), -nle);
+		return FALSE;
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+
+	success = do_delete_object_complete (platform, obj_id, seq_result, errmsg);
+
 	if (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
 	               NMP_OBJECT_TYPE_IP6_ADDRESS,
 	               NMP_OBJECT_TYPE_QDISC,
@@ -6371,6 +6931,13 @@ link_refresh (NMPlatform *platform, int ifindex)
 	return !!nm_platform_link_get_obj (platform, ifindex, TRUE);
 }
 
+static void
+link_refresh_all (NMPlatform *platform)
+{
+	delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS, NULL);
+	delayed_action_handle_all (platform, FALSE);
+}
+
 static gboolean
 link_set_netns (NMPlatform *platform,
                 int ifindex,
@@ -8106,6 +8673,107 @@ ip_route_add (NMPlatform *platform,
 	                         NM_FLAGS_HAS (flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE));
 }
 
+/* The maximum number of route requests that we send to kernel before
+ * reading the responses. Kernel queues an ACK and a notification for each
+ * request in our socket's receive buffer, so the number of requests
+ * in flight must be bounded to not overflow it. */
+#define IP_ROUTE_BATCH_WINDOW 256
+
+static void
+_ip_route_batch_window (NMPlatform *platform,
+                        NMPlatformIPRouteBatchOp *ops,
+                        guint n_ops)
+{
+	WaitForNlResponseResult seq_results[IP_ROUTE_BATCH_WINDOW];
+	char *errmsgs[IP_ROUTE_BATCH_WINDOW];
+	gboolean sent[IP_ROUTE_BATCH_WINDOW];
+	guint i;
+
+	nm_assert (n_ops > 0 && n_ops <= IP_ROUTE_BATCH_WINDOW);
+
+	/* the caller holds a reference to the objects in @ops. Reading netlink
+	 * below may remove them from the cache. */
+
+	event_handler_read_netlink (platform, FALSE);
+
+	for (i = 0; i < n_ops; i++) {
+		nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+		const NMPObject *obj = ops[i].obj;
+		int nle;
+
+		nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ROUTE,
+		                                                 NMP_OBJECT_TYPE_IP6_ROUTE));
+
+		seq_results[i] = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+		errmsgs[i] = NULL;
+		sent[i] = FALSE;
+
+		if (ops[i].is_delete)
+			nlmsg = _nl_msg_new_route (RTM_DELROUTE, 0, obj);
+		else {
+			NMPObject obj_normalized;
+
+			nmp_object_stackinit (&obj_normalized, NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_CAST_IP_ROUTE (obj));
+			nm_platform_ip_route_normalize (NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+			                                  ? AF_INET
+			                                  : AF_INET6,
+			                                NMP_OBJECT_CAST_IP_ROUTE (&obj_normalized));
+			nlmsg = _nl_msg_new_route (RTM_NEWROUTE, ops[i].flags & NMP_NLM_FLAG_FMASK, &obj_normalized);
+		}
+		if (!nlmsg) {
+			nm_assert_not_reached ();
+			ops[i].result = -NME_BUG;
+			continue;
+		}
+
+		nle = _nl_send_nlmsg (platform, nlmsg, &seq_results[i], &errmsgs[i], DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+		if (nle < 0) {
+			_LOGE ("do-%s-%s[%s]: failure sending netlink request \"%s\" (%d)",
+			       ops[i].is_delete ? "delete" : "add",
+			       NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+			       nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+			       nm_strerror (nle), -nle);
+			ops[i].result = -NME_PL_NETLINK;
+			continue;
+		}
+		sent[i] = TRUE;
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+
+	for (i = 0; i < n_ops; i++) {
+		if (sent[i]) {
+			if (ops[i].is_delete) {
+				ops[i].result =   do_delete_object_complete (platform, ops[i].obj, seq_results[i], errmsgs[i])
+				                ? 0
+				                : wait_for_nl_response_to_nmerr (seq_results[i]);
+			} else {
+				ops[i].result = do_add_addrroute_complete (platform,
+				                                           ops[i].obj,
+				                                           seq_results[i],
+				                                           errmsgs[i],
+				                                           NM_FLAGS_HAS (ops[i].flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE));
+			}
+		}
+		g_free (errmsgs[i]);
+	}
+}
+
+static void
+ip_route_batch (NMPlatform *platform,
+                NMPlatformIPRouteBatchOp *ops,
+                guint n_ops)
+{
+	guint i;
+
+	/* Send the requests in windows of IP_ROUTE_BATCH_WINDOW, and only wait
+	 * for the responses once per window instead of once per route. Kernel
+	 * handles the requests of one socket in order, so the ordering of @ops
+	 * is preserved. */
+	for (i = 0; i < n_ops; i += IP_ROUTE_BATCH_WINDOW)
+		_ip_route_batch_window (platform, &ops[i], MIN (n_ops - i, (guint) IP_ROUTE_BATCH_WINDOW));
+}
+
 static gboolean
 object_delete (NMPlatform *platform,
                const NMPObject *obj)
@@ -8218,6 +8886,99 @@ ip_route_get (NMPlatform *platform,
 	return -NME_UNSPEC;
 }
 
+static DelayedActionType
+_route_refresh_action_type (int addr_family)
+{
+	DelayedActionType action_type = DELAYED_ACTION_TYPE_NONE;
+
+	nm_assert (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET, AF_INET6));
+
+	if (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET))
+		action_type |= DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES;
+	if (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET6))
+		action_type |= DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES;
+	return action_type;
+}
+
+static gboolean
+ip_route_refresh_pending (NMPlatform *platform,
+                          int addr_family,
+                          int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	nm_assert (ifindex > 0);
+
+	/* the cache is only known to be out of date, if the interface
+	 * is still pending in a resync after we lost route events. */
+	return    NM_FLAGS_ANY (priv->route_resync.types, _route_refresh_action_type (addr_family))
+	       && route_resync_find_ifindex (platform, ifindex) >= 0;
+}
+
+static gboolean
+ip_route_refresh (NMPlatform *platform,
+                  int addr_family,
+                  int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	DelayedActionType action_type;
+	DelayedActionType iflags;
+	gboolean success = TRUE;
+	int resync_idx;
+
+	nm_assert (ifindex > 0);
+
+	action_type = _route_refresh_action_type (addr_family);
+
+	/* we cannot request anything while handling the delayed actions,
+	 * for example from a signal handler of the platform cache. */
+	if (priv->delayed_action.is_handling > 0) {
+		_LOGD ("do-request-routes: cannot request routes for ifindex %d while handling events", ifindex);
+		return FALSE;
+	}
+
+	/* a pending dump of all routes would make us skip the request below.
+	 * Complete it first. */
+	delayed_action_handle_all (platform, FALSE);
+
+	FOR_EACH_DELAYED_ACTION (iflags, action_type) {
+		const NMPObjectType obj_type = (iflags == DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES)
+		                               ? NMP_OBJECT_TYPE_IP4_ROUTE
+		                               : NMP_OBJECT_TYPE_IP6_ROUTE;
+		guint n_dump_intr = 0;
+		int r;
+
+		for (;;) {
+			r = do_request_routes_by_ifindex (platform, obj_type, ifindex);
+			/* if the routes changed while dumping them, try again. */
+			if (   r != -NME_NL_DUMP_INTR
+			    || ++n_dump_intr > ROUTE_RESYNC_MAX_DUMP_INTR)
+				break;
+		}
+		if (r < 0) {
+			_LOGD ("do-request-routes: failed to request %s for ifindex %d: %s",
+			       nmp_class_from_type (obj_type)->obj_type_name,
+			       ifindex,
+			       nm_strerror (r));
+			success = FALSE;
+		}
+	}
+
+	/* the pending resync for this interface is no longer necessary, unless
+	 * we only refreshed one address family or failed. Handling the delayed
+	 * actions might have changed the resync, so look again. */
+	if (   success
+	    && NM_FLAGS_ALL (action_type, priv->route_resync.types)
+	    && (resync_idx = route_resync_find_ifindex (platform, ifindex)) >= 0) {
+		/* the resync handles the last interface of the list next. */
+		if (resync_idx == priv->route_resync.ifindexes->len - 1)
+			priv->route_resync.n_dump_intr = 0;
+		g_array_remove_index_fast (priv->route_resync.ifindexes, resync_idx);
+	}
+
+	return success;
+}
+
 /*****************************************************************************/
 
 static int
@@ -8357,12 +9118,61 @@ event_handler (GIOChannel *channel,
 
 /*****************************************************************************/
 
+static unsigned char *
+_recv_buf_acquire (NMPlatform *platform, struct nl_sock *sk, gsize *out_len, unsigned char **out_buf_free)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gsize len;
+
+	len = nl_socket_get_msg_buf_size (sk);
+	nm_assert (len > 0);
+
+	*out_len = len;
+
+	if (G_UNLIKELY (priv->recv_buf.in_use)) {
+		/* we are called recursively, for example by a signal handler while
+		 * we are still parsing the messages in the persistent buffer.
+		 * Use a temporary buffer. */
+		priv->recv_stats.n_allocs++;
+		*out_buf_free = g_malloc (len);
+		return *out_buf_free;
+	}
+
+	/* the buffer is shared by all sockets, which might use different
+	 * message buffer sizes. Only grow it. */
+	if (G_UNLIKELY (priv->recv_buf.len < len)) {
+		priv->recv_stats.n_allocs++;
+		g_free (priv->recv_buf.buf);
+		priv->recv_buf.buf = g_malloc (len);
+		priv->recv_buf.len = len;
+		_LOGT ("netlink: recvmsg: allocated %zu bytes receive buffer (%"G_GUINT64_FORMAT" allocations for %"G_GUINT64_FORMAT" messages so far)",
+		       len,
+		       priv->recv_stats.n_allocs,
+		       priv->recv_stats.n_msgs);
+	}
+
+	priv->recv_buf.in_use = TRUE;
+	*out_buf_free = NULL;
+	return priv->recv_buf.buf;
+}
+
+static void
+_recv_buf_release (NMPlatform *platform, unsigned char **buf_free)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	if (*buf_free)
+		nm_clear_g_free (buf_free);
+	else
+		priv->recv_buf.in_use = FALSE;
+}
+
 /* copied from libnl3's recvmsgs() */
 static int
-event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
+event_handler_recvmsgs (NMPlatform *platform, struct nl_sock *sk, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
-	struct nl_sock *sk = priv->nlh;
+	const gboolean is_nlh = (sk == priv->nlh);
 	int n;
 	int err = 0;
 	gboolean multipart = 0;
@@ -8372,13 +9182,16 @@ event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
 	struct sockaddr_nl nla = {0};
 	struct ucred creds;
 	gboolean creds_has;
-	nm_auto_free unsigned char *buf = NULL;
+	unsigned char *buf;
+	unsigned char *buf_free = NULL;
+	gsize buf_len;
 
 continue_reading:
-	g_clear_pointer (&buf, free);
-	n = nl_recv (sk, &nla, &buf, &creds, &creds_has);
+	buf = _recv_buf_acquire (platform, sk, &buf_len, &buf_free);
+	n = nl_recv_buf (sk, &nla, buf, buf_len, &creds, &creds_has);
 
 	if (n <= 0) {
+		_recv_buf_release (platform, &buf_free);
 
 		if (n == -NME_NL_MSG_TRUNC) {
 			int buf_size;
@@ -8401,14 +9214,19 @@ continue_reading:
 
 	hdr = (struct nlmsghdr *) buf;
 	while (nlmsg_ok (hdr, n)) {
-		nm_auto_nlmsg struct nl_msg *msg = NULL;
+		struct nl_msg msg_stack;
+		struct nl_msg *msg;
 		gboolean abort_parsing = FALSE;
 		gboolean process_valid_msg = FALSE;
 		guint32 seq_number;
 		char buf_nlmsghdr[400];
 		const char *extack_msg = NULL;
 
-		msg = nlmsg_alloc_convert (hdr);
+		/* the message is parsed in place from the receive buffer, and
+		 * not copied to the heap. */
+		msg = nlmsg_stackinit (&msg_stack, hdr);
+
+		priv->recv_stats.n_msgs++;
 
 		nlmsg_set_proto (msg, NETLINK_ROUTE);
 		nlmsg_set_src (msg, &nla);
@@ -8511,6 +9329,12 @@ continue_reading:
 
 		seq_number = nlmsg_hdr (msg)->nlmsg_seq;
 
+		/* the event sockets only receive notifications. Those carry the
+		 * sequence number of the request that caused them, but the
+		 * responses to our requests only arrive on @nlh. */
+		if (!is_nlh)
+			seq_number = 0;
+
 		/* check whether the seq number is different from before, and
 		 * whether the previous number (@nlh_seq_last_seen) is a pending
 		 * refresh-all request. In that case, the pending request is thereby
@@ -8541,9 +9365,11 @@ continue_reading:
 
 	if (multipart) {
 		/* Multipart message not yet complete, continue reading */
+		_recv_buf_release (platform, &buf_free);
 		goto continue_reading;
 	}
 stop:
+	_recv_buf_release (platform, &buf_free);
 	if (!handle_events) {
 		/* when we don't handle events, we want to drain all messages from the socket
 		 * without handling the messages (but still check for sequence numbers).
@@ -8558,6 +9384,97 @@ stop:
 
 /*****************************************************************************/
 
+static gboolean
+_event_socket_refresh_all_in_progress (NMPlatform *platform, const EventSocketInfo *info)
+{
+	DelayedActionType iflags;
+
+	FOR_EACH_DELAYED_ACTION (iflags, info->resync) {
+		if (delayed_action_refresh_all_in_progress (platform, iflags))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static gboolean
+event_handler_read_netlink_sk (NMPlatform *platform,
+                               struct nl_sock *sk,
+                               const char *sk_name,
+                               DelayedActionType resync)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gboolean any = FALSE;
+
+	for (;;) {
+		int nle;
+
+		nle = event_handler_recvmsgs (platform, sk, TRUE);
+
+		if (nle < 0) {
+			switch (nle) {
+			case -EAGAIN:
+				return any;
+			case -NME_NL_DUMP_INTR:
+				_LOGD ("netlink[%s]: read: uncritical failure to retrieve incoming events: %s (%d)", sk_name, nm_strerror (nle), nle);
+				if (sk == priv->nlh)
+					priv->nlh_dump_intr = TRUE;
+				break;
+			case -NME_NL_MSG_TRUNC:
+			case -ENOBUFS:
+				_LOGI ("netlink[%s]: read: %s. Need to resynchronize platform cache",
+				       sk_name,
+				       ({
+				            const char *_reason = "unknown";
+				            switch (nle) {
+				            case -NME_NL_MSG_TRUNC: _reason = "message truncated";       break;
+				            case -ENOBUFS:       _reason = "too many netlink events"; break;
+				            }
+				            _reason;
+				       }));
+				event_handler_recvmsgs (platform, sk, FALSE);
+				if (sk == priv->nlh) {
+					delayed_action_wait_for_nl_response_complete_all (platform,
+					                                                  WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
+				}
+				if (   sk != priv->event_sockets[EVENT_SOCKET_ROUTES].sk
+				    || !route_resync_start (platform))
+					delayed_action_schedule (platform, resync, NULL);
+				break;
+			default:
+				_LOGE ("netlink[%s]: read: failed to retrieve incoming events: %s (%d)", sk_name, nm_strerror (nle), nle);
+				break;
+			}
+		}
+		any = TRUE;
+	}
+}
+
+/* Read the pending events of all event sockets, except those for which a dump
+ * is in progress.
+ *
+ * The event sockets are not ordered against the messages on @nlh. Call this
+ * before processing a message on @nlh that affects the objects of the event
+ * sockets, so that older events don't get applied afterwards. */
+static gboolean
+event_handler_read_event_sockets (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gboolean any = FALSE;
+	guint i;
+
+	for (i = 0; i < _EVENT_SOCKET_NUM; i++) {
+		const EventSocketInfo *info = &event_socket_infos[i];
+
+		if (   !priv->event_sockets[i].sk
+		    || _event_socket_refresh_all_in_progress (platform, info))
+			continue;
+
+		if (event_handler_read_netlink_sk (platform, priv->event_sockets[i].sk, info->name, info->resync))
+			any = TRUE;
+	}
+	return any;
+}
+
 static gboolean
 event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 {
@@ -8580,51 +9497,20 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 	}
 
 	for (;;) {
-		for (;;) {
-			int nle;
-
-			nle = event_handler_recvmsgs (platform, TRUE);
-
-			if (nle < 0) {
-				switch (nle) {
-				case -EAGAIN:
-					goto after_read;
-				case -NME_NL_DUMP_INTR:
-					_LOGD ("netlink: read: uncritical failure to retrieve incoming events: %s (%d)", nm_strerror (nle), nle);
-					break;
-				case -NME_NL_MSG_TRUNC:
-				case -ENOBUFS:
-					_LOGI ("netlink: read: %s. Need to resynchronize platform cache",
-					       ({
-					            const char *_reason = "unknown";
-					            switch (nle) {
-					            case -NME_NL_MSG_TRUNC: _reason = "message truncated";       break;
-					            case -ENOBUFS:       _reason = "too many netlink events"; break;
-					            }
-					            _reason;
-					       }));
-					event_handler_recvmsgs (platform, FALSE);
-					delayed_action_wait_for_nl_response_complete_all (platform,
-					                                                  WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
+		/* @nlh also receives the responses to our requests. If it overflows,
+		 * we might have lost any of them, so resync everything. */
+		if (event_handler_read_netlink_sk (platform, priv->nlh, "main", DELAYED_ACTION_TYPE_REFRESH_ALL))
+			any = TRUE;
 
-					delayed_action_schedule (platform,
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_ROUTING_RULES_ALL |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS,
-					                         NULL);
-					break;
-				default:
-					_LOGE ("netlink: read: failed to retrieve incoming events: %s (%d)", nm_strerror (nle), nle);
-					break;
-				}
-			}
+		/* Read the event sockets only after @nlh. When we receive the ACK for
+		 * a request, the notifications caused by it are already queued
+		 * on the event sockets.
+		 *
+		 * While a dump for the types of an event socket is in progress, don't
+		 * read it. The events get processed after the dump completed, so that
+		 * they are not mistaken as part of the dump and are not pruned. */
+		if (event_handler_read_event_sockets (platform))
 			any = TRUE;
-		}
 
 after_read:
 
@@ -8795,10 +9681,216 @@ handle_udev_event (NMUdevClient *udev_client,
 
 /*****************************************************************************/
 
+static const struct {
+	const char *name;
+	guint8 protocol;
+} _route_protocol_names[] = {
+	{ "redirect",   1 },
+	{ "kernel",     2 },
+	{ "boot",       3 },
+	{ "static",     4 },
+	{ "gated",      8 },
+	{ "ra",         9 },
+	{ "mrt",        10 },
+	{ "zebra",      11 },
+	{ "bird",       12 },
+	{ "dnrouted",   13 },
+	{ "xorp",       14 },
+	{ "ntk",        15 },
+	{ "dhcp",       16 },
+	{ "mrouted",    17 },
+	{ "keepalived", 18 },
+	{ "babel",      42 },
+	{ "openr",      99 },
+	{ "bgp",        186 },
+	{ "isis",       187 },
+	{ "ospf",       188 },
+	{ "rip",        189 },
+	{ "eigrp",      192 },
+};
+
+static void
+_route_ignore_set_protocols (NMPlatform *platform, const char *value)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gs_free const char **strv = NULL;
+	gsize i, j;
+
+	memset (priv->route_ignore.protocols, 0, sizeof (priv->route_ignore.protocols));
+
+	strv = nm_utils_strsplit_set (value, " \t,;");
+	if (!strv)
+		return;
+
+	for (i = 0; strv[i]; i++) {
+		gint64 protocol = -1;
+
+		for (j = 0; j < G_N_ELEMENTS (_route_protocol_names); j++) {
+			if (g_ascii_strcasecmp (strv[i], _route_protocol_names[j].name) == 0) {
+				protocol = _route_protocol_names[j].protocol;
+				break;
+			}
+		}
+		if (protocol < 0)
+			protocol = _nm_utils_ascii_str_to_int64 (strv[i], 0, 0, 255, -1);
+
+		if (protocol < 0) {
+			_LOGW ("ignore-route-protocols: invalid protocol \"%s\"", strv[i]);
+			continue;
+		}
+
+		/* these are the protocols of routes that NetworkManager configures
+		 * itself. Ignoring them would break NetworkManager. */
+		if (NM_IN_SET (protocol, RTPROT_UNSPEC, RTPROT_KERNEL, RTPROT_BOOT, RTPROT_STATIC, RTPROT_RA, RTPROT_DHCP)) {
+			_LOGW ("ignore-route-protocols: cannot ignore protocol \"%s\" which is used by NetworkManager", strv[i]);
+			continue;
+		}
+
+		priv->route_ignore.protocols[protocol / 32] |= (1u << (protocol % 32));
+		_LOGD ("ignore-route-protocols: ignore routes with protocol %u", (guint) protocol);
+	}
+}
+
+static guint32 *
+_route_tables_parse (NMPlatform *platform,
+                     const char *option,
+                     const char *value,
+                     guint *out_len)
+{
+	gs_free const char **strv = NULL;
+	gs_free guint32 *tables = NULL;
+	guint len = 0;
+	gsize i;
+
+	*out_len = 0;
+
+	strv = nm_utils_strsplit_set (value, " \t,;");
+	if (!strv)
+		return NULL;
+
+	tables = g_new (guint32, NM_PTRARRAY_LEN (strv));
+
+	for (i = 0; strv[i]; i++) {
+		gint64 table;
+
+		table = _nm_utils_ascii_str_to_int64 (strv[i], 0, 0, G_MAXUINT32, -1);
+		if (table < 0) {
+			_LOGW ("%s: invalid table \"%s\"", option, strv[i]);
+			continue;
+		}
+
+		if (NM_IN_SET (table, RT_TABLE_UNSPEC, RT_TABLE_MAIN, RT_TABLE_LOCAL)) {
+			_LOGW ("%s: cannot use table \"%s\" which is used by NetworkManager", option, strv[i]);
+			continue;
+		}
+
+		tables[len++] = table;
+		_LOGD ("%s: table %u", option, (guint) table);
+	}
+
+	if (len == 0)
+		return NULL;
+
+	*out_len = len;
+	return g_steal_pointer (&tables);
+}
+
+static void
+_route_ignore_set_tables (NMPlatform *platform, const char *value)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	g_free (priv->route_ignore.tables);
+	priv->route_ignore.tables = _route_tables_parse (platform,
+	                                                 "ignore-route-tables",
+	                                                 value,
+	                                                 &priv->route_ignore.tables_len);
+}
+
+static void
+_route_compact_set_tables (NMPlatform *platform, const char *value)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	g_free (priv->route_compact.tables);
+	priv->route_compact.tables = _route_tables_parse (platform,
+	                                                  "compact-route-tables",
+	                                                  value,
+	                                                  &priv->route_compact.tables_len);
+}
+
+/*****************************************************************************/
+
+static gboolean
+_platform_use_udev (void)
+{
+	return    nmp_netns_is_initial ()
+	       && access ("/sys", W_OK) == 0;
+}
+
 void
 nm_linux_platform_setup (void)
 {
-	nm_platform_setup (nm_linux_platform_new (FALSE, FALSE));
+	nm_linux_platform_setup_full (NULL, NULL, NULL);
+}
+
+/**
+ * nm_linux_platform_setup_full:
+ * @ignore_route_tables: (allow-none): a list of route tables, separated
+ *   by space or comma. Routes in these tables are not tracked in the
+ *   platform cache.
+ * @ignore_route_protocols: (allow-none): a list of route protocols, either
+ *   by name or number. Routes with these protocols are not tracked in the
+ *   platform cache.
+ * @compact_route_tables: (allow-none): a list of route tables, separated
+ *   by space or comma. Routes in these tables are tracked in the platform
+ *   cache, but not indexed per interface.
+ *
+ * Like nm_linux_platform_setup(), but allows to exclude certain routes
+ * from the platform cache, or to keep them out of the per-interface index.
+ * That is useful when other routing daemons maintain huge routing tables
+ * that NetworkManager does not care about.
+ */
+void
+nm_linux_platform_setup_full (const char *ignore_route_tables,
+                              const char *ignore_route_protocols,
+                              const char *compact_route_tables)
+{
+	nm_platform_setup (g_object_new (NM_TYPE_LINUX_PLATFORM,
+	                                 NM_PLATFORM_LOG_WITH_PTR, FALSE,
+	                                 NM_PLATFORM_USE_UDEV, _platform_use_udev (),
+	                                 NM_PLATFORM_NETNS_SUPPORT, FALSE,
+	                                 NM_LINUX_PLATFORM_IGNORE_ROUTE_TABLES, ignore_route_tables,
+	                                 NM_LINUX_PLATFORM_IGNORE_ROUTE_PROTOCOLS, ignore_route_protocols,
+	                                 NM_LINUX_PLATFORM_COMPACT_ROUTE_TABLES, compact_route_tables,
+	                                 NULL));
+}
+
+/*****************************************************************************/
+
+static void
+set_property (GObject *object, guint prop_id,
+              const GValue *value, GParamSpec *pspec)
+{
+	NMPlatform *platform = NM_PLATFORM (object);
+
+	switch (prop_id) {
+	case PROP_IGNORE_ROUTE_TABLES:
+		/* construct-only */
+		_route_ignore_set_tables (platform, g_value_get_string (value));
+		break;
+	case PROP_IGNORE_ROUTE_PROTOCOLS:
+		/* construct-only */
+		_route_ignore_set_protocols (platform, g_value_get_string (value));
+		break;
+	case PROP_COMPACT_ROUTE_TABLES:
+		/* construct-only */
+		_route_compact_set_tables (platform, g_value_get_string (value));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+		break;
+	}
 }
 
 /*****************************************************************************/
@@ -8811,6 +9903,92 @@ nm_linux_platform_init (NMLinuxPlatform *self)
 	priv->delayed_action.list_master_connected = g_ptr_array_new ();
 	priv->delayed_action.list_refresh_link = g_ptr_array_new ();
 	priv->delayed_action.list_wait_for_nl_response = g_array_new (FALSE, TRUE, sizeof (DelayedActionWaitForNlResponseData));
+
+	priv->log_cache_stats = !!g_getenv ("NM_PLATFORM_CACHE_STATS");
+}
+
+static int
+_event_socket_add_memberships (struct nl_sock *sk, EventSocketType type)
+{
+	switch (type) {
+	case EVENT_SOCKET_ROUTES:
+		return nl_socket_add_memberships (sk,
+		                                  RTNLGRP_IPV4_ROUTE,
+		                                  RTNLGRP_IPV6_ROUTE,
+		                                  0);
+	case EVENT_SOCKET_RULES_TC:
+		return nl_socket_add_memberships (sk,
+		                                  RTNLGRP_IPV4_RULE,
+		                                  RTNLGRP_IPV6_RULE,
+		                                  RTNLGRP_TC,
+		                                  0);
+	case _EVENT_SOCKET_NUM:
+		break;
+	}
+	nm_assert_not_reached ();
+	return -NME_BUG;
+}
+
+static void
+_event_socket_setup (NMPlatform *platform, EventSocketType type)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const EventSocketInfo *info = &event_socket_infos[type];
+	struct nl_sock *sk;
+	int nle;
+
+	sk = nl_socket_alloc ();
+	g_assert (sk);
+
+	nle = nl_connect (sk, NETLINK_ROUTE);
+	if (nle)
+		goto fail;
+
+	nle = nl_socket_set_passcred (sk, 1);
+	if (nle)
+		goto fail;
+
+	nle = nl_socket_set_nonblocking (sk);
+	if (nle)
+		goto fail;
+
+	nle = nl_socket_set_buffer_size (sk, info->buffer_size, 0);
+	if (nle)
+		goto fail;
+
+	nl_socket_disable_msg_peek (sk);
+	nle = nl_socket_set_msg_buf_size (sk, 32 * 1024);
+	if (nle)
+		goto fail;
+
+	nle = _event_socket_add_memberships (sk, type);
+	if (nle)
+		goto fail;
+
+	priv->event_sockets[type].sk = sk;
+	priv->event_sockets[type].channel = g_io_channel_unix_new (nl_socket_get_fd (sk));
+	g_io_channel_set_encoding (priv->event_sockets[type].channel, NULL, NULL);
+	g_io_channel_set_flags (priv->event_sockets[type].channel,
+	                        g_io_channel_get_flags (priv->event_sockets[type].channel) | G_IO_FLAG_NONBLOCK,
+	                        NULL);
+	priv->event_sockets[type].id = g_io_add_watch (priv->event_sockets[type].channel,
+	                                               (EVENT_CONDITIONS | ERROR_CONDITIONS | DISCONNECT_CONDITIONS),
+	                                               event_handler, platform);
+
+	_LOGD ("Netlink socket for %s events established: port=%u, fd=%d",
+	       info->name,
+	       nl_socket_get_local_port (sk),
+	       nl_socket_get_fd (sk));
+	return;
+
+fail:
+	/* fall back to receive these events via the main socket. */
+	_LOGW ("unable to create netlink socket for %s events: %s (%d). Use the main socket instead",
+	       info->name,
+	       nm_strerror (nle), -nle);
+	nl_socket_free (sk);
+	nle = _event_socket_add_memberships (priv->nlh, type);
+	g_assert (!nle);
 }
 
 static void
@@ -8821,6 +9999,7 @@ constructed (GObject *_object)
 	int channel_flags;
 	gboolean status;
 	int nle;
+	guint i;
 
 	nm_assert (!platform->_netns || platform->_netns == nmp_netns_get_current ());
 
@@ -8872,6 +10051,17 @@ constructed (GObject *_object)
 	if (nle)
 		_LOGD ("could not enable extended acks on netlink socket");
 
+	/* only check whether kernel supports strict checking. It is enabled
+	 * only while sending filtered dump requests. */
+	nle = nl_socket_set_strict_check (priv->nlh, TRUE);
+	if (nle)
+		_LOGD ("kernel does not support strict checking of dump requests on netlink socket");
+	else {
+		priv->nlh_strict_check_supported = TRUE;
+		nle = nl_socket_set_strict_check (priv->nlh, FALSE);
+		g_assert (!nle);
+	}
+
 	/* explicitly set the msg buffer size and disable MSG_PEEK.
 	 * If we later encounter NME_NL_MSG_TRUNC, we will adjust the buffer size. */
 	nl_socket_disable_msg_peek (priv->nlh);
@@ -8880,17 +10070,15 @@ constructed (GObject *_object)
 
 	nle = nl_socket_add_memberships (priv->nlh,
 	                                 RTNLGRP_IPV4_IFADDR,
-	                                 RTNLGRP_IPV4_ROUTE,
-	                                 RTNLGRP_IPV4_RULE,
-	                                 RTNLGRP_IPV6_RULE,
 	                                 RTNLGRP_IPV6_IFADDR,
-	                                 RTNLGRP_IPV6_ROUTE,
 	                                 RTNLGRP_LINK,
-	                                 RTNLGRP_TC,
 	                                 0);
 	g_assert (!nle);
 	_LOGD ("Netlink socket for events established: port=%u, fd=%d", nl_socket_get_local_port (priv->nlh), nl_socket_get_fd (priv->nlh));
 
+	for (i = 0; i < _EVENT_SOCKET_NUM; i++)
+		_event_socket_setup (platform, i);
+
 	priv->event_channel = g_io_channel_unix_new (nl_socket_get_fd (priv->nlh));
 	g_io_channel_set_encoding (priv->event_channel, NULL, NULL);
 
@@ -8905,6 +10093,12 @@ constructed (GObject *_object)
 	/* complete construction of the GObject instance before populating the cache. */
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->constructed (_object);
 
+	if (priv->route_compact.tables) {
+		nmp_cache_set_compact_route_tables (nm_platform_get_cache (platform),
+		                                    priv->route_compact.tables,
+		                                    priv->route_compact.tables_len);
+	}
+
 	_LOGD ("populate platform cache");
 	delayed_action_schedule (platform,
 	                         DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS |
@@ -8951,15 +10145,9 @@ constructed (GObject *_object)
 NMPlatform *
 nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
 {
-	gboolean use_udev = FALSE;
-
-	if (   nmp_netns_is_initial ()
-	    && access ("/sys", W_OK) == 0)
-		use_udev = TRUE;
-
 	return g_object_new (NM_TYPE_LINUX_PLATFORM,
 	                     NM_PLATFORM_LOG_WITH_PTR, log_with_ptr,
-	                     NM_PLATFORM_USE_UDEV, use_udev,
+	                     NM_PLATFORM_USE_UDEV, _platform_use_udev (),
 	                     NM_PLATFORM_NETNS_SUPPORT, netns_support,
 	                     NULL);
 }
@@ -8979,6 +10167,9 @@ dispose (GObject *object)
 	g_ptr_array_set_size (priv->delayed_action.list_master_connected, 0);
 	g_ptr_array_set_size (priv->delayed_action.list_refresh_link, 0);
 
+	priv->route_resync.types = DELAYED_ACTION_TYPE_NONE;
+	nm_clear_g_source (&priv->route_resync.idle_id);
+
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->dispose (object);
 }
 
@@ -8986,6 +10177,7 @@ static void
 finalize (GObject *object)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (object);
+	guint i;
 
 	g_ptr_array_unref (priv->delayed_action.list_master_connected);
 	g_ptr_array_unref (priv->delayed_action.list_refresh_link);
@@ -8997,6 +10189,25 @@ finalize (GObject *object)
 	g_io_channel_unref (priv->event_channel);
 	nl_socket_free (priv->nlh);
 
+	for (i = 0; i < _EVENT_SOCKET_NUM; i++) {
+		if (!priv->event_sockets[i].sk)
+			continue;
+		g_source_remove (priv->event_sockets[i].id);
+		g_io_channel_unref (priv->event_sockets[i].channel);
+		nl_socket_free (priv->event_sockets[i].sk);
+	}
+
+	_LOGD ("netlink: received %"G_GUINT64_FORMAT" messages with %"G_GUINT64_FORMAT" allocations for receive buffers",
+	       priv->recv_stats.n_msgs,
+	       priv->recv_stats.n_allocs);
+	g_free (priv->recv_buf.buf);
+
+	g_free (priv->route_ignore.tables);
+	g_free (priv->route_compact.tables);
+
+	if (priv->route_resync.ifindexes)
+		g_array_unref (priv->route_resync.ifindexes);
+
 	if (priv->sysctl_get_prev_values) {
 		sysctl_clear_cache_list = g_slist_remove (sysctl_clear_cache_list, object);
 		g_hash_table_destroy (priv->sysctl_get_prev_values);
@@ -9013,10 +10224,34 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
 	NMPlatformClass *platform_class = NM_PLATFORM_CLASS (klass);
 
+	object_class->set_property = set_property;
 	object_class->constructed = constructed;
 	object_class->dispose = dispose;
 	object_class->finalize = finalize;
 
+	obj_properties[PROP_IGNORE_ROUTE_TABLES] =
+	    g_param_spec_string (NM_LINUX_PLATFORM_IGNORE_ROUTE_TABLES, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	obj_properties[PROP_IGNORE_ROUTE_PROTOCOLS] =
+	    g_param_spec_string (NM_LINUX_PLATFORM_IGNORE_ROUTE_PROTOCOLS, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	obj_properties[PROP_COMPACT_ROUTE_TABLES] =
+	    g_param_spec_string (NM_LINUX_PLATFORM_COMPACT_ROUTE_TABLES, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
+
 	platform_class->sysctl_set = sysctl_set;
 	platform_class->sysctl_get = sysctl_get;
 
@@ -9024,6 +10259,7 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->link_delete = link_delete;
 
 	platform_class->link_refresh = link_refresh;
+	platform_class->link_refresh_all = link_refresh_all;
 
 	platform_class->link_set_netns = link_set_netns;
 
@@ -9107,7 +10343,10 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->ip6_address_delete = ip6_address_delete;
 
 	platform_class->ip_route_add = ip_route_add;
+	platform_class->ip_route_batch = ip_route_batch;
 	platform_class->ip_route_get = ip_route_get;
+	platform_class->ip_route_refresh = ip_route_refresh;
+	platform_class->ip_route_refresh_pending = ip_route_refresh_pending;
 
 	platform_class->routing_rule_add = routing_rule_add;
 
@@ -30,6 +30,10 @@
 #define NM_IS_LINUX_PLATFORM_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), NM_TYPE_LINUX_PLATFORM))
 #define NM_LINUX_PLATFORM_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), NM_TYPE_LINUX_PLATFORM, NMLinuxPlatformClass))
 
+#define NM_LINUX_PLATFORM_IGNORE_ROUTE_TABLES    "ignore-route-tables"
+#define NM_LINUX_PLATFORM_IGNORE_ROUTE_PROTOCOLS "ignore-route-protocols"
+#define NM_LINUX_PLATFORM_COMPACT_ROUTE_TABLES   "compact-route-tables"
+
 typedef struct _NMLinuxPlatform NMLinuxPlatform;
 typedef struct _NMLinuxPlatformClass NMLinuxPlatformClass;
 
@@ -39,4 +43,8 @@ NMPlatform *nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support
 
 void nm_linux_platform_setup (void);
 
+void nm_linux_platform_setup_full (const char *ignore_route_tables,
+                                   const char *ignore_route_protocols,
+                                   const char *compact_route_tables);
+
 #endif /* __NETWORKMANAGER_LINUX_PLATFORM_H__ */
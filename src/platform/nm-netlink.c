@@ -42,15 +42,9 @@
 #define NETLINK_EXT_ACK         11
 #endif
 
-struct nl_msg {
-	int                     nm_protocol;
-	struct sockaddr_nl      nm_src;
-	struct sockaddr_nl      nm_dst;
-	struct ucred            nm_creds;
-	struct nlmsghdr *       nm_nlh;
-	size_t                  nm_size;
-	bool                    nm_creds_has:1;
-};
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK  12
+#endif
 
 struct nl_sock {
 	struct sockaddr_nl      s_local;
@@ -305,6 +299,17 @@ nlmsg_alloc_convert (struct nlmsghdr *hdr)
 	return nm;
 }
 
+struct nl_msg *
+nlmsg_stackinit (struct nl_msg *msg, struct nlmsghdr *hdr)
+{
+	*msg = (struct nl_msg) {
+		.nm_protocol = -1,
+		.nm_size = NLMSG_ALIGN (hdr->nlmsg_len),
+		.nm_nlh = hdr,
+	};
+	return msg;
+}
+
 struct nl_msg *
 nlmsg_alloc_simple (int nlmsgtype, int flags)
 {
@@ -1005,6 +1010,22 @@ nl_socket_set_ext_ack (struct nl_sock *sk, gboolean enable)
 	return 0;
 }
 
+int
+nl_socket_set_strict_check (struct nl_sock *sk, gboolean enable)
+{
+	int err, val;
+
+	if (sk->s_fd == -1)
+		return -NME_NL_BAD_SOCK;
+
+	val = !!enable;
+	err = setsockopt (sk->s_fd, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &val, sizeof (val));
+	if (err < 0)
+		return -nm_errno_from_native (errno);
+
+	return 0;
+}
+
 void nl_socket_disable_msg_peek (struct nl_sock *sk)
 {
 	sk->s_flags |= NL_MSG_PEEK_EXPLICIT;
@@ -1364,6 +1385,97 @@ int nl_send_auto (struct nl_sock *sk, struct nl_msg *msg)
 	return nl_send (sk, msg);
 }
 
+/**
+ * nl_recv_buf:
+ * @sk: the netlink socket
+ * @nla: (out): the source address of the received message
+ * @buf: the buffer to receive into
+ * @buf_len: the size of @buf
+ * @out_creds: (allow-none) (out): the credentials of the sender
+ * @out_creds_has: (allow-none) (out): whether @out_creds is set
+ *
+ * Like nl_recv(), but receives into a buffer provided by the caller,
+ * so that no memory gets allocated. Contrary to nl_recv(), there is no
+ * MSG_PEEK support to grow the buffer. If @buf is too small, the message
+ * is lost and -NME_NL_MSG_TRUNC is returned.
+ *
+ * Returns: the number of bytes received, or a negative error code.
+ */
+int
+nl_recv_buf (struct nl_sock *sk,
+             struct sockaddr_nl *nla,
+             unsigned char *buf,
+             size_t buf_len,
+             struct ucred *out_creds,
+             gboolean *out_creds_has)
+{
+	union {
+		struct cmsghdr hdr;
+		guint8 data[CMSG_SPACE (sizeof (struct ucred))];
+	} cmsg_buf;
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = buf_len,
+	};
+	struct msghdr msg = {
+		.msg_name = (void *) nla,
+		.msg_namelen = sizeof (struct sockaddr_nl),
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	struct ucred tmpcreds;
+	gboolean tmpcreds_has = FALSE;
+	ssize_t n;
+	int errsv;
+
+	nm_assert (nla);
+	nm_assert (buf && buf_len > 0);
+	nm_assert (!out_creds_has == !out_creds);
+
+	if (   out_creds
+	    && (sk->s_flags & NL_SOCK_PASSCRED)) {
+		msg.msg_control = &cmsg_buf;
+		msg.msg_controllen = sizeof (cmsg_buf);
+	}
+
+retry:
+	n = recvmsg (sk->s_fd, &msg, 0);
+	if (!n)
+		return 0;
+
+	if (n < 0) {
+		errsv = errno;
+		if (errsv == EINTR)
+			goto retry;
+		return -nm_errno_from_native (errsv);
+	}
+
+	if (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))
+		return -NME_NL_MSG_TRUNC;
+
+	if (msg.msg_namelen != sizeof (struct sockaddr_nl))
+		return -NME_UNSPEC;
+
+	if (msg.msg_control) {
+		struct cmsghdr *cmsg;
+
+		for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+			if (cmsg->cmsg_level != SOL_SOCKET)
+				continue;
+			if (cmsg->cmsg_type != SCM_CREDENTIALS)
+				continue;
+			memcpy (&tmpcreds, CMSG_DATA (cmsg), sizeof (tmpcreds));
+			tmpcreds_has = TRUE;
+			break;
+		}
+	}
+
+	if (out_creds && tmpcreds_has)
+		*out_creds = tmpcreds;
+	NM_SET_OUT (out_creds_has, tmpcreds_has);
+	return n;
+}
+
 int
 nl_recv (struct nl_sock *sk,
          struct sockaddr_nl *nla,
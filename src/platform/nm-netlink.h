@@ -21,6 +21,7 @@
 #ifndef __NM_NETLINK_H__
 #define __NM_NETLINK_H__
 
+#include <sys/socket.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <linux/genetlink.h>
@@ -390,6 +391,18 @@ nla_parse_nested (struct nlattr *tb[],
 
 /*****************************************************************************/
 
+/* The layout of struct nl_msg is public, so that a message can be placed
+ * on the stack with nlmsg_stackinit(). Otherwise, treat it as opaque. */
+struct nl_msg {
+	int                     nm_protocol;
+	struct sockaddr_nl      nm_src;
+	struct sockaddr_nl      nm_dst;
+	struct ucred            nm_creds;
+	struct nlmsghdr *       nm_nlh;
+	size_t                  nm_size;
+	bool                    nm_creds_has:1;
+};
+
 struct nl_msg *nlmsg_alloc (void);
 
 struct nl_msg *nlmsg_alloc_size (size_t max);
@@ -398,6 +411,10 @@ struct nl_msg *nlmsg_alloc_convert (struct nlmsghdr *hdr);
 
 struct nl_msg *nlmsg_alloc_simple (int nlmsgtype, int flags);
 
+/* Initializes @msg to wrap @hdr, without copying the message. Such
+ * a message must not be freed with nlmsg_free(). */
+struct nl_msg *nlmsg_stackinit (struct nl_msg *msg, struct nlmsghdr *hdr);
+
 void *nlmsg_reserve (struct nl_msg *n, size_t len, int pad);
 
 int nlmsg_append (struct nl_msg *n,
@@ -561,6 +578,13 @@ int nl_recv (struct nl_sock *sk,
              struct ucred *out_creds,
              gboolean *out_creds_has);
 
+int nl_recv_buf (struct nl_sock *sk,
+                 struct sockaddr_nl *nla,
+                 unsigned char *buf,
+                 size_t buf_len,
+                 struct ucred *out_creds,
+                 gboolean *out_creds_has);
+
 int nl_send (struct nl_sock *sk, struct nl_msg *msg);
 
 int nl_send_auto (struct nl_sock *sk, struct nl_msg *msg);
@@ -608,6 +632,8 @@ int nl_wait_for_ack (struct nl_sock *sk,
 
 int nl_socket_set_ext_ack (struct nl_sock *sk, gboolean enable);
 
+int nl_socket_set_strict_check (struct nl_sock *sk, gboolean enable);
+
 /*****************************************************************************/
 
 void *genlmsg_put (struct nl_msg *msg, uint32_t port, uint32_t seq, int family,
@@ -125,6 +125,10 @@ typedef struct _NMPlatformPrivate {
 	GHashTable *ip4_dev_route_blacklist_hash;
 	NMDedupMultiIndex *multi_idx;
 	NMPCache *cache;
+
+	/* devices that want their link statistics refreshed periodically. */
+	GHashTable *stats_watches;
+	CList stats_groups_lst_head;
 } NMPlatformPrivate;
 
 G_DEFINE_TYPE (NMPlatform, nm_platform, G_TYPE_OBJECT)
@@ -1276,6 +1280,164 @@ nm_platform_link_refresh (NMPlatform *self, int ifindex)
 	return TRUE;
 }
 
+/*****************************************************************************/
+
+typedef struct {
+	NMPlatform *self;
+	CList stats_groups_lst;
+	CList watches_lst_head;
+	guint refresh_rate_ms;
+	guint n_watches;
+	guint timeout_id;
+} StatsGroup;
+
+typedef struct {
+	StatsGroup *group;
+	CList watches_lst;
+	int ifindex;
+} StatsWatch;
+
+static gboolean
+_stats_group_timeout_cb (gpointer user_data)
+{
+	StatsGroup *group = user_data;
+	NMPlatform *self = group->self;
+	NMPlatformClass *klass = NM_PLATFORM_GET_CLASS (self);
+	const NMDedupMultiHeadEntry *head_entry;
+	gs_free int *ifindexes = NULL;
+	StatsWatch *watch;
+	guint n_links;
+	guint n;
+	guint i;
+
+	head_entry = nm_platform_lookup_obj_type (self, NMP_OBJECT_TYPE_LINK);
+	n_links = head_entry ? head_entry->len : 0;
+
+	/* One dump of all links is cheaper than requesting many links one by one.
+	 * Only if few of the links are watched, request them individually. */
+	if (   klass->link_refresh_all
+	    && group->n_watches > 1
+	    && group->n_watches * 4 >= n_links) {
+		_LOGT ("stats: refresh all links for %u watches (every %u ms)", group->n_watches, group->refresh_rate_ms);
+		klass->link_refresh_all (self);
+		return G_SOURCE_CONTINUE;
+	}
+
+	/* refreshing emits signals, and the handlers may change the watches.
+	 * Don't iterate the group while refreshing. */
+	ifindexes = g_new (int, group->n_watches);
+	n = 0;
+	c_list_for_each_entry (watch, &group->watches_lst_head, watches_lst)
+		ifindexes[n++] = watch->ifindex;
+
+	_LOGT ("stats: refresh %u links (every %u ms)", n, group->refresh_rate_ms);
+	for (i = 0; i < n; i++)
+		nm_platform_link_refresh (self, ifindexes[i]);
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+_stats_watch_unlink (StatsWatch *watch)
+{
+	StatsGroup *group = watch->group;
+
+	c_list_unlink (&watch->watches_lst);
+	watch->group = NULL;
+
+	nm_assert (group->n_watches > 0);
+	if (--group->n_watches > 0)
+		return;
+
+	nm_clear_g_source (&group->timeout_id);
+	c_list_unlink_stale (&group->stats_groups_lst);
+	g_slice_free (StatsGroup, group);
+}
+
+static void
+_stats_watch_free (gpointer data)
+{
+	StatsWatch *watch = data;
+
+	if (watch->group)
+		_stats_watch_unlink (watch);
+	g_slice_free (StatsWatch, watch);
+}
+
+/**
+ * nm_platform_link_stats_refresh_set:
+ * @self: platform instance
+ * @tag: an opaque pointer that identifies the watch, e.g. the device.
+ * @ifindex: the interface whose statistics shall be refreshed, or
+ *   zero to remove the watch.
+ * @refresh_rate_ms: the refresh interval, or zero to remove the watch.
+ *
+ * Periodically refresh the link (and its statistics) in the platform
+ * cache. Watches that share the same refresh rate are handled by one
+ * timer. On each tick the links are either requested individually, or
+ * with a single dump of all links, if that is cheaper. The updated
+ * counters are announced via the link-changed signal.
+ */
+void
+nm_platform_link_stats_refresh_set (NMPlatform *self,
+                                    gconstpointer tag,
+                                    int ifindex,
+                                    guint refresh_rate_ms)
+{
+	NMPlatformPrivate *priv;
+	StatsWatch *watch;
+	StatsGroup *group;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (tag);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	if (   ifindex <= 0
+	    || refresh_rate_ms == 0) {
+		if (priv->stats_watches)
+			g_hash_table_remove (priv->stats_watches, tag);
+		return;
+	}
+
+	if (!priv->stats_watches) {
+		priv->stats_watches = g_hash_table_new_full (nm_direct_hash,
+		                                             NULL,
+		                                             NULL,
+		                                             _stats_watch_free);
+	}
+
+	watch = g_hash_table_lookup (priv->stats_watches, tag);
+	if (watch) {
+		watch->ifindex = ifindex;
+		if (watch->group->refresh_rate_ms == refresh_rate_ms)
+			return;
+		_stats_watch_unlink (watch);
+	} else {
+		watch = g_slice_new0 (StatsWatch);
+		watch->ifindex = ifindex;
+		g_hash_table_insert (priv->stats_watches, (gpointer) tag, watch);
+	}
+
+	c_list_for_each_entry (group, &priv->stats_groups_lst_head, stats_groups_lst) {
+		if (group->refresh_rate_ms == refresh_rate_ms)
+			goto found;
+	}
+
+	group = g_slice_new0 (StatsGroup);
+	group->self = self;
+	group->refresh_rate_ms = refresh_rate_ms;
+	c_list_init (&group->watches_lst_head);
+	c_list_link_tail (&priv->stats_groups_lst_head, &group->stats_groups_lst);
+	group->timeout_id = g_timeout_add (refresh_rate_ms, _stats_group_timeout_cb, group);
+
+found:
+	watch->group = group;
+	group->n_watches++;
+	c_list_link_tail (&group->watches_lst_head, &watch->watches_lst);
+}
+
 int
 nm_platform_link_get_ifi_flags (NMPlatform *self,
                                 int ifindex,
@@ -4305,6 +4467,141 @@ nm_platform_ip_route_get_prune_list (NMPlatform *self,
 	return routes_prune;
 }
 
+static gboolean
+_ip_route_sync_check_add_result (NMPlatform *self,
+                                 int ifindex,
+                                 const NMPlatformVTableRoute *vt,
+                                 const NMPObject *conf_o,
+                                 int r,
+                                 gboolean gateway_route_added,
+                                 GPtrArray **out_temporary_not_available,
+                                 NMPObject **out_gateway_route,
+                                 gboolean *p_success)
+{
+	char sbuf1[sizeof (_nm_utils_to_string_buffer)];
+	char sbuf2[sizeof (_nm_utils_to_string_buffer)];
+	const NMDedupMultiEntry *plat_entry;
+	NMPObject *oo;
+
+	*out_gateway_route = NULL;
+
+	if (r >= 0)
+		return FALSE;
+
+	if (r == -EEXIST) {
+		/* Don't fail for EEXIST. It's not clear that the existing route
+		 * is identical to the one that we were about to add. However,
+		 * above we should have deleted conflicting (non-identical) routes. */
+		if (_LOGD_ENABLED ()) {
+			plat_entry = nm_platform_lookup_entry (self,
+			                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+			                                       conf_o);
+			if (!plat_entry) {
+				_LOG3D ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
+				        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
+			} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
+			                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
+			                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
+				_LOG3D ("route-sync: adding route %s failed due to existing (different!) route %s",
+				        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+				        nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
+			}
+		}
+		return FALSE;
+	}
+
+	if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
+		_LOG3D ("route-sync: ignore failure to add IPv%c route: %s: %s",
+		       vt->is_ip4 ? '4' : '6',
+		       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+		       nm_strerror (r));
+		return FALSE;
+	}
+
+	if (   r == -EINVAL
+	    && out_temporary_not_available
+	    && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
+		_LOG3D ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
+		        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+		        nm_strerror (r));
+		if (!*out_temporary_not_available)
+			*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
+		g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
+		return FALSE;
+	}
+
+	if (   !gateway_route_added
+	    && (   (   r == -ENETUNREACH
+	            && vt->is_ip4
+	            && !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway)
+	        || (   r == -EHOSTUNREACH
+	            && !vt->is_ip4
+	            && !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))) {
+		if (vt->is_ip4) {
+			const NMPlatformIP4Route *rt = NMP_OBJECT_CAST_IP4_ROUTE (conf_o);
+
+			oo = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE,
+			                     (const NMPlatformObject *) &((NMPlatformIP4Route) {
+			                         .ifindex = rt->ifindex,
+			                         .network = rt->gateway,
+			                         .plen = 32,
+			                         .metric = rt->metric,
+			                         .rt_source = rt->rt_source,
+			                         .table_coerced = rt->table_coerced,
+			                     }));
+		} else {
+			const NMPlatformIP6Route *rt = NMP_OBJECT_CAST_IP6_ROUTE (conf_o);
+
+			oo = nmp_object_new (NMP_OBJECT_TYPE_IP6_ROUTE,
+			                     (const NMPlatformObject *) &((NMPlatformIP6Route) {
+			                         .ifindex = rt->ifindex,
+			                         .network = rt->gateway,
+			                         .plen = 128,
+			                         .metric = rt->metric,
+			                         .rt_source = rt->rt_source,
+			                         .table_coerced = rt->table_coerced,
+			                     }));
+		}
+
+		_LOG3D ("route-sync: failure to add IPv%c route: %s: %s; try adding direct route to gateway %s",
+		        vt->is_ip4 ? '4' : '6',
+		        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+		        nm_strerror (r),
+		        nmp_object_to_string (oo, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
+
+		*out_gateway_route = oo;
+		return TRUE;
+	}
+
+	_LOG3W ("route-sync: failure to add IPv%c route: %s: %s",
+	       vt->is_ip4 ? '4' : '6',
+	       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+	       nm_strerror (r));
+	*p_success = FALSE;
+	return FALSE;
+}
+
+static void
+_ip_route_batch_op_clear (gpointer data)
+{
+	NMPlatformIPRouteBatchOp *op = data;
+
+	nm_clear_nmp_object (&op->obj);
+}
+
+/* the ops keep a reference to the objects. They might be owned by the
+ * cache, which can drop them while the batch reads netlink events. */
+#define _ip_route_batch_op_append(ops, _obj, _is_delete) \
+	G_STMT_START { \
+		NMPlatformIPRouteBatchOp _op = { \
+			.obj = nmp_object_ref (_obj), \
+			.flags = NMP_NLM_FLAG_APPEND | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE, \
+			.is_delete = (_is_delete), \
+		}; \
+		\
+		g_array_append_val ((ops), _op); \
+	} G_STMT_END
+
 /**
  * nm_platform_ip_route_sync:
  * @self: the #NMPlatform instance.
@@ -4320,6 +4617,9 @@ nm_platform_ip_route_get_prune_list (NMPlatform *self,
  * @out_temporary_not_available: (allow-none) (out): routes that could
  *   currently not be synced. The caller shall keep them and try later again.
  *
+ * The routes are sent to the platform in batches via nm_platform_ip_route_batch(),
+ * so that we don't need to wait for a response from kernel after each route.
+ *
  * Returns: %TRUE on success.
  */
 gboolean
@@ -4332,13 +4632,13 @@ nm_platform_ip_route_sync (NMPlatform *self,
 {
 	const NMPlatformVTableRoute *vt;
 	gs_unref_hashtable GHashTable *routes_idx = NULL;
+	gs_unref_array GArray *ops = NULL;
 	const NMPObject *conf_o;
 	const NMDedupMultiEntry *plat_entry;
 	guint i;
 	int i_type;
 	gboolean success = TRUE;
 	char sbuf1[sizeof (_nm_utils_to_string_buffer)];
-	char sbuf2[sizeof (_nm_utils_to_string_buffer)];
 	const gboolean IS_IPv4 = (addr_family == AF_INET);
 
 	nm_assert (NM_IS_PLATFORM (self));
@@ -4347,11 +4647,16 @@ nm_platform_ip_route_sync (NMPlatform *self,
 
 	vt = &nm_platform_vtable_route.vx[IS_IPv4];
 
+	ops = g_array_new (FALSE, FALSE, sizeof (NMPlatformIPRouteBatchOp));
+	g_array_set_clear_func (ops, _ip_route_batch_op_clear);
+
 	for (i_type = 0; routes && i_type < 2; i_type++) {
-		for (i = 0; i < routes->len; i++) {
-			int r, r2;
-			gboolean gateway_route_added = FALSE;
+		gs_unref_ptrarray GPtrArray *routes_retry = NULL;
+		gs_unref_ptrarray GPtrArray *routes_gateway = NULL;
 
+		g_array_set_size (ops, 0);
+
+		for (i = 0; i < routes->len; i++) {
 			conf_o = routes->pdata[i];
 
 #define VTABLE_IS_DEVICE_ROUTE(vt, o) (vt->is_ip4 \
@@ -4390,120 +4695,83 @@ nm_platform_ip_route_sync (NMPlatform *self,
 					continue;
 
 				/* we need to replace the existing route with a (slightly) different
-				 * one. Delete it first. */
-				if (!nm_platform_object_delete (self, plat_o)) {
-					/* ignore error. */
-				}
+				 * one. Delete it first. Failures to delete are ignored. */
+				_ip_route_batch_op_append (ops, plat_o, TRUE);
 			}
 
-sync_route_add:
-			r = nm_platform_ip_route_add (self,
-			                                NMP_NLM_FLAG_APPEND
-			                              | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-			                              conf_o);
-			if (r < 0) {
-				if (r == -EEXIST) {
-					/* Don't fail for EEXIST. It's not clear that the existing route
-					 * is identical to the one that we were about to add. However,
-					 * above we should have deleted conflicting (non-identical) routes. */
-					if (_LOGD_ENABLED ()) {
-						plat_entry = nm_platform_lookup_entry (self,
-						                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
-						                                       conf_o);
-						if (!plat_entry) {
-							_LOG3D ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
-							        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
-						} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
-						                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
-						                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
-							_LOG3D ("route-sync: adding route %s failed due to existing (different!) route %s",
-							        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-							        nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
-						}
-					}
-				} else if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
-					_LOG3D ("route-sync: ignore failure to add IPv%c route: %s: %s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_strerror (r));
-				} else if (   r == -EINVAL
-				           && out_temporary_not_available
-				           && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
-					_LOG3D ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
-					        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					        nm_strerror (r));
-					if (!*out_temporary_not_available)
-						*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
-					g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
-				} else if (   !gateway_route_added
-				           && (   (   r == -ENETUNREACH
-				                   && vt->is_ip4
-				                   && !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway)
-				               || (   r == -EHOSTUNREACH
-				                   && !vt->is_ip4
-				                   && !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))) {
-					NMPObject oo;
-
-					if (vt->is_ip4) {
-						const NMPlatformIP4Route *rt = NMP_OBJECT_CAST_IP4_ROUTE (conf_o);
-
-						nmp_object_stackinit (&oo,
-						                      NMP_OBJECT_TYPE_IP4_ROUTE,
-						                      &((NMPlatformIP4Route) {
-						                          .ifindex = rt->ifindex,
-						                          .network = rt->gateway,
-						                          .plen = 32,
-						                          .metric = rt->metric,
-						                          .rt_source = rt->rt_source,
-						                          .table_coerced = rt->table_coerced,
-						                      }));
-					} else {
-						const NMPlatformIP6Route *rt = NMP_OBJECT_CAST_IP6_ROUTE (conf_o);
-
-						nmp_object_stackinit (&oo,
-						                      NMP_OBJECT_TYPE_IP6_ROUTE,
-						                      &((NMPlatformIP6Route) {
-						                          .ifindex = rt->ifindex,
-						                          .network = rt->gateway,
-						                          .plen = 128,
-						                          .metric = rt->metric,
-						                          .rt_source = rt->rt_source,
-						                          .table_coerced = rt->table_coerced,
-						                      }));
-					}
-
-					_LOG3D ("route-sync: failure to add IPv%c route: %s: %s; try adding direct route to gateway %s",
-					        vt->is_ip4 ? '4' : '6',
-					        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					        nm_strerror (r),
-					        nmp_object_to_string (&oo, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
-
-					r2 = nm_platform_ip_route_add (self,
-					                                 NMP_NLM_FLAG_APPEND
-					                               | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-					                               &oo);
-
-					if (r2 < 0) {
-						_LOG3D ("route-sync: failure to add gateway IPv%c route: %s: %s",
-						        vt->is_ip4 ? '4' : '6',
-						        nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-						        nm_strerror (r2));
-					}
-
-					gateway_route_added = TRUE;
-					goto sync_route_add;
-				} else {
-					_LOG3W ("route-sync: failure to add IPv%c route: %s: %s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_strerror (r));
-					success = FALSE;
+			_ip_route_batch_op_append (ops, conf_o, FALSE);
+		}
+
+		nm_platform_ip_route_batch (self, (NMPlatformIPRouteBatchOp *) ops->data, ops->len);
+
+		for (i = 0; i < ops->len; i++) {
+			const NMPlatformIPRouteBatchOp *op = &g_array_index (ops, NMPlatformIPRouteBatchOp, i);
+			NMPObject *gateway_route;
+
+			if (op->is_delete)
+				continue;
+
+			if (_ip_route_sync_check_add_result (self,
+			                                     ifindex,
+			                                     vt,
+			                                     op->obj,
+			                                     op->result,
+			                                     FALSE,
+			                                     out_temporary_not_available,
+			                                     &gateway_route,
+			                                     &success)) {
+				if (!routes_retry) {
+					routes_retry = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+					routes_gateway = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
 				}
+				g_ptr_array_add (routes_retry, (gpointer) nmp_object_ref (op->obj));
+				g_ptr_array_add (routes_gateway, gateway_route);
 			}
 		}
+
+		if (!routes_retry)
+			continue;
+
+		/* some routes failed because their gateway is not directly reachable.
+		 * Add direct routes to the gateways, and retry the failed routes afterwards. */
+		g_array_set_size (ops, 0);
+		for (i = 0; i < routes_gateway->len; i++)
+			_ip_route_batch_op_append (ops, routes_gateway->pdata[i], FALSE);
+		for (i = 0; i < routes_retry->len; i++)
+			_ip_route_batch_op_append (ops, routes_retry->pdata[i], FALSE);
+
+		nm_platform_ip_route_batch (self, (NMPlatformIPRouteBatchOp *) ops->data, ops->len);
+
+		for (i = 0; i < routes_gateway->len; i++) {
+			const NMPlatformIPRouteBatchOp *op = &g_array_index (ops, NMPlatformIPRouteBatchOp, i);
+
+			if (op->result < 0) {
+				_LOG3D ("route-sync: failure to add gateway IPv%c route: %s: %s",
+				        vt->is_ip4 ? '4' : '6',
+				        nmp_object_to_string (routes_retry->pdata[i], NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+				        nm_strerror (op->result));
+			}
+		}
+		for (i = 0; i < routes_retry->len; i++) {
+			const NMPlatformIPRouteBatchOp *op = &g_array_index (ops, NMPlatformIPRouteBatchOp, routes_gateway->len + i);
+			NMPObject *gateway_route;
+
+			_ip_route_sync_check_add_result (self,
+			                                 ifindex,
+			                                 vt,
+			                                 op->obj,
+			                                 op->result,
+			                                 TRUE,
+			                                 out_temporary_not_available,
+			                                 &gateway_route,
+			                                 &success);
+			nm_assert (!gateway_route);
+		}
 	}
 
 	if (routes_prune) {
+		g_array_set_size (ops, 0);
+
 		for (i = 0; i < routes_prune->len; i++) {
 			const NMPObject *prune_o;
 
@@ -4521,10 +4789,11 @@ sync_route_add:
 			                               prune_o))
 				continue;
 
-			if (!nm_platform_object_delete (self, prune_o)) {
-				/* ignore error... */
-			}
+			_ip_route_batch_op_append (ops, prune_o, TRUE);
 		}
+
+		/* failures to delete are ignored... */
+		nm_platform_ip_route_batch (self, (NMPlatformIPRouteBatchOp *) ops->data, ops->len);
 	}
 
 	return success;
@@ -4543,6 +4812,13 @@ nm_platform_ip_route_flush (NMPlatform *self,
 	                                   AF_INET,
 	                                   AF_INET6));
 
+	/* the prune lists are based on the cache. If we know that it is out
+	 * of date for this interface, request its routes first. */
+	if (   ifindex > 0
+	    && nm_platform_ip_route_refresh_pending (self, addr_family, ifindex)
+	    && !nm_platform_ip_route_refresh (self, addr_family, ifindex))
+		success = FALSE;
+
 	if (NM_IN_SET (addr_family, AF_UNSPEC, AF_INET)) {
 		gs_unref_ptrarray GPtrArray *routes_prune = NULL;
 
@@ -4700,6 +4976,69 @@ nm_platform_ip6_route_add (NMPlatform *self,
 	return _ip_route_add (self, flags, AF_INET6, route);
 }
 
+/**
+ * nm_platform_ip_route_batch:
+ * @self: the #NMPlatform instance.
+ * @ops: (allow-none): the list of route additions and deletions.
+ * @n_ops: the number of entries in @ops.
+ *
+ * Adds and deletes the routes in @ops, in the given order. Contrary to
+ * calling nm_platform_ip_route_add() and nm_platform_object_delete() for
+ * each route, the platform implementation may send all requests at once
+ * and only afterwards collect the responses. The outcome of each operation
+ * is stored in the @result field of the respective entry.
+ */
+void
+nm_platform_ip_route_batch (NMPlatform *self,
+                            NMPlatformIPRouteBatchOp *ops,
+                            guint n_ops)
+{
+	char sbuf[sizeof (_nm_utils_to_string_buffer)];
+	guint i;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	nm_assert (ops || n_ops == 0);
+
+	if (n_ops == 0)
+		return;
+
+	if (!klass->ip_route_batch) {
+		for (i = 0; i < n_ops; i++) {
+			if (ops[i].is_delete) {
+				ops[i].result =   nm_platform_object_delete (self, ops[i].obj)
+				                ? 0
+				                : -NME_PL_NETLINK;
+			} else
+				ops[i].result = nm_platform_ip_route_add (self, ops[i].flags, ops[i].obj);
+		}
+		return;
+	}
+
+	if (_LOGD_ENABLED ()) {
+		for (i = 0; i < n_ops; i++) {
+			const NMPObject *obj = ops[i].obj;
+			int ifindex = NMP_OBJECT_CAST_IP_ROUTE (obj)->ifindex;
+
+			nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ROUTE,
+			                                                 NMP_OBJECT_TYPE_IP6_ROUTE));
+
+			if (ops[i].is_delete) {
+				_LOG3D ("%s: delete %s",
+				        NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+				        nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof (sbuf)));
+			} else {
+				_LOG3D ("route: %-10s IPv%c route: %s",
+				        _nmp_nlm_flag_to_string (ops[i].flags & NMP_NLM_FLAG_FMASK),
+				        NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP4_ROUTE ? '4' : '6',
+				        nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof (sbuf)));
+			}
+		}
+	}
+
+	klass->ip_route_batch (self, ops, n_ops);
+}
+
 gboolean
 nm_platform_object_delete (NMPlatform *self,
                            const NMPObject *obj)
@@ -4732,6 +5071,65 @@ nm_platform_object_delete (NMPlatform *self,
 
 /*****************************************************************************/
 
+/**
+ * nm_platform_ip_route_refresh:
+ * @self: platform instance
+ * @addr_family: AF_INET, AF_INET6 or AF_UNSPEC for both
+ * @ifindex: the interface index
+ *
+ * Synchronously reload the routes of @ifindex into the cache, without
+ * requesting the routes of other interfaces.
+ *
+ * Returns: %FALSE if requesting the routes failed.
+ */
+gboolean
+nm_platform_ip_route_refresh (NMPlatform *self,
+                              int addr_family,
+                              int ifindex)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (NM_IN_SET (addr_family, AF_UNSPEC,
+	                                              AF_INET,
+	                                              AF_INET6), FALSE);
+
+	if (klass->ip_route_refresh)
+		return klass->ip_route_refresh (self, addr_family, ifindex);
+
+	return TRUE;
+}
+
+/**
+ * nm_platform_ip_route_refresh_pending:
+ * @self: platform instance
+ * @addr_family: AF_INET, AF_INET6 or AF_UNSPEC for both
+ * @ifindex: the interface index
+ *
+ * This does not request anything from kernel.
+ *
+ * Returns: %TRUE if the cached routes of @ifindex are known to be
+ *   out of date, for example because we lost route events. Then
+ *   call nm_platform_ip_route_refresh() before relying on them.
+ */
+gboolean
+nm_platform_ip_route_refresh_pending (NMPlatform *self,
+                                      int addr_family,
+                                      int ifindex)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (NM_IN_SET (addr_family, AF_UNSPEC,
+	                                              AF_INET,
+	                                              AF_INET6), FALSE);
+
+	if (klass->ip_route_refresh_pending)
+		return klass->ip_route_refresh_pending (self, addr_family, ifindex);
+
+	return FALSE;
+}
+
 int
 nm_platform_ip_route_get (NMPlatform *self,
                           int addr_family,
@@ -7973,6 +8371,7 @@ static void
 nm_platform_init (NMPlatform *self)
 {
 	self->_priv = G_TYPE_INSTANCE_GET_PRIVATE (self, NM_TYPE_PLATFORM, NMPlatformPrivate);
+	c_list_init (&self->_priv->stats_groups_lst_head);
 }
 
 static GObject *
@@ -8007,6 +8406,8 @@ finalize (GObject *object)
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_check_id);
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_gc_timeout_id);
 	g_clear_pointer (&priv->ip4_dev_route_blacklist_hash, g_hash_table_unref);
+	g_clear_pointer (&priv->stats_watches, g_hash_table_unref);
+	nm_assert (c_list_is_empty (&priv->stats_groups_lst_head));
 	g_clear_object (&self->_netns);
 	nm_dedup_multi_index_unref (priv->multi_idx);
 	nmp_cache_free (priv->cache);
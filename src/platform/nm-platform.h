@@ -913,6 +913,22 @@ int _nm_platform_kernel_support_init (NMPlatformKernelSupportType type,
 
 /*****************************************************************************/
 
+/* One entry for nm_platform_ip_route_batch(). The caller sets @obj, @flags
+ * and @is_delete, the platform fills in @result (0 on success or a negative
+ * errno). For deletions, a route that is already gone counts as success.
+ *
+ * The caller must hold a reference to @obj for the duration of the batch.
+ * The platform cache processes events while the batch is in progress,
+ * so a cached object may otherwise be freed before its request is sent. */
+typedef struct {
+	const NMPObject *obj;
+	NMPNlmFlags flags;
+	bool is_delete;
+	int result;
+} NMPlatformIPRouteBatchOp;
+
+/*****************************************************************************/
+
 struct _NMPlatformPrivate;
 
 struct _NMPlatform {
@@ -938,6 +954,7 @@ typedef struct {
 	gboolean (*link_delete) (NMPlatform *, int ifindex);
 
 	gboolean (*link_refresh) (NMPlatform *, int ifindex);
+	void (*link_refresh_all) (NMPlatform *);
 
 	gboolean (*link_set_netns) (NMPlatform *, int ifindex, int netns_fd);
 
@@ -1100,11 +1117,20 @@ typedef struct {
 	                     NMPNlmFlags flags,
 	                     int addr_family,
 	                     const NMPlatformIPRoute *route);
+	void (*ip_route_batch) (NMPlatform *self,
+	                        NMPlatformIPRouteBatchOp *ops,
+	                        guint n_ops);
 	int (*ip_route_get) (NMPlatform *self,
 	                     int addr_family,
 	                     gconstpointer address,
 	                     int oif_ifindex,
 	                     NMPObject **out_route);
+	gboolean (*ip_route_refresh) (NMPlatform *self,
+	                              int addr_family,
+	                              int ifindex);
+	gboolean (*ip_route_refresh_pending) (NMPlatform *self,
+	                                      int addr_family,
+	                                      int ifindex);
 
 	int (*routing_rule_add) (NMPlatform *self,
 	                         NMPNlmFlags flags,
@@ -1370,6 +1396,10 @@ gboolean nm_platform_link_supports_slaves (NMPlatform *self, int ifindex);
 const char *nm_platform_link_get_type_name (NMPlatform *self, int ifindex);
 
 gboolean nm_platform_link_refresh (NMPlatform *self, int ifindex);
+void nm_platform_link_stats_refresh_set (NMPlatform *self,
+                                         gconstpointer tag,
+                                         int ifindex,
+                                         guint refresh_rate_ms);
 void nm_platform_process_events (NMPlatform *self);
 
 const NMPlatformLink *nm_platform_process_events_ensure_link (NMPlatform *self,
@@ -1594,6 +1624,10 @@ int nm_platform_ip_route_add (NMPlatform *self,
 int nm_platform_ip4_route_add (NMPlatform *self, NMPNlmFlags flags, const NMPlatformIP4Route *route);
 int nm_platform_ip6_route_add (NMPlatform *self, NMPNlmFlags flags, const NMPlatformIP6Route *route);
 
+void nm_platform_ip_route_batch (NMPlatform *self,
+                                 NMPlatformIPRouteBatchOp *ops,
+                                 guint n_ops);
+
 GPtrArray *nm_platform_ip_route_get_prune_list (NMPlatform *self,
                                                 int addr_family,
                                                 int ifindex,
@@ -1616,6 +1650,13 @@ int nm_platform_ip_route_get (NMPlatform *self,
                               int oif_ifindex,
                               NMPObject **out_route);
 
+gboolean nm_platform_ip_route_refresh (NMPlatform *self,
+                                       int addr_family,
+                                       int ifindex);
+gboolean nm_platform_ip_route_refresh_pending (NMPlatform *self,
+                                               int addr_family,
+                                               int ifindex);
+
 int nm_platform_routing_rule_add (NMPlatform *self,
                                   NMPNlmFlags flags,
                                   const NMPlatformRoutingRule *routing_rule);
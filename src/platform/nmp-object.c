@@ -59,6 +59,11 @@
 typedef struct {
 	NMDedupMultiIdxType parent;
 	NMPCacheIdType cache_id_type;
+
+	/* only for NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX. Routes in these
+	 * tables are not indexed. The array is owned by the NMPCache. */
+	const guint32 *compact_route_tables;
+	guint compact_route_tables_len;
 } DedupMultiIdxType;
 
 struct _NMPCache {
@@ -84,6 +89,8 @@ struct _NMPCache {
 	 * Don't bother, use _idx_type_get() instead! */
 	DedupMultiIdxType idx_types[NMP_CACHE_ID_TYPE_MAX];
 
+	guint32 *compact_route_tables;
+
 	gboolean use_udev;
 };
 
@@ -305,6 +312,26 @@ _idx_obj_id_equal (const NMDedupMultiIdxType *idx_type,
 	return nmp_object_id_equal (o_a, o_b);
 }
 
+static gboolean
+_idx_obj_is_compact_route (const DedupMultiIdxType *idx_type,
+                           const NMPObject *obj)
+{
+	guint32 table;
+	guint i;
+
+	if (   idx_type->compact_route_tables_len == 0
+	    || !NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                              NMP_OBJECT_TYPE_IP6_ROUTE))
+		return FALSE;
+
+	table = nm_platform_route_table_uncoerce (NMP_OBJECT_CAST_IP_ROUTE (obj)->table_coerced, TRUE);
+	for (i = 0; i < idx_type->compact_route_tables_len; i++) {
+		if (idx_type->compact_route_tables[i] == table)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 static guint
 _idx_obj_part (const DedupMultiIdxType *idx_type,
                const NMPObject *obj_a,
@@ -356,27 +383,6 @@ _idx_obj_part (const DedupMultiIdxType *idx_type,
 		/* just return 1, to indicate that obj_a is partitionable by this idx_type. */
 		return 1;
 
-	case NMP_CACHE_ID_TYPE_DEFAULT_ROUTES:
-		if (   !NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_a), NMP_OBJECT_TYPE_IP4_ROUTE,
-		                                                NMP_OBJECT_TYPE_IP6_ROUTE)
-		    || !NM_PLATFORM_IP_ROUTE_IS_DEFAULT (&obj_a->ip_route)
-		    || !nmp_object_is_visible (obj_a)) {
-			if (h)
-				nm_hash_update_val (h, obj_a);
-			return 0;
-		}
-		if (obj_b) {
-			return    NMP_OBJECT_GET_TYPE (obj_a) == NMP_OBJECT_GET_TYPE (obj_b)
-			       && NM_PLATFORM_IP_ROUTE_IS_DEFAULT (&obj_b->ip_route)
-			       && nmp_object_is_visible (obj_b);
-		}
-		if (h) {
-			nm_hash_update_vals (h,
-			                     idx_type->cache_id_type,
-			                     NMP_OBJECT_GET_TYPE (obj_a));
-		}
-		return 1;
-
 	case NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX:
 		if (   !NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_a), NMP_OBJECT_TYPE_IP4_ADDRESS,
 		                                                NMP_OBJECT_TYPE_IP6_ADDRESS,
@@ -384,7 +390,8 @@ _idx_obj_part (const DedupMultiIdxType *idx_type,
 		                                                NMP_OBJECT_TYPE_IP6_ROUTE,
 		                                                NMP_OBJECT_TYPE_QDISC,
 		                                                NMP_OBJECT_TYPE_TFILTER)
-		    || !nmp_object_is_visible (obj_a)) {
+		    || !nmp_object_is_visible (obj_a)
+		    || _idx_obj_is_compact_route (idx_type, obj_a)) {
 			if (h)
 				nm_hash_update_val (h, obj_a);
 			return 0;
@@ -393,7 +400,8 @@ _idx_obj_part (const DedupMultiIdxType *idx_type,
 		if (obj_b) {
 			return    NMP_OBJECT_GET_TYPE (obj_a) == NMP_OBJECT_GET_TYPE (obj_b)
 			       && NMP_OBJECT_CAST_OBJ_WITH_IFINDEX (obj_a)->ifindex == NMP_OBJECT_CAST_OBJ_WITH_IFINDEX (obj_b)->ifindex
-			       && nmp_object_is_visible (obj_b);
+			       && nmp_object_is_visible (obj_b)
+			       && !_idx_obj_is_compact_route (idx_type, obj_b);
 		}
 		if (h) {
 			nm_hash_update_vals (h,
@@ -1702,7 +1710,6 @@ static const guint8 _supported_cache_ids_ipx_address[] = {
 static const guint8 _supported_cache_ids_ipx_route[] = {
 	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
 	NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX,
-	NMP_CACHE_ID_TYPE_DEFAULT_ROUTES,
 	NMP_CACHE_ID_TYPE_ROUTES_BY_WEAK_ID,
 	0,
 };
@@ -2045,22 +2052,6 @@ nmp_lookup_init_object (NMPLookup *lookup,
 	return _L (lookup);
 }
 
-const NMPLookup *
-nmp_lookup_init_route_default (NMPLookup *lookup,
-                               NMPObjectType obj_type)
-{
-	NMPObject *o;
-
-	nm_assert (lookup);
-	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE,
-	                                NMP_OBJECT_TYPE_IP6_ROUTE));
-
-	o = _nmp_object_stackinit_from_type (&lookup->selector_obj, obj_type);
-	o->ip_route.ifindex = 1;
-	lookup->cache_id_type = NMP_CACHE_ID_TYPE_DEFAULT_ROUTES;
-	return _L (lookup);
-}
-
 const NMPLookup *
 nmp_lookup_init_route_by_weak_id (NMPLookup *lookup,
                                   const NMPObject *obj)
@@ -2978,9 +2969,10 @@ nmp_cache_update_link_master_connected (NMPCache *cache,
 
 /*****************************************************************************/
 
-void
-nmp_cache_dirty_set_all_main (NMPCache *cache,
-                              const NMPLookup *lookup)
+static void
+_cache_dirty_set_all_main (NMPCache *cache,
+                           const NMPLookup *lookup,
+                           gboolean dirty)
 {
 	const NMDedupMultiHeadEntry *head_entry;
 	NMDedupMultiIter iter;
@@ -2996,10 +2988,24 @@ nmp_cache_dirty_set_all_main (NMPCache *cache,
 
 		main_entry = nmp_cache_reresolve_main_entry (cache, iter.current, lookup);
 
-		nm_dedup_multi_entry_set_dirty (main_entry, TRUE);
+		nm_dedup_multi_entry_set_dirty (main_entry, dirty);
 	}
 }
 
+void
+nmp_cache_dirty_set_all_main (NMPCache *cache,
+                              const NMPLookup *lookup)
+{
+	_cache_dirty_set_all_main (cache, lookup, TRUE);
+}
+
+void
+nmp_cache_dirty_unset_all_main (NMPCache *cache,
+                                const NMPLookup *lookup)
+{
+	_cache_dirty_set_all_main (cache, lookup, FALSE);
+}
+
 /*****************************************************************************/
 
 NMPCache *
@@ -3017,6 +3023,43 @@ nmp_cache_new (NMDedupMultiIndex *multi_idx, gboolean use_udev)
 	return cache;
 }
 
+/**
+ * nmp_cache_set_compact_route_tables:
+ * @cache: the cache, which must not yet contain any routes
+ * @tables: (allow-none): the route tables
+ * @len: the number of tables
+ *
+ * Routes in @tables are still cached, but not indexed by
+ * NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX. That saves an index entry per route,
+ * but looking up the routes of an interface no longer finds them.
+ */
+void
+nmp_cache_set_compact_route_tables (NMPCache *cache,
+                                    const guint32 *tables,
+                                    guint len)
+{
+	DedupMultiIdxType *idx_type;
+	NMPLookup lookup;
+
+	nm_assert (cache);
+	nm_assert (!nmp_cache_lookup (cache, nmp_lookup_init_obj_type (&lookup, NMP_OBJECT_TYPE_IP4_ROUTE)));
+	nm_assert (!nmp_cache_lookup (cache, nmp_lookup_init_obj_type (&lookup, NMP_OBJECT_TYPE_IP6_ROUTE)));
+
+	idx_type = (DedupMultiIdxType *) _idx_type_get (cache, NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX);
+
+	nm_clear_g_free (&cache->compact_route_tables);
+	if (len > 0)
+		cache->compact_route_tables = g_memdup (tables, sizeof (guint32) * len);
+	idx_type->compact_route_tables = cache->compact_route_tables;
+	idx_type->compact_route_tables_len = len;
+}
+
+gboolean
+nmp_cache_has_compact_route_tables (const NMPCache *cache)
+{
+	return !!cache->compact_route_tables;
+}
+
 void
 nmp_cache_free (NMPCache *cache)
 {
@@ -3027,9 +3070,59 @@ nmp_cache_free (NMPCache *cache)
 
 	nm_dedup_multi_index_unref (cache->multi_idx);
 
+	g_free (cache->compact_route_tables);
+
 	g_slice_free (NMPCache, cache);
 }
 
+/* GHashTable in set mode keeps a key and a hash per slot. */
+#define _STATS_HASH_SLOT_SIZE (sizeof (gpointer) + sizeof (guint))
+
+void
+nmp_cache_get_stats (const NMPCache *cache,
+                     NMPCacheStats stats[static (NMP_OBJECT_TYPE_MAX + 1)])
+{
+	NMPCacheIdType cache_id_type;
+
+	nm_assert (cache);
+
+	memset (stats, 0, sizeof (NMPCacheStats) * (NMP_OBJECT_TYPE_MAX + 1));
+
+	for (cache_id_type = NMP_CACHE_ID_TYPE_NONE + 1; cache_id_type <= NMP_CACHE_ID_TYPE_MAX; cache_id_type++) {
+		const NMDedupMultiIdxType *idx_type = _idx_type_get (cache, cache_id_type);
+		const NMDedupMultiHeadEntry *head_entry;
+
+		c_list_for_each_entry (head_entry, &idx_type->lst_idx_head, lst_idx) {
+			const NMDedupMultiEntry *entry;
+			NMPObjectType obj_type = NMP_OBJECT_TYPE_UNKNOWN;
+
+			c_list_for_each_entry (entry, &head_entry->lst_entries_head, lst_entries) {
+				const NMPObject *obj = entry->obj;
+
+				obj_type = NMP_OBJECT_GET_TYPE (obj);
+				nm_assert (obj_type > NMP_OBJECT_TYPE_UNKNOWN && obj_type <= NMP_OBJECT_TYPE_MAX);
+
+				stats[obj_type].n_entries++;
+				stats[obj_type].bytes_entries += sizeof (NMDedupMultiEntry) + _STATS_HASH_SLOT_SIZE;
+
+				if (cache_id_type == NMP_CACHE_ID_TYPE_OBJECT_TYPE) {
+					/* every object is in exactly one partition of this index. Count the
+					 * object here, together with its slot in the table of interned
+					 * objects. */
+					stats[obj_type].n_objects++;
+					stats[obj_type].bytes_objects +=   G_STRUCT_OFFSET (NMPObject, object)
+					                                 + NMP_OBJECT_GET_CLASS (obj)->sizeof_data
+					                                 + _STATS_HASH_SLOT_SIZE;
+				}
+			}
+
+			/* all entries of one head have the same type. */
+			stats[obj_type].n_heads++;
+			stats[obj_type].bytes_heads += sizeof (NMDedupMultiHeadEntry) + _STATS_HASH_SLOT_SIZE;
+		}
+	}
+}
+
 /*****************************************************************************/
 
 void
@@ -156,12 +156,9 @@ typedef enum { /*< skip >*/
 	/* index for the link objects by ifname. */
 	NMP_CACHE_ID_TYPE_LINK_BY_IFNAME,
 
-	/* indices for the visible default-routes, ignoring ifindex.
-	 * This index only contains two partitions: all visible default-routes,
-	 * separate for IPv4 and IPv6. */
-	NMP_CACHE_ID_TYPE_DEFAULT_ROUTES,
-
-	/* all the objects that have an ifindex (by object-type) for an ifindex. */
+	/* all the objects that have an ifindex (by object-type) for an ifindex.
+	 * Routes in the tables of nmp_cache_set_compact_route_tables() are
+	 * not part of this index. */
 	NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX,
 
 	/* Consider all the destination fields of a route, that is, the ID without the ifindex
@@ -769,8 +766,6 @@ const NMPLookup *nmp_lookup_init_link_by_ifname (NMPLookup *lookup,
 const NMPLookup *nmp_lookup_init_object (NMPLookup *lookup,
                                          NMPObjectType obj_type,
                                          int ifindex);
-const NMPLookup *nmp_lookup_init_route_default (NMPLookup *lookup,
-                                                NMPObjectType obj_type);
 const NMPLookup *nmp_lookup_init_route_by_weak_id (NMPLookup *lookup,
                                                    const NMPObject *obj);
 const NMPLookup *nmp_lookup_init_ip4_route_by_weak_id (NMPLookup *lookup,
@@ -904,10 +899,33 @@ nmp_cache_reresolve_main_entry (NMPCache *cache,
 
 void nmp_cache_dirty_set_all_main (NMPCache *cache,
                                    const NMPLookup *lookup);
+void nmp_cache_dirty_unset_all_main (NMPCache *cache,
+                                     const NMPLookup *lookup);
 
 NMPCache *nmp_cache_new (NMDedupMultiIndex *multi_idx, gboolean use_udev);
 void nmp_cache_free (NMPCache *cache);
 
+void nmp_cache_set_compact_route_tables (NMPCache *cache,
+                                         const guint32 *tables,
+                                         guint len);
+gboolean nmp_cache_has_compact_route_tables (const NMPCache *cache);
+
+/* Memory accounting of the cache, per object type. The sizes are
+ * approximations: they count the objects, the index entries and
+ * the slots in the hash tables of the NMDedupMultiIndex, but not
+ * additional allocations of an object (like the udev device of a link). */
+typedef struct {
+	guint n_objects;
+	guint n_entries;
+	guint n_heads;
+	gsize bytes_objects;
+	gsize bytes_entries;
+	gsize bytes_heads;
+} NMPCacheStats;
+
+void nmp_cache_get_stats (const NMPCache *cache,
+                          NMPCacheStats stats[static (NMP_OBJECT_TYPE_MAX + 1)]);
+
 static inline void
 ASSERT_nmp_cache_ops (const NMPCache *cache,
                       NMPCacheOpsType ops_type,
@@ -1010,28 +1028,6 @@ nm_platform_lookup_object_clone (NMPlatform *platform,
 	return nm_platform_lookup_clone (platform, &lookup, predicate, user_data);
 }
 
-static inline const NMDedupMultiHeadEntry *
-nm_platform_lookup_route_default (NMPlatform *platform,
-                                  NMPObjectType obj_type)
-{
-	NMPLookup lookup;
-
-	nmp_lookup_init_route_default (&lookup, obj_type);
-	return nm_platform_lookup (platform, &lookup);
-}
-
-static inline GPtrArray *
-nm_platform_lookup_route_default_clone (NMPlatform *platform,
-                                        NMPObjectType obj_type,
-                                        NMPObjectPredicateFunc predicate,
-                                        gpointer user_data)
-{
-	NMPLookup lookup;
-
-	nmp_lookup_init_route_default (&lookup, obj_type);
-	return nm_platform_lookup_clone (platform, &lookup, predicate, user_data);
-}
-
 static inline const NMDedupMultiHeadEntry *
 nm_platform_lookup_ip4_route_by_weak_id (NMPlatform *platform,
                                          in_addr_t network,
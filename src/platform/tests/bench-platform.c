@@ -0,0 +1,478 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2019 Red Hat, Inc.
+ */
+
+/* Benchmarks for the event processing of NMPlatform.
+ *
+ * These are not run as part of "make check". With the linux platform
+ * the benchmark runs in a separate network namespace like the other
+ * platform tests. Routes are injected via a separate rtnetlink socket,
+ * so that the numbers measure how fast NMPlatform consumes the kernel
+ * notifications and updates its cache.
+ *
+ * The size of the benchmark can be tuned via environment variables:
+ *
+ *   NMTST_BENCH_ROUTES      number of routes to inject (default 10000).
+ *   NMTST_BENCH_BURST       number of routes injected before platform
+ *                           processes events (default 64).
+ *   NMTST_BENCH_ITERATIONS  number of address and link operations
+ *                           (default 500).
+ */
+
+#include "nm-default.h"
+
+#include <linux/rtnetlink.h>
+
+#include "platform/nm-netlink.h"
+#include "platform/nm-platform-private.h"
+
+#include "test-common.h"
+
+#define DEVICE_IFINDEX NMTSTP_ENV1_IFINDEX
+
+/* 10.0.0.0/8 gives room for 16M distinct /32 routes. */
+#define BENCH_ROUTE_NET_BASE 0x0A000000u
+
+/*****************************************************************************/
+
+static guint
+_bench_param (const char *name, guint min, guint max, guint fallback)
+{
+	return _nm_utils_ascii_str_to_int64 (g_getenv (name), 10, min, max, fallback);
+}
+
+static gsize
+_bench_rss (void)
+{
+	gs_free char *contents = NULL;
+	unsigned long size;
+	unsigned long resident;
+
+	if (   !g_file_get_contents ("/proc/self/statm", &contents, NULL, NULL)
+	    || sscanf (contents, "%lu %lu", &size, &resident) != 2)
+		return 0;
+	return resident * sysconf (_SC_PAGESIZE);
+}
+
+static int
+_bench_cmp_int64 (gconstpointer p_a, gconstpointer p_b, gpointer user_data)
+{
+	NM_CMP_DIRECT (*((const gint64 *) p_a), *((const gint64 *) p_b));
+	return 0;
+}
+
+static void
+_bench_report_latency (const char *name, gint64 *values, guint n)
+{
+	gint64 p50;
+	gint64 p99;
+
+	g_assert (n > 0);
+
+	g_qsort_with_data (values, n, sizeof (gint64), _bench_cmp_int64, NULL);
+	p50 = values[(n - 1) * 50 / 100];
+	p99 = values[(n - 1) * 99 / 100];
+
+	g_print ("bench: %s: latency p50 %"G_GINT64_FORMAT".%03u usec, p99 %"G_GINT64_FORMAT".%03u usec, max %"G_GINT64_FORMAT" usec\n",
+	         name,
+	         p50 / 1000, (guint) (p50 % 1000),
+	         p99 / 1000, (guint) (p99 % 1000),
+	         values[n - 1] / 1000);
+}
+
+static void
+_bench_report_rate (const char *name, const char *what, guint n, gint64 duration_ns)
+{
+	g_print ("bench: %s: %u %s in %"G_GINT64_FORMAT" msec (%.0f/sec)\n",
+	         name,
+	         n,
+	         what,
+	         duration_ns / NM_UTILS_NS_PER_MSEC,
+	         duration_ns > 0
+	           ? ((double) n) * NM_UTILS_NS_PER_SECOND / duration_ns
+	           : 0.0);
+}
+
+static void
+_bench_report_route_cache (const char *name, NMPlatform *platform)
+{
+	NMPCacheStats stats[NMP_OBJECT_TYPE_MAX + 1];
+	const NMPCacheStats *s = &stats[NMP_OBJECT_TYPE_IP4_ROUTE];
+
+	nmp_cache_get_stats (nm_platform_get_cache (platform), stats);
+	g_print ("bench: %s: cache holds %u IPv4 routes with %u index entries and %u index heads, %zu bytes per route\n",
+	         name,
+	         s->n_objects,
+	         s->n_entries,
+	         s->n_heads,
+	         s->n_objects > 0 ? (s->bytes_objects + s->bytes_entries + s->bytes_heads) / s->n_objects : (gsize) 0);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	guint n;
+	gint64 *ts_sent;
+	gint64 *ts_cached;
+	guint n_added;
+	guint n_removed;
+} BenchRouteData;
+
+static void
+_bench_route_changed_cb (NMPlatform *platform,
+                         int obj_type_i,
+                         int ifindex,
+                         const NMPlatformIP4Route *route,
+                         int change_type_i,
+                         BenchRouteData *data)
+{
+	const NMPlatformSignalChangeType change_type = change_type_i;
+	guint32 idx;
+
+	if (   ifindex != DEVICE_IFINDEX
+	    || route->plen != 32)
+		return;
+
+	idx = ntohl (route->network) - BENCH_ROUTE_NET_BASE;
+	if (idx >= data->n)
+		return;
+
+	if (change_type == NM_PLATFORM_SIGNAL_ADDED) {
+		data->ts_cached[idx] = nm_utils_get_monotonic_timestamp_ns ();
+		data->n_added++;
+	} else if (change_type == NM_PLATFORM_SIGNAL_REMOVED)
+		data->n_removed++;
+}
+
+static void
+_bench_route_inject_netlink (struct nl_sock *sk, int ifindex, guint32 table, in_addr_t network, gboolean add)
+{
+	nm_auto_nlmsg struct nl_msg *msg = NULL;
+	const struct rtmsg rtmsg = {
+		.rtm_family = AF_INET,
+		.rtm_dst_len = 32,
+		.rtm_table = RT_TABLE_UNSPEC,
+		.rtm_protocol = RTPROT_STATIC,
+		.rtm_scope = RT_SCOPE_LINK,
+		.rtm_type = RTN_UNICAST,
+	};
+
+	msg = nlmsg_alloc_simple (add ? RTM_NEWROUTE : RTM_DELROUTE,
+	                          add ? (NLM_F_CREATE | NLM_F_EXCL) : 0);
+	g_assert (msg);
+	g_assert_cmpint (nlmsg_append (msg, &rtmsg, sizeof (rtmsg), NLMSG_ALIGNTO), >=, 0);
+	g_assert_cmpint (nla_put (msg, RTA_DST, sizeof (network), &network), >=, 0);
+	g_assert_cmpint (nla_put_uint32 (msg, RTA_OIF, ifindex), >=, 0);
+	g_assert_cmpint (nla_put_uint32 (msg, RTA_TABLE, table), >=, 0);
+
+	g_assert_cmpint (nl_send_auto (sk, msg), >=, 0);
+	g_assert_cmpint (nl_wait_for_ack (sk, NULL), >=, 0);
+}
+
+static void
+_bench_route_inject_platform (NMPlatform *platform, int ifindex, in_addr_t network, gboolean add)
+{
+	const NMPlatformIP4Route r = {
+		.ifindex = ifindex,
+		.network = network,
+		.plen = 32,
+		.rt_source = NM_IP_CONFIG_SOURCE_USER,
+	};
+	NMPObject obj;
+
+	if (add) {
+		g_assert_cmpint (nm_platform_ip4_route_add (platform, NMP_NLM_FLAG_ADD, &r), ==, 0);
+		return;
+	}
+
+	nmp_object_stackinit (&obj, NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+	g_assert (nm_platform_object_delete (platform, &obj));
+}
+
+static void
+test_bench_route_inject (void)
+{
+	NMPlatform *platform = NM_PLATFORM_GET;
+	const int ifindex = DEVICE_IFINDEX;
+	struct nl_sock *sk = NULL;
+	BenchRouteData data = { };
+	gulong handler_id;
+	gint64 t_processing;
+	gint64 t_start;
+	gint64 t;
+	gsize rss_before;
+	gsize rss_after;
+	guint burst;
+	guint i;
+	guint j;
+
+	data.n = _bench_param ("NMTST_BENCH_ROUTES", 1, 10000000, 10000);
+	burst = _bench_param ("NMTST_BENCH_BURST", 1, 100000, 64);
+	data.ts_sent = g_new0 (gint64, data.n);
+	data.ts_cached = g_new0 (gint64, data.n);
+
+	if (nmtstp_is_root_test ()) {
+		/* inject the routes from outside of NMPlatform. The kernel queues the
+		 * notification before it acknowledges the request, so the time after
+		 * the ACK is an upper bound for when the event was emitted. */
+		sk = nl_socket_alloc ();
+		g_assert_cmpint (nl_connect (sk, NETLINK_ROUTE), ==, 0);
+	}
+
+	handler_id = g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (_bench_route_changed_cb), &data);
+
+	nm_platform_process_events (platform);
+	rss_before = _bench_rss ();
+
+	/* Only the time spent in platform counts for the event rate. With the fake
+	 * platform, injecting and processing is the same call. */
+	t_processing = 0;
+	t_start = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < data.n; i += burst) {
+		guint n_burst = MIN (burst, data.n - i);
+
+		for (j = i; j < i + n_burst; j++) {
+			const in_addr_t network = htonl (BENCH_ROUTE_NET_BASE + j);
+
+			if (sk) {
+				_bench_route_inject_netlink (sk, ifindex, RT_TABLE_MAIN, network, TRUE);
+				data.ts_sent[j] = nm_utils_get_monotonic_timestamp_ns ();
+			} else {
+				data.ts_sent[j] = nm_utils_get_monotonic_timestamp_ns ();
+				_bench_route_inject_platform (platform, ifindex, network, TRUE);
+				t_processing += nm_utils_get_monotonic_timestamp_ns () - data.ts_sent[j];
+			}
+		}
+
+		if (sk) {
+			t = nm_utils_get_monotonic_timestamp_ns ();
+			nm_platform_process_events (platform);
+			t_processing += nm_utils_get_monotonic_timestamp_ns () - t;
+		}
+	}
+	t = nm_utils_get_monotonic_timestamp_ns () - t_start;
+
+	/* with a full socket receive buffer, platform resyncs via a dump and
+	 * does not emit the signal for each route. Then the latency is not
+	 * meaningful, reduce NMTST_BENCH_BURST. */
+	g_assert_cmpint (data.n_added, ==, data.n);
+
+	rss_after = _bench_rss ();
+
+	_bench_report_rate ("route-add", "route events", data.n, t_processing);
+	_bench_report_rate ("route-add", "routes injected and cached", data.n, t);
+	for (i = 0; i < data.n; i++)
+		data.ts_cached[i] -= data.ts_sent[i];
+	_bench_report_latency ("route-add", data.ts_cached, data.n);
+	g_print ("bench: route-add: %zu bytes RSS per cached route (%zu KiB total)\n",
+	         rss_after > rss_before ? (rss_after - rss_before) / data.n : (gsize) 0,
+	         rss_after > rss_before ? (rss_after - rss_before) / 1024 : (gsize) 0);
+	_bench_report_route_cache ("route-add", platform);
+
+	t_processing = 0;
+	t_start = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < data.n; i += burst) {
+		guint n_burst = MIN (burst, data.n - i);
+
+		for (j = i; j < i + n_burst; j++) {
+			const in_addr_t network = htonl (BENCH_ROUTE_NET_BASE + j);
+
+			if (sk)
+				_bench_route_inject_netlink (sk, ifindex, RT_TABLE_MAIN, network, FALSE);
+			else {
+				t = nm_utils_get_monotonic_timestamp_ns ();
+				_bench_route_inject_platform (platform, ifindex, network, FALSE);
+				t_processing += nm_utils_get_monotonic_timestamp_ns () - t;
+			}
+		}
+
+		if (sk) {
+			t = nm_utils_get_monotonic_timestamp_ns ();
+			nm_platform_process_events (platform);
+			t_processing += nm_utils_get_monotonic_timestamp_ns () - t;
+		}
+	}
+	t = nm_utils_get_monotonic_timestamp_ns () - t_start;
+
+	g_assert_cmpint (data.n_removed, ==, data.n);
+
+	_bench_report_rate ("route-delete", "route events", data.n, t_processing);
+	_bench_report_rate ("route-delete", "routes removed and uncached", data.n, t);
+
+	g_signal_handler_disconnect (platform, handler_id);
+	nl_socket_free (sk);
+	g_free (data.ts_sent);
+	g_free (data.ts_cached);
+}
+
+/*****************************************************************************/
+
+#define BENCH_ROUTE_COMPACT_TABLE 1000
+
+static void
+test_bench_route_compact (void)
+{
+	const int ifindex = DEVICE_IFINDEX;
+	struct nl_sock *sk;
+	guint n;
+	guint i;
+
+	/* a routing daemon fills a table that NetworkManager does not manage.
+	 * Compare the cache of a platform instance that indexes these routes
+	 * per interface with one that keeps them compact. */
+	n = _bench_param ("NMTST_BENCH_ROUTES", 1, 10000000, 10000);
+
+	sk = nl_socket_alloc ();
+	g_assert_cmpint (nl_connect (sk, NETLINK_ROUTE), ==, 0);
+
+	for (i = 0; i < n; i++)
+		_bench_route_inject_netlink (sk, ifindex, BENCH_ROUTE_COMPACT_TABLE, htonl (BENCH_ROUTE_NET_BASE + i), TRUE);
+
+	for (i = 0; i < 2; i++) {
+		gs_unref_object NMPlatform *platform = NULL;
+		gint64 t;
+
+		t = nm_utils_get_monotonic_timestamp_ns ();
+		platform = g_object_new (NM_TYPE_LINUX_PLATFORM,
+		                         NM_PLATFORM_LOG_WITH_PTR, TRUE,
+		                         NM_PLATFORM_USE_UDEV, FALSE,
+		                         NM_PLATFORM_NETNS_SUPPORT, FALSE,
+		                         NM_LINUX_PLATFORM_COMPACT_ROUTE_TABLES, i == 0 ? NULL : G_STRINGIFY (BENCH_ROUTE_COMPACT_TABLE),
+		                         NULL);
+		t = nm_utils_get_monotonic_timestamp_ns () - t;
+
+		_bench_report_rate (i == 0 ? "route-indexed" : "route-compact", "routes dumped", n, t);
+		_bench_report_route_cache (i == 0 ? "route-indexed" : "route-compact", platform);
+	}
+
+	for (i = 0; i < n; i++)
+		_bench_route_inject_netlink (sk, ifindex, BENCH_ROUTE_COMPACT_TABLE, htonl (BENCH_ROUTE_NET_BASE + i), FALSE);
+
+	nl_socket_free (sk);
+}
+
+/*****************************************************************************/
+
+static void
+test_bench_address_churn (void)
+{
+	NMPlatform *platform = NM_PLATFORM_GET;
+	const int ifindex = DEVICE_IFINDEX;
+	gs_free gint64 *latency = NULL;
+	gint64 t_start;
+	gint64 t;
+	guint n;
+	guint i;
+
+	n = _bench_param ("NMTST_BENCH_ITERATIONS", 1, 1000000, 500);
+	latency = g_new (gint64, 2 * n);
+
+	/* every iteration adds a new address and removes it again. Each operation
+	 * waits for the kernel's response and the resulting cache update. */
+	t_start = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n; i++) {
+		const in_addr_t addr = htonl (0xC6120000u + (i % 0xFFFFu) + 1); /* from 198.18.0.0/15 (rfc2544) */
+
+		t = nm_utils_get_monotonic_timestamp_ns ();
+		g_assert (nm_platform_ip4_address_add (platform, ifindex, addr, 32, addr,
+		                                       NM_PLATFORM_LIFETIME_PERMANENT,
+		                                       NM_PLATFORM_LIFETIME_PERMANENT,
+		                                       0, NULL));
+		latency[2 * i] = nm_utils_get_monotonic_timestamp_ns () - t;
+
+		t = nm_utils_get_monotonic_timestamp_ns ();
+		g_assert (nm_platform_ip4_address_delete (platform, ifindex, addr, 32, addr));
+		latency[2 * i + 1] = nm_utils_get_monotonic_timestamp_ns () - t;
+	}
+	t = nm_utils_get_monotonic_timestamp_ns () - t_start;
+
+	_bench_report_rate ("address-churn", "address additions and removals", 2 * n, t);
+	_bench_report_latency ("address-churn", latency, 2 * n);
+}
+
+/*****************************************************************************/
+
+static void
+test_bench_link_storm (void)
+{
+	NMPlatform *platform = NM_PLATFORM_GET;
+	gs_free gint64 *latency = NULL;
+	gint64 t_start;
+	gint64 t;
+	guint n;
+	guint i;
+
+	n = _bench_param ("NMTST_BENCH_ITERATIONS", 1, 1000000, 500);
+	latency = g_new (gint64, 2 * n);
+
+	/* every iteration creates a veth pair and deletes it again, which
+	 * results in notifications for both links. */
+	t_start = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n; i++) {
+		const NMPlatformLink *plink = NULL;
+		char ifname[IFNAMSIZ];
+		char peer[IFNAMSIZ];
+		int ifindex;
+		int ifindex_peer;
+
+		nm_sprintf_buf (ifname, "nm-bench-%u", i % 100000);
+		nm_sprintf_buf (peer, "nm-benchp-%u", i % 100000);
+
+		t = nm_utils_get_monotonic_timestamp_ns ();
+		g_assert (NMTST_NM_ERR_SUCCESS (nm_platform_link_veth_add (platform, ifname, peer, &plink)));
+		latency[2 * i] = nm_utils_get_monotonic_timestamp_ns () - t;
+
+		g_assert (plink);
+		ifindex = plink->ifindex;
+		ifindex_peer = nm_platform_link_get_ifindex (platform, peer);
+		g_assert_cmpint (ifindex_peer, >, 0);
+
+		t = nm_utils_get_monotonic_timestamp_ns ();
+		g_assert (nm_platform_link_delete (platform, ifindex));
+		latency[2 * i + 1] = nm_utils_get_monotonic_timestamp_ns () - t;
+
+		/* the kernel deletes the peer together with the link. The fake platform
+		 * doesn't. */
+		if (nm_platform_link_get (platform, ifindex_peer))
+			g_assert (nm_platform_link_delete (platform, ifindex_peer));
+	}
+	t = nm_utils_get_monotonic_timestamp_ns () - t_start;
+
+	_bench_report_rate ("link-storm", "veth pair additions and removals", 2 * n, t);
+	_bench_report_latency ("link-storm", latency, 2 * n);
+}
+
+/*****************************************************************************/
+
+NMTstpSetupFunc const _nmtstp_setup_platform_func = SETUP;
+
+void
+_nmtstp_init_tests (int *argc, char ***argv)
+{
+	nmtst_init_with_logging (argc, argv, "WARN", "ALL");
+}
+
+void
+_nmtstp_setup_tests (void)
+{
+	nmtstp_env1_add_test_func ("/bench/route/inject", test_bench_route_inject, TRUE);
+	if (nmtstp_is_root_test ())
+		nmtstp_env1_add_test_func ("/bench/route/compact", test_bench_route_compact, TRUE);
+	nmtstp_env1_add_test_func ("/bench/address/churn", test_bench_address_churn, TRUE);
+	nmtstp_env1_add_test_func ("/bench/link/storm", test_bench_link_storm, TRUE);
+}
@@ -303,6 +303,18 @@ test_cache_link (void)
 	nmp_object_unref (objm1);
 	nmp_object_unref (obj_new);
 
+	/* the link is tracked by the index for all links and by ifname. */
+	{
+		NMPCacheStats stats[NMP_OBJECT_TYPE_MAX + 1];
+
+		nmp_cache_get_stats (cache, stats);
+		g_assert_cmpint (stats[NMP_OBJECT_TYPE_LINK].n_objects, ==, 1);
+		g_assert_cmpint (stats[NMP_OBJECT_TYPE_LINK].n_entries, ==, 2);
+		g_assert_cmpint (stats[NMP_OBJECT_TYPE_LINK].n_heads, ==, 2);
+		g_assert_cmpint (stats[NMP_OBJECT_TYPE_LINK].bytes_objects, >=, sizeof (NMPObjectLink));
+		g_assert_cmpint (stats[NMP_OBJECT_TYPE_IP4_ROUTE].n_objects, ==, 0);
+	}
+
 	/* updating the same link with identical value, has no effect. */
 	objm1 = nmp_object_new (NMP_OBJECT_TYPE_LINK, (NMPlatformObject *) &pl_link_2);
 	objm1->_link.netlink.is_in_netlink = TRUE;
@@ -537,6 +549,71 @@ test_cache_qdisc (void)
 	nmp_cache_free (cache);
 }
 
+static void
+test_cache_compact_routes (void)
+{
+	NMPCache *cache;
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = NULL;
+	NMPLookup lookup;
+	const NMDedupMultiHeadEntry *head_entry;
+	const guint32 compact_tables[] = { 1000 };
+	const NMPlatformIP4Route pl_route_main = {
+		.ifindex = 1,
+		.network = nmtst_inet4_from_string ("192.168.5.0"),
+		.plen = 24,
+	};
+	const NMPlatformIP4Route pl_route_compact = {
+		.ifindex = 1,
+		.network = nmtst_inet4_from_string ("192.168.6.0"),
+		.plen = 24,
+		.table_coerced = nm_platform_route_table_coerce (1000),
+	};
+	NMPCacheStats stats[NMP_OBJECT_TYPE_MAX + 1];
+	guint n_entries;
+	guint i;
+
+	/* the same routes, once indexed per interface and once compact. */
+	for (i = 0; i < 2; i++) {
+		multi_idx = nm_dedup_multi_index_new ();
+		cache = nmp_cache_new (multi_idx, nmtst_get_rand_int () % 2);
+
+		if (i == 1) {
+			nmp_cache_set_compact_route_tables (cache, compact_tables, G_N_ELEMENTS (compact_tables));
+			g_assert (nmp_cache_has_compact_route_tables (cache));
+		} else
+			g_assert (!nmp_cache_has_compact_route_tables (cache));
+
+		g_assert (nmp_cache_update_netlink_route (cache,
+		                                          nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (NMPlatformObject *) &pl_route_main),
+		                                          TRUE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_ADDED);
+		g_assert (nmp_cache_update_netlink_route (cache,
+		                                          nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (NMPlatformObject *) &pl_route_compact),
+		                                          TRUE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_ADDED);
+		ASSERT_nmp_cache_is_consistent (cache);
+
+		head_entry = nmp_cache_lookup (cache,
+		                               nmp_lookup_init_obj_type (&lookup,
+		                                                         NMP_OBJECT_TYPE_IP4_ROUTE));
+		g_assert (head_entry && head_entry->len == 2);
+
+		head_entry = nmp_cache_lookup (cache,
+		                               nmp_lookup_init_object (&lookup,
+		                                                       NMP_OBJECT_TYPE_IP4_ROUTE,
+		                                                       1));
+		g_assert (head_entry && head_entry->len == (i == 0 ? 2 : 1));
+
+		nmp_cache_get_stats (cache, stats);
+		g_assert_cmpint (stats[NMP_OBJECT_TYPE_IP4_ROUTE].n_objects, ==, 2);
+		if (i == 0)
+			n_entries = stats[NMP_OBJECT_TYPE_IP4_ROUTE].n_entries;
+		else
+			g_assert_cmpint (stats[NMP_OBJECT_TYPE_IP4_ROUTE].n_entries, ==, n_entries - 1);
+
+		nmp_cache_free (cache);
+		g_clear_pointer (&multi_idx, nm_dedup_multi_index_unref);
+	}
+}
+
 /*****************************************************************************/
 
 NMTST_DEFINE ();
@@ -584,6 +661,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/nmp-object/obj-base", test_obj_base);
 	g_test_add_func ("/nmp-object/cache_link", test_cache_link);
 	g_test_add_func ("/nmp-object/cache_qdisc", test_cache_qdisc);
+	g_test_add_func ("/nmp-object/cache_compact_routes", test_cache_compact_routes);
 
 	result = g_test_run ();
 
@@ -625,6 +625,83 @@ test_ip6_route_get (void)
 	nmtstp_wait_for_signal (NM_PLATFORM_GET, 50);
 }
 
+static gboolean
+_ip4_route_table_cached (NMPlatform *platform, guint32 table)
+{
+	NMDedupMultiIter iter;
+	const NMPObject *o;
+
+	nmp_cache_iter_for_each (&iter,
+	                         nm_platform_lookup_obj_type (platform, NMP_OBJECT_TYPE_IP4_ROUTE),
+	                         &o) {
+		if (nm_platform_route_table_uncoerce (o->ip_route.table_coerced, TRUE) == table)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+test_ip_route_get_ignored (void)
+{
+	int ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_object NMPlatform *platform = NULL;
+	nm_auto_nmpobj NMPObject *route4 = NULL;
+	nm_auto_nmpobj NMPObject *route6 = NULL;
+	in_addr_t a4;
+	const struct in6_addr *a6;
+	int result;
+
+	/* routes in ignored tables and with ignored protocols are not cached,
+	 * but a route lookup that resolves to them must still succeed. */
+	platform = g_object_new (NM_TYPE_LINUX_PLATFORM,
+	                         NM_PLATFORM_LOG_WITH_PTR, TRUE,
+	                         NM_PLATFORM_USE_UDEV, FALSE,
+	                         NM_PLATFORM_NETNS_SUPPORT, FALSE,
+	                         NM_LINUX_PLATFORM_IGNORE_ROUTE_TABLES, "1000",
+	                         NM_LINUX_PLATFORM_IGNORE_ROUTE_PROTOCOLS, "zebra",
+	                         NULL);
+
+	nmtstp_run_command_check ("ip route add 1.2.4.0/24 dev %s table 1000", DEVICE_NAME);
+	nmtstp_run_command_check ("ip rule add to 1.2.4.0/24 table 1000 priority 30001");
+	nmtstp_run_command_check ("ip -6 route add fd01:abce::/64 via fe80::99 dev %s proto zebra", DEVICE_NAME);
+
+	nm_platform_process_events (platform);
+	g_assert (!_ip4_route_table_cached (platform, 1000));
+	g_assert (!nmtstp_ip6_route_get (platform, ifindex, nmtst_inet6_from_string ("fd01:abce::"), 64, 0, NULL, 0));
+
+	a4 = nmtst_inet4_from_string ("1.2.4.1");
+	result = nm_platform_ip_route_get (platform,
+	                                   AF_INET,
+	                                   &a4,
+	                                   nmtst_get_rand_int () % 2 ? 0 : ifindex,
+	                                   &route4);
+	g_assert (NMTST_NM_ERR_SUCCESS (result));
+	g_assert (NMP_OBJECT_GET_TYPE (route4) == NMP_OBJECT_TYPE_IP4_ROUTE);
+	g_assert (NMP_OBJECT_CAST_IP4_ROUTE (route4)->ifindex == ifindex);
+	g_assert (NMP_OBJECT_CAST_IP4_ROUTE (route4)->network == a4);
+
+	a6 = nmtst_inet6_from_string ("fd01:abce::42");
+	result = nm_platform_ip_route_get (platform,
+	                                   AF_INET6,
+	                                   a6,
+	                                   nmtst_get_rand_int () % 2 ? 0 : ifindex,
+	                                   &route6);
+	g_assert (NMTST_NM_ERR_SUCCESS (result));
+	g_assert (NMP_OBJECT_GET_TYPE (route6) == NMP_OBJECT_TYPE_IP6_ROUTE);
+	g_assert (NMP_OBJECT_CAST_IP6_ROUTE (route6)->ifindex == ifindex);
+	nmtst_assert_ip6_address (&NMP_OBJECT_CAST_IP6_ROUTE (route6)->gateway, "fe80::99");
+
+	/* the replies did not enter the cache either. */
+	g_assert (!_ip4_route_table_cached (platform, 1000));
+	g_assert (!nmtstp_ip6_route_get (platform, ifindex, nmtst_inet6_from_string ("fd01:abce::"), 64, 0, NULL, 0));
+
+	nmtstp_run_command_check ("ip rule del to 1.2.4.0/24 table 1000 priority 30001");
+	nmtstp_run_command_check ("ip route flush table 1000");
+	nmtstp_run_command_check ("ip -6 route flush dev %s", DEVICE_NAME);
+
+	nmtstp_wait_for_signal (NM_PLATFORM_GET, 50);
+}
+
 static void
 test_ip6_route_options (gconstpointer test_data)
 {
@@ -1730,6 +1807,122 @@ again:
 
 /*****************************************************************************/
 
+static void
+test_ip4_route_sync_batch (void)
+{
+	const int ifindex = DEVICE_IFINDEX;
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+	nm_auto_nmpobj NMPObject *gw_route = NULL;
+	const guint N = 600;
+	guint i;
+
+	/* more routes than what is sent in one batch window. */
+	routes = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+	for (i = 0; i < N; i++) {
+		g_ptr_array_add (routes,
+		                 nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE,
+		                                 (const NMPlatformObject *) &((NMPlatformIP4Route) {
+		                                     .ifindex = ifindex,
+		                                     .network = htonl (0xC6120000u + i), /* from 198.18.0.0/15 (rfc2544) */
+		                                     .plen = 32,
+		                                     .metric = 22987,
+		                                     .rt_source = NM_IP_CONFIG_SOURCE_USER,
+		                                 })));
+	}
+
+	/* a route via a gateway that is not directly reachable. Route-sync must
+	 * add a direct route to the gateway and retry. */
+	g_ptr_array_add (routes,
+	                 nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                 (const NMPlatformObject *) &((NMPlatformIP4Route) {
+	                                     .ifindex = ifindex,
+	                                     .network = nmtst_inet4_from_string ("198.51.100.0"),
+	                                     .plen = 24,
+	                                     .gateway = nmtst_inet4_from_string ("203.0.113.1"),
+	                                     .metric = 22987,
+	                                     .rt_source = NM_IP_CONFIG_SOURCE_USER,
+	                                 })));
+	gw_route = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE,
+	                           (const NMPlatformObject *) &((NMPlatformIP4Route) {
+	                               .ifindex = ifindex,
+	                               .network = nmtst_inet4_from_string ("203.0.113.1"),
+	                               .plen = 32,
+	                               .metric = 22987,
+	                               .rt_source = NM_IP_CONFIG_SOURCE_USER,
+	                           }));
+
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, ifindex, routes, NULL, NULL));
+
+	for (i = 0; i < routes->len; i++)
+		g_assert (nm_platform_lookup_entry (NM_PLATFORM_GET, NMP_CACHE_ID_TYPE_OBJECT_TYPE, routes->pdata[i]));
+	g_assert (nm_platform_lookup_entry (NM_PLATFORM_GET, NMP_CACHE_ID_TYPE_OBJECT_TYPE, gw_route));
+
+	/* syncing the same routes again must succeed too. */
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, ifindex, routes, NULL, NULL));
+
+	routes_prune = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+	for (i = 0; i < routes->len; i++)
+		g_ptr_array_add (routes_prune, (gpointer) nmp_object_ref (routes->pdata[i]));
+	g_ptr_array_add (routes_prune, (gpointer) nmp_object_ref (gw_route));
+
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, ifindex, NULL, routes_prune, NULL));
+
+	for (i = 0; i < routes->len; i++)
+		g_assert (!nm_platform_lookup_entry (NM_PLATFORM_GET, NMP_CACHE_ID_TYPE_OBJECT_TYPE, routes->pdata[i]));
+	g_assert (!nm_platform_lookup_entry (NM_PLATFORM_GET, NMP_CACHE_ID_TYPE_OBJECT_TYPE, gw_route));
+}
+
+/*****************************************************************************/
+
+static guint
+_route_count (NMPObjectType obj_type, int ifindex)
+{
+	const NMDedupMultiHeadEntry *head_entry;
+
+	head_entry = nm_platform_lookup_object (NM_PLATFORM_GET, obj_type, ifindex);
+	return head_entry ? head_entry->len : 0;
+}
+
+static void
+test_ip_route_refresh (void)
+{
+	const int ifindex = DEVICE_IFINDEX;
+	const in_addr_t network = nmtst_inet4_from_string ("192.0.7.0");
+	const guint32 metric = 22988;
+	const NMPlatformIP4Route *r;
+	guint n_ip4;
+	guint n_ip6;
+	guint n_all;
+
+	nmtstp_ip4_route_add (NM_PLATFORM_GET, ifindex, NM_IP_CONFIG_SOURCE_USER, network, 24, INADDR_ANY, 0, metric, 0);
+	nmtstp_assert_ip4_route_exists (NULL, 1, DEVICE_NAME, network, 24, metric, 0);
+
+	n_ip4 = _route_count (NMP_OBJECT_TYPE_IP4_ROUTE, ifindex);
+	n_ip6 = _route_count (NMP_OBJECT_TYPE_IP6_ROUTE, ifindex);
+	n_all = _route_count (NMP_OBJECT_TYPE_IP4_ROUTE, 0);
+	g_assert_cmpint (n_ip4, >=, 1);
+
+	/* requesting the routes of the device does not change the cache,
+	 * neither for the device nor for other interfaces. */
+	g_assert (!nm_platform_ip_route_refresh_pending (NM_PLATFORM_GET, AF_UNSPEC, ifindex));
+	g_assert (nm_platform_ip_route_refresh (NM_PLATFORM_GET, AF_UNSPEC, ifindex));
+	nmtstp_assert_ip4_route_exists (NULL, 1, DEVICE_NAME, network, 24, metric, 0);
+	g_assert_cmpint (n_ip4, ==, _route_count (NMP_OBJECT_TYPE_IP4_ROUTE, ifindex));
+	g_assert_cmpint (n_ip6, ==, _route_count (NMP_OBJECT_TYPE_IP6_ROUTE, ifindex));
+	g_assert_cmpint (n_all, ==, _route_count (NMP_OBJECT_TYPE_IP4_ROUTE, 0));
+
+	g_assert (nm_platform_ip_route_refresh (NM_PLATFORM_GET, AF_INET, ifindex));
+	g_assert_cmpint (n_ip4, ==, _route_count (NMP_OBJECT_TYPE_IP4_ROUTE, ifindex));
+	g_assert_cmpint (n_ip6, ==, _route_count (NMP_OBJECT_TYPE_IP6_ROUTE, ifindex));
+
+	r = nmtstp_assert_ip4_route_exists (NULL, 1, DEVICE_NAME, network, 24, metric, 0);
+	g_assert (nm_platform_object_delete (NM_PLATFORM_GET, NMP_OBJECT_UP_CAST (r)));
+	nmtstp_assert_ip4_route_exists (NULL, 0, DEVICE_NAME, network, 24, metric, 0);
+}
+
+/*****************************************************************************/
+
 NMTstpSetupFunc const _nmtstp_setup_platform_func = SETUP;
 
 void
@@ -1757,7 +1950,10 @@ _nmtstp_setup_tests (void)
 		add_test_func_data ("/route/ip/1", test_ip, GINT_TO_POINTER (1));
 		add_test_func ("/route/ip4_route_get", test_ip4_route_get);
 		add_test_func ("/route/ip6_route_get", test_ip6_route_get);
+		add_test_func ("/route/ip_route_get_ignored", test_ip_route_get_ignored);
 		add_test_func ("/route/ip4_zero_gateway", test_ip4_zero_gateway);
+		add_test_func ("/route/ip4_route_sync_batch", test_ip4_route_sync_batch);
+		add_test_func ("/route/ip_route_refresh", test_ip_route_refresh);
 	}
 
 	if (nmtstp_is_root_test ()) {
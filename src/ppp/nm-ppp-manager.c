@@ -805,7 +805,7 @@ create_pppd_cmd_line (NMPPPManager *self,
 		nm_strv_ptrarray_add_string_dup (cmd, "noipv6");
 
 	ppp_debug = !!getenv ("NM_PPP_DEBUG");
-	if (nm_logging_enabled (LOGL_DEBUG, LOGD_PPP))
+	if (nm_logging_output_enabled (LOGL_DEBUG, LOGD_PPP))
 		ppp_debug = TRUE;
 
 	if (ppp_debug)
@@ -121,6 +121,11 @@ typedef struct _NMSettingsConnectionPrivate {
 	 */
 	NMConnection *agent_secrets;
 
+	/* The reply of GetSettings(), that is the connection without secrets
+	 * and with the current timestamp and seen-bssids. It is dropped whenever
+	 * one of them changes. */
+	GVariant *getsettings_cached;
+
 	char *filename;
 
 	GHashTable *seen_bssids; /* Up-to-date BSSIDs that's been seen for the connection */
@@ -169,6 +174,14 @@ static const NMDBusInterfaceInfoExtended interface_info_settings_connection;
 
 /*****************************************************************************/
 
+static void
+_getsettings_cached_clear (NMSettingsConnectionPrivate *priv)
+{
+	nm_clear_pointer (&priv->getsettings_cached, g_variant_unref);
+}
+
+/*****************************************************************************/
+
 NMConnection *
 nm_settings_connection_get_connection (NMSettingsConnection *self)
 {
@@ -427,6 +440,7 @@ _emit_updated (NMSettingsConnection *self, gboolean by_user)
 static void
 connection_changed_cb (NMConnection *connection, NMSettingsConnection *self)
 {
+	_getsettings_cached_clear (NM_SETTINGS_CONNECTION_GET_PRIVATE (self));
 	set_persist_mode (self, NM_SETTINGS_CONNECTION_PERSIST_MODE_UNSAVED);
 	_emit_updated (self, FALSE);
 }
@@ -638,6 +652,9 @@ nm_settings_connection_update (NMSettingsConnection *self,
 
 	g_signal_handlers_unblock_by_func (priv->connection, G_CALLBACK (connection_changed_cb), self);
 
+	/* connection_changed_cb() was blocked above. */
+	_getsettings_cached_clear (priv);
+
 	_emit_updated (self, TRUE);
 
 out:
@@ -658,40 +675,126 @@ out:
 	return TRUE;
 }
 
+/*****************************************************************************/
+
+/* The timestamps and seen-bssids databases are keyfiles with one
+ * key per connection UUID. They get loaded once and kept in memory.
+ * Modifications only mark them dirty and are written out with one atomic
+ * write after a short delay, or on shutdown via
+ * nm_settings_connection_flush_state_dbs(). */
+
+#define STATE_DB_FLUSH_DELAY_SEC 5
+
+typedef enum {
+	STATE_DB_TIMESTAMPS,
+	STATE_DB_SEEN_BSSIDS,
+	_STATE_DB_NUM,
+} StateDbType;
+
+typedef struct {
+	const char *const filename;
+	const char *const group;
+	GKeyFile *keyfile;
+	guint flush_id;
+	bool dirty:1;
+} StateDb;
+
+static StateDb _state_dbs[_STATE_DB_NUM] = {
+	[STATE_DB_TIMESTAMPS] = {
+		.filename = SETTINGS_TIMESTAMPS_FILE,
+		.group    = "timestamps",
+	},
+	[STATE_DB_SEEN_BSSIDS] = {
+		.filename = SETTINGS_SEEN_BSSIDS_FILE,
+		.group    = "seen-bssids",
+	},
+};
+
+static StateDb *
+_state_db_get (StateDbType type)
+{
+	StateDb *db = &_state_dbs[type];
+	gs_free_error GError *error = NULL;
+
+	if (G_LIKELY (db->keyfile))
+		return db;
+
+	db->keyfile = g_key_file_new ();
+	if (type == STATE_DB_SEEN_BSSIDS)
+		g_key_file_set_list_separator (db->keyfile, ',');
+	if (!g_key_file_load_from_file (db->keyfile, db->filename, G_KEY_FILE_KEEP_COMMENTS, &error)) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+			nm_log_warn (LOGD_SETTINGS, "settings-connection: error parsing %s file '%s': %s",
+			             db->group, db->filename, error->message);
+		}
+	}
+	return db;
+}
+
 static void
-remove_entry_from_db (NMSettingsConnection *self, const char* db_name)
+_state_db_flush (StateDb *db)
 {
-	GKeyFile *key_file;
-	const char *db_file;
+	gs_free_error GError *error = NULL;
+	gs_free char *data = NULL;
+	gsize len;
 
-	if (strcmp (db_name, "timestamps") == 0)
-		db_file = SETTINGS_TIMESTAMPS_FILE;
-	else if (strcmp (db_name, "seen-bssids") == 0)
-		db_file = SETTINGS_SEEN_BSSIDS_FILE;
-	else
+	nm_clear_g_source (&db->flush_id);
+
+	if (!db->dirty)
 		return;
+	db->dirty = FALSE;
 
-	key_file = g_key_file_new ();
-	if (g_key_file_load_from_file (key_file, db_file, G_KEY_FILE_KEEP_COMMENTS, NULL)) {
-		const char *connection_uuid;
-		char *data;
-		gsize len;
-		GError *error = NULL;
+	data = g_key_file_to_data (db->keyfile, &len, &error);
+	if (data)
+		g_file_set_contents (db->filename, data, len, &error);
+	if (error) {
+		nm_log_warn (LOGD_SETTINGS, "settings-connection: error saving %s to file '%s': %s",
+		             db->group, db->filename, error->message);
+	}
+}
 
-		connection_uuid = nm_settings_connection_get_uuid (self);
+static gboolean
+_state_db_flush_cb (gpointer user_data)
+{
+	StateDb *db = user_data;
 
-		g_key_file_remove_key (key_file, db_name, connection_uuid, NULL);
-		data = g_key_file_to_data (key_file, &len, &error);
-		if (data) {
-			g_file_set_contents (db_file, data, len, &error);
-			g_free (data);
-		}
-		if (error) {
-			_LOGW ("error writing %s file '%s': %s", db_name, db_file, error->message);
-			g_error_free (error);
-		}
+	db->flush_id = 0;
+	_state_db_flush (db);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_state_db_set_dirty (StateDb *db)
+{
+	db->dirty = TRUE;
+	if (db->flush_id == 0)
+		db->flush_id = g_timeout_add_seconds (STATE_DB_FLUSH_DELAY_SEC, _state_db_flush_cb, db);
+}
+
+/**
+ * nm_settings_connection_flush_state_dbs:
+ *
+ * Write pending changes of the timestamps and seen-bssids databases
+ * to disk.
+ */
+void
+nm_settings_connection_flush_state_dbs (void)
+{
+	guint i;
+
+	for (i = 0; i < _STATE_DB_NUM; i++) {
+		if (_state_dbs[i].keyfile)
+			_state_db_flush (&_state_dbs[i]);
 	}
-	g_key_file_free (key_file);
+}
+
+static void
+remove_entry_from_db (NMSettingsConnection *self, StateDbType type)
+{
+	StateDb *db = _state_db_get (type);
+
+	if (g_key_file_remove_key (db->keyfile, db->group, nm_settings_connection_get_uuid (self), NULL))
+		_state_db_set_dirty (db);
 }
 
 gboolean
@@ -719,11 +822,11 @@ nm_settings_connection_delete (NMSettingsConnection *self,
 	                                 for_agents);
 	g_object_unref (for_agents);
 
-	/* Remove timestamp from timestamps database file */
-	remove_entry_from_db (self, "timestamps");
+	/* Remove timestamp from timestamps database */
+	remove_entry_from_db (self, STATE_DB_TIMESTAMPS);
 
-	/* Remove connection from seen-bssids database file */
-	remove_entry_from_db (self, "seen-bssids");
+	/* Remove connection from seen-bssids database */
+	remove_entry_from_db (self, STATE_DB_SEEN_BSSIDS);
 
 	nm_settings_connection_signal_remove (self);
 	return TRUE;
@@ -1451,6 +1554,54 @@ check_writable (NMConnection *self, GError **error)
 	return TRUE;
 }
 
+/* Returns the (non-floating) reply for GetSettings(). Serializing the
+ * connection is expensive and clients tend to call GetSettings() on all
+ * profiles at once, so the result is cached until the connection changes. */
+static GVariant *
+_getsettings_cached_get (NMSettingsConnection *self)
+{
+	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
+	gs_unref_object NMConnection *dupl_con = NULL;
+	GVariant *settings;
+	NMSettingConnection *s_con;
+	NMSettingWireless *s_wifi;
+	guint64 timestamp = 0;
+	gs_free char **bssids = NULL;
+
+	if (priv->getsettings_cached)
+		return priv->getsettings_cached;
+
+	dupl_con = nm_simple_connection_new_clone (nm_settings_connection_get_connection (self));
+
+	/* Timestamp is not updated in connection's 'timestamp' property,
+	 * because it would force updating the connection and in turn
+	 * writing to /etc periodically, which we want to avoid. Rather real
+	 * timestamps are kept track of in a private variable. So, substitute
+	 * timestamp property with the real one here before returning the settings.
+	 */
+	nm_settings_connection_get_timestamp (self, &timestamp);
+	if (timestamp) {
+		s_con = nm_connection_get_setting_connection (dupl_con);
+		g_object_set (s_con, NM_SETTING_CONNECTION_TIMESTAMP, timestamp, NULL);
+	}
+	/* Seen BSSIDs are not updated in 802-11-wireless 'seen-bssids' property
+	 * from the same reason as timestamp. Thus we put it here to GetSettings()
+	 * return settings too.
+	 */
+	bssids = nm_settings_connection_get_seen_bssids (self);
+	s_wifi = nm_connection_get_setting_wireless (dupl_con);
+	if (bssids && bssids[0] && s_wifi)
+		g_object_set (s_wifi, NM_SETTING_WIRELESS_SEEN_BSSIDS, bssids, NULL);
+
+	/* Secrets should *never* be returned by the GetSettings method, they
+	 * get returned by the GetSecrets method which can be better
+	 * protected against leakage of secrets to unprivileged callers.
+	 */
+	settings = nm_connection_to_dbus (dupl_con, NM_CONNECTION_SERIALIZE_NO_SECRETS);
+	priv->getsettings_cached = g_variant_ref_sink (g_variant_new ("(@a{sa{sv}})", settings));
+	return priv->getsettings_cached;
+}
+
 static void
 get_settings_auth_cb (NMSettingsConnection *self,
                       GDBusMethodInvocation *context,
@@ -1460,44 +1611,8 @@ get_settings_auth_cb (NMSettingsConnection *self,
 {
 	if (error)
 		g_dbus_method_invocation_return_gerror (context, error);
-	else {
-		gs_unref_object NMConnection *dupl_con = NULL;
-		GVariant *settings;
-		NMSettingConnection *s_con;
-		NMSettingWireless *s_wifi;
-		guint64 timestamp = 0;
-		gs_free char **bssids = NULL;
-
-		dupl_con = nm_simple_connection_new_clone (nm_settings_connection_get_connection (self));
-
-		/* Timestamp is not updated in connection's 'timestamp' property,
-		 * because it would force updating the connection and in turn
-		 * writing to /etc periodically, which we want to avoid. Rather real
-		 * timestamps are kept track of in a private variable. So, substitute
-		 * timestamp property with the real one here before returning the settings.
-		 */
-		nm_settings_connection_get_timestamp (self, &timestamp);
-		if (timestamp) {
-			s_con = nm_connection_get_setting_connection (dupl_con);
-			g_object_set (s_con, NM_SETTING_CONNECTION_TIMESTAMP, timestamp, NULL);
-		}
-		/* Seen BSSIDs are not updated in 802-11-wireless 'seen-bssids' property
-		 * from the same reason as timestamp. Thus we put it here to GetSettings()
-		 * return settings too.
-		 */
-		bssids = nm_settings_connection_get_seen_bssids (self);
-		s_wifi = nm_connection_get_setting_wireless (dupl_con);
-		if (bssids && bssids[0] && s_wifi)
-			g_object_set (s_wifi, NM_SETTING_WIRELESS_SEEN_BSSIDS, bssids, NULL);
-
-		/* Secrets should *never* be returned by the GetSettings method, they
-		 * get returned by the GetSecrets method which can be better
-		 * protected against leakage of secrets to unprivileged callers.
-		 */
-		settings = nm_connection_to_dbus (dupl_con, NM_CONNECTION_SERIALIZE_NO_SECRETS);
-		g_dbus_method_invocation_return_value (context,
-		                                       g_variant_new ("(@a{sa{sv}})", settings));
-	}
+	else
+		g_dbus_method_invocation_return_value (context, _getsettings_cached_get (self));
 }
 
 static void
@@ -2324,6 +2439,31 @@ nm_settings_connection_cmp_autoconnect_priority_p_with_data (gconstpointer pa, g
 
 /*****************************************************************************/
 
+/* Bumped whenever the timestamp of any connection changes. Sorted lists
+ * of connections (nm_settings_connection_cmp_timestamp() and
+ * nm_settings_connection_cmp_autoconnect_priority()) that are cached
+ * across main loop iterations use it to detect that they are out of date. */
+static guint _timestamp_generation = 1;
+
+guint
+nm_settings_connection_get_timestamp_generation (void)
+{
+	return _timestamp_generation;
+}
+
+static void
+_timestamp_set (NMSettingsConnectionPrivate *priv, guint64 timestamp)
+{
+	if (   !priv->timestamp_set
+	    || priv->timestamp != timestamp) {
+		if (++_timestamp_generation == 0)
+			_timestamp_generation = 1;
+		_getsettings_cached_clear (priv);
+	}
+	priv->timestamp = timestamp;
+	priv->timestamp_set = TRUE;
+}
+
 /**
  * nm_settings_connection_get_timestamp:
  * @self: the #NMSettingsConnection
@@ -2360,46 +2500,24 @@ nm_settings_connection_update_timestamp (NMSettingsConnection *self,
                                          gboolean flush_to_disk)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	GKeyFile *timestamps_file;
-	char *data, *tmp;
-	gsize len;
-	GError *error = NULL;
+	char buf[30];
+	StateDb *db;
 
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (self));
 
 	/* Update timestamp in private storage */
-	priv->timestamp = timestamp;
-	priv->timestamp_set = TRUE;
+	_timestamp_set (priv, timestamp);
 
 	if (flush_to_disk == FALSE)
 		return;
 	if (nm_config_get_configure_and_quit (nm_config_get ()) == NM_CONFIG_CONFIGURE_AND_QUIT_INITRD)
 		return;
 
-	/* Save timestamp to timestamps database file */
-	timestamps_file = g_key_file_new ();
-	if (!g_key_file_load_from_file (timestamps_file, SETTINGS_TIMESTAMPS_FILE, G_KEY_FILE_KEEP_COMMENTS, &error)) {
-		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
-			_LOGW ("error parsing timestamps file '%s': %s", SETTINGS_TIMESTAMPS_FILE, error->message);
-		g_clear_error (&error);
-	}
-
-	connection_uuid = nm_settings_connection_get_uuid (self);
-	tmp = g_strdup_printf ("%" G_GUINT64_FORMAT, timestamp);
-	g_key_file_set_value (timestamps_file, "timestamps", connection_uuid, tmp);
-	g_free (tmp);
-
-	data = g_key_file_to_data (timestamps_file, &len, &error);
-	if (data) {
-		g_file_set_contents (SETTINGS_TIMESTAMPS_FILE, data, len, &error);
-		g_free (data);
-	}
-	if (error) {
-		_LOGW ("error saving timestamp to file '%s': %s", SETTINGS_TIMESTAMPS_FILE, error->message);
-		g_error_free (error);
-	}
-	g_key_file_free (timestamps_file);
+	/* Save timestamp to timestamps database */
+	db = _state_db_get (STATE_DB_TIMESTAMPS);
+	nm_sprintf_buf (buf, "%" G_GUINT64_FORMAT, timestamp);
+	g_key_file_set_value (db->keyfile, db->group, nm_settings_connection_get_uuid (self), buf);
+	_state_db_set_dirty (db);
 }
 
 /**
@@ -2413,22 +2531,15 @@ void
 nm_settings_connection_read_and_fill_timestamp (NMSettingsConnection *self)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	gs_unref_keyfile GKeyFile *timestamps_file = NULL;
 	gs_free_error GError *error = NULL;
 	gs_free char *tmp_str = NULL;
-	const char *connection_uuid;
 	gint64 timestamp;
+	StateDb *db;
 
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (self));
 
-	timestamps_file = g_key_file_new ();
-	if (!g_key_file_load_from_file (timestamps_file, SETTINGS_TIMESTAMPS_FILE, G_KEY_FILE_KEEP_COMMENTS, &error)) {
-		_LOGD ("failed to read connection timestamp: %s", error->message);
-		return;
-	}
-
-	connection_uuid = nm_settings_connection_get_uuid (self);
-	tmp_str = g_key_file_get_value (timestamps_file, "timestamps", connection_uuid, &error);
+	db = _state_db_get (STATE_DB_TIMESTAMPS);
+	tmp_str = g_key_file_get_value (db->keyfile, db->group, nm_settings_connection_get_uuid (self), &error);
 	if (!tmp_str) {
 		_LOGD ("failed to read connection timestamp: %s", error->message);
 		return;
@@ -2440,8 +2551,7 @@ nm_settings_connection_read_and_fill_timestamp (NMSettingsConnection *self)
 		return;
 	}
 
-	priv->timestamp = timestamp;
-	priv->timestamp_set = TRUE;
+	_timestamp_set (priv, timestamp);
 }
 
 /**
@@ -2504,14 +2614,11 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *self,
                                        const char *seen_bssid)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	GKeyFile *seen_bssids_file;
-	char *data, *bssid_str;
+	char *bssid_str;
 	const char **list;
-	gsize len;
-	GError *error = NULL;
 	GHashTableIter iter;
 	guint n;
+	StateDb *db;
 
 	g_return_if_fail (seen_bssid != NULL);
 
@@ -2521,6 +2628,7 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *self,
 	/* Add the new BSSID; let the hash take ownership of the allocated BSSID string */
 	bssid_str = g_strdup (seen_bssid);
 	g_hash_table_insert (priv->seen_bssids, bssid_str, bssid_str);
+	_getsettings_cached_clear (priv);
 
 	/* Build up a list of all the BSSIDs in string form */
 	n = 0;
@@ -2529,33 +2637,11 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *self,
 	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &bssid_str))
 		list[n++] = bssid_str;
 
-	/* Save BSSID to seen-bssids file */
-	seen_bssids_file = g_key_file_new ();
-	g_key_file_set_list_separator (seen_bssids_file, ',');
-	if (!g_key_file_load_from_file (seen_bssids_file, SETTINGS_SEEN_BSSIDS_FILE, G_KEY_FILE_KEEP_COMMENTS, &error)) {
-		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
-			_LOGW ("error parsing seen-bssids file '%s': %s",
-			       SETTINGS_SEEN_BSSIDS_FILE, error->message);
-		}
-		g_clear_error (&error);
-	}
-
-	connection_uuid = nm_settings_connection_get_uuid (self);
-	g_key_file_set_string_list (seen_bssids_file, "seen-bssids", connection_uuid, list, n);
+	/* Save BSSID to seen-bssids database */
+	db = _state_db_get (STATE_DB_SEEN_BSSIDS);
+	g_key_file_set_string_list (db->keyfile, db->group, nm_settings_connection_get_uuid (self), list, n);
 	g_free (list);
-
-	data = g_key_file_to_data (seen_bssids_file, &len, &error);
-	if (data) {
-		g_file_set_contents (SETTINGS_SEEN_BSSIDS_FILE, data, len, &error);
-		g_free (data);
-	}
-	g_key_file_free (seen_bssids_file);
-
-	if (error) {
-		_LOGW ("error saving seen-bssids to file '%s': %s",
-		       SETTINGS_SEEN_BSSIDS_FILE, error->message);
-		g_error_free (error);
-	}
+	_state_db_set_dirty (db);
 }
 
 /**
@@ -2569,20 +2655,16 @@ void
 nm_settings_connection_read_and_fill_seen_bssids (NMSettingsConnection *self)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	GKeyFile *seen_bssids_file;
-	char **tmp_strv = NULL;
+	char **tmp_strv;
 	gsize i, len = 0;
 	NMSettingWireless *s_wifi;
+	StateDb *db;
 
-	/* Get seen BSSIDs from database file */
-	seen_bssids_file = g_key_file_new ();
-	g_key_file_set_list_separator (seen_bssids_file, ',');
-	if (g_key_file_load_from_file (seen_bssids_file, SETTINGS_SEEN_BSSIDS_FILE, G_KEY_FILE_KEEP_COMMENTS, NULL)) {
-		connection_uuid = nm_settings_connection_get_uuid (self);
-		tmp_strv = g_key_file_get_string_list (seen_bssids_file, "seen-bssids", connection_uuid, &len, NULL);
-	}
-	g_key_file_free (seen_bssids_file);
+	_getsettings_cached_clear (priv);
+
+	/* Get seen BSSIDs from database */
+	db = _state_db_get (STATE_DB_SEEN_BSSIDS);
+	tmp_strv = g_key_file_get_string_list (db->keyfile, db->group, nm_settings_connection_get_uuid (self), &len, NULL);
 
 	/* Update connection's seen-bssids */
 	if (tmp_strv) {
@@ -2923,6 +3005,8 @@ dispose (GObject *object)
 
 	g_clear_pointer (&priv->seen_bssids, g_hash_table_destroy);
 
+	_getsettings_cached_clear (priv);
+
 	nm_clear_g_signal_handler (priv->session_monitor, &priv->session_changed_id);
 	g_clear_object (&priv->session_monitor);
 
@@ -220,6 +220,10 @@ int nm_settings_connection_cmp_timestamp_p_with_data (gconstpointer pa, gconstpo
 int nm_settings_connection_cmp_autoconnect_priority (NMSettingsConnection *a, NMSettingsConnection *b);
 int nm_settings_connection_cmp_autoconnect_priority_p_with_data (gconstpointer pa, gconstpointer pb, gpointer user_data);
 
+guint nm_settings_connection_get_timestamp_generation (void);
+
+void nm_settings_connection_flush_state_dbs (void);
+
 gboolean nm_settings_connection_get_timestamp (NMSettingsConnection *self,
                                                guint64 *out_timestamp);
 
@@ -121,6 +121,19 @@ typedef struct {
 
 	CList connections_lst_head;
 
+	/* Lookup indexes for the connections in connections_lst_head.
+	 *  - idx_by_uuid: UUID -> ConnIdxEntry
+	 *  - idx_by_interface_name, idx_by_type: key -> set of NMSettingsConnection */
+	GHashTable *idx_by_uuid;
+	GHashTable *idx_by_interface_name;
+	GHashTable *idx_by_type;
+
+	/* connection.type -> GPtrArray of the connections of that type, sorted
+	 * by autoconnect priority. Entries get dropped when the connections of
+	 * that type change and rebuilt lazily. */
+	GHashTable *autoconnect_sorted_by_type;
+	guint autoconnect_sorted_timestamp_generation;
+
 	NMSettingsConnection **connections_cached_list;
 	GSList *unmanaged_specs;
 	GSList *unrecognized_specs;
@@ -281,23 +294,168 @@ impl_settings_list_connections (NMDBusObject *obj,
 	                                       g_variant_new ("(^ao)", strv));
 }
 
+typedef struct {
+	NMSettingsConnection *sett_conn;
+
+	/* the keys under which the connection is indexed. They are
+	 * copies, so that we can remove the connection from the index
+	 * after the connection changed. */
+	char *uuid;
+	char *interface_name;
+	char *type;
+} ConnIdxEntry;
+
+static void
+_conn_idx_entry_free (gpointer data)
+{
+	ConnIdxEntry *entry = data;
+
+	g_free (entry->uuid);
+	g_free (entry->interface_name);
+	g_free (entry->type);
+	g_slice_free (ConnIdxEntry, entry);
+}
+
+static void
+_conn_idx_set_add (GHashTable **p_idx, const char *key, NMSettingsConnection *sett_conn)
+{
+	GHashTable *set;
+
+	if (!key)
+		return;
+
+	if (!*p_idx) {
+		*p_idx = g_hash_table_new_full (nm_str_hash, g_str_equal,
+		                                g_free, (GDestroyNotify) g_hash_table_unref);
+	}
+
+	set = g_hash_table_lookup (*p_idx, key);
+	if (!set) {
+		set = g_hash_table_new (nm_direct_hash, NULL);
+		g_hash_table_insert (*p_idx, g_strdup (key), set);
+	}
+	g_hash_table_add (set, sett_conn);
+}
+
+static void
+_conn_idx_set_remove (GHashTable *idx, const char *key, NMSettingsConnection *sett_conn)
+{
+	GHashTable *set;
+
+	if (!key)
+		return;
+
+	set = idx ? g_hash_table_lookup (idx, key) : NULL;
+	if (!set)
+		g_return_if_reached ();
+
+	if (!g_hash_table_remove (set, sett_conn))
+		nm_assert_not_reached ();
+	if (g_hash_table_size (set) == 0)
+		g_hash_table_remove (idx, key);
+}
+
+static void
+_autoconnect_sorted_invalidate (NMSettingsPrivate *priv, const char *connection_type)
+{
+	if (   connection_type
+	    && priv->autoconnect_sorted_by_type)
+		g_hash_table_remove (priv->autoconnect_sorted_by_type, connection_type);
+}
+
+static void
+_conn_idx_add (NMSettingsPrivate *priv, NMSettingsConnection *sett_conn)
+{
+	NMSettingConnection *s_con;
+	ConnIdxEntry *entry;
+
+	s_con = nm_connection_get_setting_connection (nm_settings_connection_get_connection (sett_conn));
+
+	entry = g_slice_new (ConnIdxEntry);
+	entry->sett_conn = sett_conn;
+	entry->uuid = g_strdup (nm_settings_connection_get_uuid (sett_conn));
+	entry->interface_name = g_strdup (s_con ? nm_setting_connection_get_interface_name (s_con) : NULL);
+	entry->type = g_strdup (s_con ? nm_setting_connection_get_connection_type (s_con) : NULL);
+
+	nm_assert (entry->uuid);
+	nm_assert (!priv->idx_by_uuid || !g_hash_table_contains (priv->idx_by_uuid, entry->uuid));
+
+	if (!priv->idx_by_uuid)
+		priv->idx_by_uuid = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, _conn_idx_entry_free);
+	g_hash_table_insert (priv->idx_by_uuid, entry->uuid, entry);
+
+	_conn_idx_set_add (&priv->idx_by_interface_name, entry->interface_name, sett_conn);
+	_conn_idx_set_add (&priv->idx_by_type, entry->type, sett_conn);
+	_autoconnect_sorted_invalidate (priv, entry->type);
+}
+
+static ConnIdxEntry *
+_conn_idx_lookup (NMSettingsPrivate *priv, NMSettingsConnection *sett_conn)
+{
+	ConnIdxEntry *entry;
+
+	/* the UUID of a connection cannot change once it's exported. */
+	entry = priv->idx_by_uuid
+	        ? g_hash_table_lookup (priv->idx_by_uuid, nm_settings_connection_get_uuid (sett_conn))
+	        : NULL;
+	nm_assert (!entry || entry->sett_conn == sett_conn);
+	return entry;
+}
+
+static void
+_conn_idx_remove (NMSettingsPrivate *priv, NMSettingsConnection *sett_conn)
+{
+	ConnIdxEntry *entry;
+
+	entry = _conn_idx_lookup (priv, sett_conn);
+	if (!entry)
+		g_return_if_reached ();
+
+	_conn_idx_set_remove (priv->idx_by_interface_name, entry->interface_name, sett_conn);
+	_conn_idx_set_remove (priv->idx_by_type, entry->type, sett_conn);
+	_autoconnect_sorted_invalidate (priv, entry->type);
+	g_hash_table_remove (priv->idx_by_uuid, entry->uuid);
+}
+
+static void
+_conn_idx_update (NMSettingsPrivate *priv, NMSettingsConnection *sett_conn)
+{
+	NMSettingConnection *s_con;
+	ConnIdxEntry *entry;
+
+	entry = _conn_idx_lookup (priv, sett_conn);
+	if (!entry)
+		g_return_if_reached ();
+
+	s_con = nm_connection_get_setting_connection (nm_settings_connection_get_connection (sett_conn));
+	if (   s_con
+	    && nm_streq0 (entry->interface_name, nm_setting_connection_get_interface_name (s_con))
+	    && nm_streq0 (entry->type, nm_setting_connection_get_connection_type (s_con))) {
+		/* the autoconnect priority might have changed. */
+		_autoconnect_sorted_invalidate (priv, entry->type);
+		return;
+	}
+
+	_conn_idx_remove (priv, sett_conn);
+	_conn_idx_add (priv, sett_conn);
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
 	NMSettingsPrivate *priv;
-	NMSettingsConnection *candidate;
+	ConnIdxEntry *entry;
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
 	g_return_val_if_fail (uuid != NULL, NULL);
 
 	priv = NM_SETTINGS_GET_PRIVATE (self);
 
-	c_list_for_each_entry (candidate, &priv->connections_lst_head, _connections_lst) {
-		if (nm_streq (uuid, nm_settings_connection_get_uuid (candidate)))
-			return candidate;
-	}
+	if (!priv->idx_by_uuid)
+		return NULL;
 
-	return NULL;
+	entry = g_hash_table_lookup (priv->idx_by_uuid, uuid);
+	return entry ? entry->sett_conn : NULL;
 }
 
 static void
@@ -414,16 +572,29 @@ nm_settings_get_connections (NMSettings *self, guint *out_len)
 	return priv->connections_cached_list;
 }
 
+static GHashTable *
+_conn_idx_get_set (GHashTable *idx, const char *key)
+{
+	return idx ? g_hash_table_lookup (idx, key) : NULL;
+}
+
 /**
- * nm_settings_get_connections_clone:
+ * nm_settings_get_connections_clone_full:
  * @self: the #NMSetting
  * @out_len: (allow-none): optional output argument
+ * @connection_type: (allow-none): if set, only return connections
+ *   of this connection.type.
+ * @interface_name: (allow-none): if set, only return connections
+ *   whose connection.interface-name is exactly this name.
  * @func: caller-supplied function for filtering connections
  * @func_data: caller-supplied data passed to @func
  * @sort_compare_func: (allow-none): optional function pointer for
  *   sorting the returned list.
  * @sort_data: user data for @sort_compare_func.
  *
+ * Filtering by @connection_type and @interface_name uses the internal
+ * indexes, so @func is only called for the connections that match them.
+ *
  * Returns: (transfer container) (element-type NMSettingsConnection):
  *   an NULL terminated array of #NMSettingsConnection objects that were
  *   filtered by @func (or all connections if no filter was specified).
@@ -432,19 +603,73 @@ nm_settings_get_connections (NMSettings *self, guint *out_len)
  *   the contained values do not need to be unrefed.
  */
 NMSettingsConnection **
-nm_settings_get_connections_clone (NMSettings *self,
-                                   guint *out_len,
-                                   NMSettingsConnectionFilterFunc func,
-                                   gpointer func_data,
-                                   GCompareDataFunc sort_compare_func,
-                                   gpointer sort_data)
+nm_settings_get_connections_clone_full (NMSettings *self,
+                                        guint *out_len,
+                                        const char *connection_type,
+                                        const char *interface_name,
+                                        NMSettingsConnectionFilterFunc func,
+                                        gpointer func_data,
+                                        GCompareDataFunc sort_compare_func,
+                                        gpointer sort_data)
 {
+	NMSettingsPrivate *priv;
 	NMSettingsConnection *const*list_cached;
 	NMSettingsConnection **list;
 	guint len, i, j;
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
 
+	priv = NM_SETTINGS_GET_PRIVATE (self);
+
+	if (   connection_type
+	    || interface_name) {
+		GHashTable *set_type = NULL;
+		GHashTable *set_iface = NULL;
+		GHashTable *set;
+		GHashTableIter iter;
+		NMSettingsConnection *sett_conn;
+
+		if (connection_type)
+			set_type = _conn_idx_get_set (priv->idx_by_type, connection_type);
+		if (interface_name)
+			set_iface = _conn_idx_get_set (priv->idx_by_interface_name, interface_name);
+
+		/* iterate the smaller of the two sets, and check the other. */
+		if (   (connection_type && !set_type)
+		    || (interface_name && !set_iface))
+			set = NULL;
+		else if (!set_type)
+			set = set_iface;
+		else if (!set_iface)
+			set = set_type;
+		else
+			set = g_hash_table_size (set_type) <= g_hash_table_size (set_iface) ? set_type : set_iface;
+
+		len = set ? g_hash_table_size (set) : 0;
+		list = g_new (NMSettingsConnection *, ((gsize) len + 1));
+		j = 0;
+		if (set) {
+			g_hash_table_iter_init (&iter, set);
+			while (g_hash_table_iter_next (&iter, (gpointer *) &sett_conn, NULL)) {
+				if (   set_type
+				    && set != set_type
+				    && !g_hash_table_contains (set_type, sett_conn))
+					continue;
+				if (   set_iface
+				    && set != set_iface
+				    && !g_hash_table_contains (set_iface, sett_conn))
+					continue;
+				if (   func
+				    && !func (self, sett_conn, func_data))
+					continue;
+				list[j++] = sett_conn;
+			}
+		}
+		list[j] = NULL;
+		len = j;
+		goto out;
+	}
+
 	list_cached = nm_settings_get_connections (self, &len);
 
 #if NM_MORE_ASSERTS
@@ -465,6 +690,7 @@ nm_settings_get_connections_clone (NMSettings *self,
 	} else
 		memcpy (list, list_cached, sizeof (list[0]) * ((gsize) len + 1));
 
+out:
 	if (   len > 1
 	    && sort_compare_func) {
 		g_qsort_with_data (list, len, sizeof (NMSettingsConnection *),
@@ -474,6 +700,98 @@ nm_settings_get_connections_clone (NMSettings *self,
 	return list;
 }
 
+/**
+ * nm_settings_get_connections_clone:
+ * @self: the #NMSetting
+ * @out_len: (allow-none): optional output argument
+ * @func: caller-supplied function for filtering connections
+ * @func_data: caller-supplied data passed to @func
+ * @sort_compare_func: (allow-none): optional function pointer for
+ *   sorting the returned list.
+ * @sort_data: user data for @sort_compare_func.
+ *
+ * Like nm_settings_get_connections_clone_full() without filtering
+ * by connection type or interface name.
+ */
+NMSettingsConnection **
+nm_settings_get_connections_clone (NMSettings *self,
+                                   guint *out_len,
+                                   NMSettingsConnectionFilterFunc func,
+                                   gpointer func_data,
+                                   GCompareDataFunc sort_compare_func,
+                                   gpointer sort_data)
+{
+	return nm_settings_get_connections_clone_full (self, out_len,
+	                                               NULL, NULL,
+	                                               func, func_data,
+	                                               sort_compare_func, sort_data);
+}
+
+/**
+ * nm_settings_get_connections_sorted_by_autoconnect_priority:
+ * @self: the #NMSettings
+ * @connection_type: the connection.type of the connections to return
+ * @out_len: (allow-none): returns the number of connections
+ *
+ * Returns: (transfer none): a NULL terminated array of all connections
+ *   of type @connection_type, sorted by nm_settings_connection_cmp_autoconnect_priority().
+ *   The list is cached and kept up to date incrementally. It is only valid
+ *   until the connections of that type or their timestamps change.
+ */
+NMSettingsConnection *const*
+nm_settings_get_connections_sorted_by_autoconnect_priority (NMSettings *self,
+                                                            const char *connection_type,
+                                                            guint *out_len)
+{
+	static NMSettingsConnection *const empty[1] = { NULL };
+	NMSettingsPrivate *priv;
+	GHashTable *set;
+	GHashTableIter iter;
+	NMSettingsConnection *sett_conn;
+	GPtrArray *arr;
+	guint generation;
+
+	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
+	g_return_val_if_fail (connection_type, NULL);
+
+	priv = NM_SETTINGS_GET_PRIVATE (self);
+
+	set = _conn_idx_get_set (priv->idx_by_type, connection_type);
+	if (!set) {
+		NM_SET_OUT (out_len, 0);
+		return empty;
+	}
+
+	/* the timestamp is part of the sort order. */
+	generation = nm_settings_connection_get_timestamp_generation ();
+	if (priv->autoconnect_sorted_timestamp_generation != generation) {
+		priv->autoconnect_sorted_timestamp_generation = generation;
+		if (priv->autoconnect_sorted_by_type)
+			g_hash_table_remove_all (priv->autoconnect_sorted_by_type);
+	}
+
+	arr = priv->autoconnect_sorted_by_type
+	      ? g_hash_table_lookup (priv->autoconnect_sorted_by_type, connection_type)
+	      : NULL;
+	if (!arr) {
+		arr = g_ptr_array_sized_new (g_hash_table_size (set) + 1);
+		g_hash_table_iter_init (&iter, set);
+		while (g_hash_table_iter_next (&iter, (gpointer *) &sett_conn, NULL))
+			g_ptr_array_add (arr, sett_conn);
+		g_ptr_array_sort_with_data (arr, nm_settings_connection_cmp_autoconnect_priority_p_with_data, NULL);
+		g_ptr_array_add (arr, NULL);
+
+		if (!priv->autoconnect_sorted_by_type) {
+			priv->autoconnect_sorted_by_type = g_hash_table_new_full (nm_str_hash, g_str_equal,
+			                                                          g_free, (GDestroyNotify) g_ptr_array_unref);
+		}
+		g_hash_table_insert (priv->autoconnect_sorted_by_type, g_strdup (connection_type), arr);
+	}
+
+	NM_SET_OUT (out_len, arr->len - 1);
+	return (NMSettingsConnection *const*) arr->pdata;
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_path (NMSettings *self, const char *path)
 {
@@ -776,6 +1094,8 @@ load_plugins (NMSettings *self, const char **plugins, GError **error)
 static void
 connection_updated (NMSettingsConnection *connection, gboolean by_user, gpointer user_data)
 {
+	_conn_idx_update (NM_SETTINGS_GET_PRIVATE ((NMSettings *) user_data), connection);
+
 	g_signal_emit (NM_SETTINGS (user_data),
 	               signals[CONNECTION_UPDATED],
 	               0,
@@ -828,6 +1148,7 @@ connection_removed (NMSettingsConnection *connection, gpointer user_data)
 	_clear_connections_cached_list (priv);
 	priv->connections_len--;
 	c_list_unlink (&connection->_connections_lst);
+	_conn_idx_remove (priv, connection);
 
 	if (priv->connections_loaded) {
 		_notify (self, PROP_CONNECTIONS);
@@ -973,6 +1294,7 @@ claim_connection (NMSettings *self, NMSettingsConnection *sett_conn)
 	g_object_ref (self);
 	priv->connections_len++;
 	c_list_link_tail (&priv->connections_lst_head, &sett_conn->_connections_lst);
+	_conn_idx_add (priv, sett_conn);
 
 	path = nm_dbus_object_export (NM_DBUS_OBJECT (sett_conn));
 
@@ -1042,20 +1364,18 @@ nm_settings_add_connection (NMSettings *self,
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	GSList *iter;
 	NMSettingsConnection *added = NULL;
-	NMSettingsConnection *candidate = NULL;
 	const char *uuid;
 
 	uuid = nm_connection_get_uuid (connection);
 
 	/* Make sure a connection with this UUID doesn't already exist */
-	c_list_for_each_entry (candidate, &priv->connections_lst_head, _connections_lst) {
-		if (nm_streq0 (uuid, nm_settings_connection_get_uuid (candidate))) {
-			g_set_error_literal (error,
-			                     NM_SETTINGS_ERROR,
-			                     NM_SETTINGS_ERROR_UUID_EXISTS,
-			                     "A connection with this UUID already exists.");
-			return NULL;
-		}
+	if (   uuid
+	    && nm_settings_get_connection_by_uuid (self, uuid)) {
+		g_set_error_literal (error,
+		                     NM_SETTINGS_ERROR,
+		                     NM_SETTINGS_ERROR_UUID_EXISTS,
+		                     "A connection with this UUID already exists.");
+		return NULL;
 	}
 
 	/* 1) plugin writes the NMConnection to disk
@@ -1581,55 +1901,66 @@ impl_settings_save_hostname (NMDBusObject *obj,
 static gboolean
 have_connection_for_device (NMSettings *self, NMDevice *device)
 {
+	static const char *const ctypes[] = {
+		NM_SETTING_WIRED_SETTING_NAME,
+		NM_SETTING_PPPOE_SETTING_NAME,
+	};
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	NMSettingConnection *s_con;
 	NMSettingWired *s_wired;
 	const char *setting_hwaddr;
 	const char *perm_hw_addr;
-	NMSettingsConnection *sett_conn;
+	guint i;
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), FALSE);
 
 	perm_hw_addr = nm_device_get_permanent_hw_address (device);
 
-	/* Find a wired connection locked to the given MAC address, if any */
-	c_list_for_each_entry (sett_conn, &priv->connections_lst_head, _connections_lst) {
-		NMConnection *connection = nm_settings_connection_get_connection (sett_conn);
-		const char *ctype, *iface;
+	/* Find a wired connection locked to the given MAC address, if any.
+	 * Only wired and PPPoE profiles are relevant, look them up by type. */
+	for (i = 0; i < G_N_ELEMENTS (ctypes); i++) {
+		GHashTableIter iter;
+		GHashTable *set;
+		NMSettingsConnection *sett_conn;
 
-		if (!nm_device_check_connection_compatible (device, connection, NULL))
+		set = _conn_idx_get_set (priv->idx_by_type, ctypes[i]);
+		if (!set)
 			continue;
 
-		s_con = nm_connection_get_setting_connection (connection);
+		g_hash_table_iter_init (&iter, set);
+		while (g_hash_table_iter_next (&iter, (gpointer *) &sett_conn, NULL)) {
+			NMConnection *connection = nm_settings_connection_get_connection (sett_conn);
+			const char *iface;
 
-		iface = nm_setting_connection_get_interface_name (s_con);
-		if (iface && strcmp (iface, nm_device_get_iface (device)) != 0)
-			continue;
+			if (!nm_device_check_connection_compatible (device, connection, NULL))
+				continue;
 
-		ctype = nm_setting_connection_get_connection_type (s_con);
-		if (   strcmp (ctype, NM_SETTING_WIRED_SETTING_NAME)
-		    && strcmp (ctype, NM_SETTING_PPPOE_SETTING_NAME))
-			continue;
+			s_con = nm_connection_get_setting_connection (connection);
 
-		s_wired = nm_connection_get_setting_wired (connection);
+			iface = nm_setting_connection_get_interface_name (s_con);
+			if (iface && strcmp (iface, nm_device_get_iface (device)) != 0)
+				continue;
 
-		if (   !s_wired
-		    && nm_streq (ctype, NM_SETTING_PPPOE_SETTING_NAME)) {
-			/* No wired setting; therefore the PPPoE connection applies to any device */
-			return TRUE;
-		}
+			s_wired = nm_connection_get_setting_wired (connection);
+
+			if (   !s_wired
+			    && nm_streq (ctypes[i], NM_SETTING_PPPOE_SETTING_NAME)) {
+				/* No wired setting; therefore the PPPoE connection applies to any device */
+				return TRUE;
+			}
 
-		nm_assert (s_wired);
+			nm_assert (s_wired);
 
-		setting_hwaddr = nm_setting_wired_get_mac_address (s_wired);
-		if (setting_hwaddr) {
-			/* A connection mac-locked to this device */
-			if (   perm_hw_addr
-			    && nm_utils_hwaddr_matches (setting_hwaddr, -1, perm_hw_addr, -1))
+			setting_hwaddr = nm_setting_wired_get_mac_address (s_wired);
+			if (setting_hwaddr) {
+				/* A connection mac-locked to this device */
+				if (   perm_hw_addr
+				    && nm_utils_hwaddr_matches (setting_hwaddr, -1, perm_hw_addr, -1))
+					return TRUE;
+			} else {
+				/* A connection that applies to any wired device */
 				return TRUE;
-		} else {
-			/* A connection that applies to any wired device */
-			return TRUE;
+			}
 		}
 	}
 
@@ -1918,6 +2249,11 @@ finalize (GObject *object)
 	_clear_connections_cached_list (priv);
 
 	nm_assert (c_list_is_empty (&priv->connections_lst_head));
+	nm_assert (!priv->idx_by_uuid || g_hash_table_size (priv->idx_by_uuid) == 0);
+	g_clear_pointer (&priv->idx_by_uuid, g_hash_table_unref);
+	g_clear_pointer (&priv->idx_by_interface_name, g_hash_table_unref);
+	g_clear_pointer (&priv->idx_by_type, g_hash_table_unref);
+	g_clear_pointer (&priv->autoconnect_sorted_by_type, g_hash_table_unref);
 
 	g_slist_free_full (priv->unmanaged_specs, g_free);
 	g_slist_free_full (priv->unrecognized_specs, g_free);
@@ -87,6 +87,19 @@ void nm_settings_add_connection_dbus (NMSettings *self,
 
 NMSettingsConnection *const*nm_settings_get_connections (NMSettings *settings, guint *out_len);
 
+NMSettingsConnection *const*nm_settings_get_connections_sorted_by_autoconnect_priority (NMSettings *self,
+                                                                                      const char *connection_type,
+                                                                                      guint *out_len);
+
+NMSettingsConnection **nm_settings_get_connections_clone_full (NMSettings *self,
+                                                               guint *out_len,
+                                                               const char *connection_type,
+                                                               const char *interface_name,
+                                                               NMSettingsConnectionFilterFunc func,
+                                                               gpointer func_data,
+                                                               GCompareDataFunc sort_compare_func,
+                                                               gpointer sort_data);
+
 NMSettingsConnection **nm_settings_get_connections_clone (NMSettings *self,
                                                           guint *out_len,
                                                           NMSettingsConnectionFilterFunc func,
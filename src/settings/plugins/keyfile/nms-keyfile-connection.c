@@ -120,48 +120,59 @@ nms_keyfile_connection_init (NMSKeyfileConnection *connection)
 {
 }
 
-NMSKeyfileConnection *
-nms_keyfile_connection_new (NMConnection *source,
-                            const char *full_path,
-                            const char *profile_dir,
-                            GError **error)
+/**
+ * nms_keyfile_connection_read:
+ * @full_path: the keyfile to read
+ * @profile_dir: the directory for persistent profiles
+ * @out_warnings: (allow-none): collects the warnings of the reader
+ *   instead of logging them, see nms_keyfile_reader_from_file().
+ * @error: error in case of failure
+ *
+ * Reads, normalizes and verifies the connection from @full_path.
+ * This does not touch any global state of the plugin and, with
+ * @out_warnings given, is safe to call from a worker thread.
+ *
+ * Returns: (transfer full): the connection or %NULL on failure.
+ */
+NMConnection *
+nms_keyfile_connection_read (const char *full_path,
+                             const char *profile_dir,
+                             GArray *out_warnings,
+                             GError **error)
 {
-	GObject *object;
-	NMConnection *tmp;
-	const char *uuid;
-	gboolean update_unsaved = TRUE;
+	gs_unref_object NMConnection *connection = NULL;
 
-	nm_assert (source || full_path);
-	nm_assert (!full_path || full_path[0] == '/');
+	nm_assert (full_path && full_path[0] == '/');
 	nm_assert (!profile_dir || profile_dir[0] == '/');
 
-	/* If we're given a connection already, prefer that instead of re-reading */
-	if (source)
-		tmp = g_object_ref (source);
-	else {
-		tmp = nms_keyfile_reader_from_file (full_path, profile_dir, error);
-		if (!tmp)
-			return NULL;
-
-		uuid = nm_connection_get_uuid (tmp);
-		if (!uuid) {
-			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
-			             "Connection in file %s had no UUID", full_path);
-			g_object_unref (tmp);
-			return NULL;
-		}
+	connection = nms_keyfile_reader_from_file (full_path, profile_dir, out_warnings, error);
+	if (!connection)
+		return NULL;
 
-		/* If we just read the connection from disk, it's clearly not Unsaved */
-		update_unsaved = FALSE;
+	if (!nm_connection_get_uuid (connection)) {
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "Connection in file %s had no UUID", full_path);
+		return NULL;
 	}
 
+	return g_steal_pointer (&connection);
+}
+
+static NMSKeyfileConnection *
+_connection_new (NMConnection *connection,
+                 const char *full_path,
+                 gboolean update_unsaved,
+                 GError **error)
+{
+	GObject *object;
+
 	object = g_object_new (NMS_TYPE_KEYFILE_CONNECTION,
 	                       NM_SETTINGS_CONNECTION_FILENAME, full_path,
 	                       NULL);
 
 	/* Update our settings with what was read from the file */
 	if (!nm_settings_connection_update (NM_SETTINGS_CONNECTION (object),
-	                                    tmp,
+	                                    connection,
 	                                    update_unsaved
 	                                      ? NM_SETTINGS_CONNECTION_PERSIST_MODE_UNSAVED
 	                                      : NM_SETTINGS_CONNECTION_PERSIST_MODE_KEEP_SAVED,
@@ -169,13 +180,58 @@ nms_keyfile_connection_new (NMConnection *source,
 	                                    NULL,
 	                                    error)) {
 		g_object_unref (object);
-		object = NULL;
+		return NULL;
 	}
 
-	g_object_unref (tmp);
 	return (NMSKeyfileConnection *) object;
 }
 
+/**
+ * nms_keyfile_connection_new_read:
+ * @read_connection: the connection as returned by nms_keyfile_connection_read()
+ * @full_path: the file from which @read_connection was read
+ * @error: error in case of failure
+ *
+ * Like nms_keyfile_connection_new() without source, but for a connection
+ * that was already read from disk.
+ *
+ * Returns: the new settings connection.
+ */
+NMSKeyfileConnection *
+nms_keyfile_connection_new_read (NMConnection *read_connection,
+                                 const char *full_path,
+                                 GError **error)
+{
+	nm_assert (NM_IS_CONNECTION (read_connection));
+	nm_assert (full_path && full_path[0] == '/');
+
+	/* If we just read the connection from disk, it's clearly not Unsaved */
+	return _connection_new (read_connection, full_path, FALSE, error);
+}
+
+NMSKeyfileConnection *
+nms_keyfile_connection_new (NMConnection *source,
+                            const char *full_path,
+                            const char *profile_dir,
+                            GError **error)
+{
+	gs_unref_object NMConnection *tmp = NULL;
+
+	nm_assert (source || full_path);
+	nm_assert (!full_path || full_path[0] == '/');
+	nm_assert (!profile_dir || profile_dir[0] == '/');
+
+	/* If we're given a connection already, prefer that instead of re-reading */
+	if (source)
+		return _connection_new (source, full_path, TRUE, error);
+
+	tmp = nms_keyfile_connection_read (full_path, profile_dir, NULL, error);
+	if (!tmp)
+		return NULL;
+
+	return nms_keyfile_connection_new_read (tmp, full_path, error);
+}
+
 static void
 nms_keyfile_connection_class_init (NMSKeyfileConnectionClass *keyfile_connection_class)
 {
@@ -41,4 +41,13 @@ NMSKeyfileConnection *nms_keyfile_connection_new (NMConnection *source,
                                                   const char *profile_dir,
                                                   GError **error);
 
+NMConnection *nms_keyfile_connection_read (const char *full_path,
+                                           const char *profile_dir,
+                                           GArray *out_warnings,
+                                           GError **error);
+
+NMSKeyfileConnection *nms_keyfile_connection_new_read (NMConnection *read_connection,
+                                                       const char *full_path,
+                                                       GError **error);
+
 #endif /* __NMS_KEYFILE_CONNECTION_H__ */
@@ -35,10 +35,12 @@
 #include "nm-config.h"
 #include "nm-core-internal.h"
 #include "nm-keyfile-internal.h"
+#include "nm-glib-aux/nm-io-utils.h"
 
 #include "settings/nm-settings-plugin.h"
 
 #include "nms-keyfile-connection.h"
+#include "nms-keyfile-reader.h"
 #include "nms-keyfile-writer.h"
 #include "nms-keyfile-utils.h"
 
@@ -79,6 +81,43 @@ G_DEFINE_TYPE (NMSKeyfilePlugin, nms_keyfile_plugin, NM_TYPE_SETTINGS_PLUGIN)
 
 /*****************************************************************************/
 
+/* When reading all profiles, the parsing is done on a thread pool if
+ * there are at least this many files. */
+#define READ_PARALLEL_MIN_FILES 16
+
+/* On restart, files that did not change since the last full read are
+ * loaded from the snapshot instead of being parsed again. */
+#define SNAPSHOT_FILE          NMRUNDIR "/keyfile-snapshot"
+
+typedef struct {
+	const char *full_path;
+	gint64 mtime;
+	bool loaded;
+
+	bool has_st;
+	bool from_snapshot;
+	struct stat st;
+
+	/* the serialized connection. Initially, this is the entry from the
+	 * snapshot (if the stat data match). After reading, this is
+	 * the connection to be stored in the next snapshot. */
+	GVariant *dict;
+
+	/* result of nms_keyfile_connection_read(). */
+	NMConnection *connection;
+	GError *error;
+
+	/* the warnings of the reader, logged later on the main thread. */
+	GArray *warnings;
+} ReadData;
+
+typedef struct {
+	const char *profile_dir;
+	gboolean snapshot;
+} ReadContext;
+
+/*****************************************************************************/
+
 static void
 connection_removed_cb (NMSettingsConnection *sett_conn, NMSKeyfilePlugin *self)
 {
@@ -131,6 +170,9 @@ find_by_path (NMSKeyfilePlugin *self, const char *path)
  *   and updates it. When passing @source, this adds a connection from
  *   memory.
  * @full_path: the filename of the keyfile to be loaded
+ * @read_data: (allow-none): if given, the result of reading @full_path
+ *   ahead of time. The connection is not read again and the result is
+ *   consumed.
  * @connection: an existing connection that might be updated.
  *   If given, @connection must be an existing connection that is currently
  *   owned by the plugin.
@@ -160,6 +202,7 @@ static NMSKeyfileConnection *
 update_connection (NMSKeyfilePlugin *self,
                    NMConnection *source,
                    const char *full_path,
+                   ReadData *read_data,
                    NMSKeyfileConnection *connection,
                    gboolean protect_existing_connection,
                    GHashTable *protected_connections,
@@ -173,10 +216,14 @@ update_connection (NMSKeyfilePlugin *self,
 
 	g_return_val_if_fail (!source || NM_IS_CONNECTION (source), NULL);
 	g_return_val_if_fail (full_path || source, NULL);
+	nm_assert (!read_data || (!source && nm_streq0 (read_data->full_path, full_path)));
 
 	if (full_path)
 		_LOGD ("loading from file \"%s\"...", full_path);
 
+	if (read_data)
+		nms_keyfile_read_warnings_log (read_data->warnings);
+
 	if (   !nm_utils_file_is_in_path (full_path, nms_keyfile_utils_get_path ())
 	    && !nm_utils_file_is_in_path (full_path, NM_KEYFILE_PATH_NAME_RUN)) {
 		g_set_error_literal (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_FAILED,
@@ -184,7 +231,15 @@ update_connection (NMSKeyfilePlugin *self,
 		return FALSE;
 	}
 
-	connection_new = nms_keyfile_connection_new (source, full_path, nms_keyfile_utils_get_path (), &local);
+	if (!read_data)
+		connection_new = nms_keyfile_connection_new (source, full_path, nms_keyfile_utils_get_path (), &local);
+	else if (read_data->connection)
+		connection_new = nms_keyfile_connection_new_read (read_data->connection, full_path, &local);
+	else {
+		connection_new = NULL;
+		local = g_steal_pointer (&read_data->error);
+		nm_assert (local);
+	}
 	if (!connection_new) {
 		/* Error; remove the connection */
 		if (source)
@@ -329,7 +384,7 @@ dir_changed (GFileMonitor *monitor,
 	case G_FILE_MONITOR_EVENT_CREATED:
 	case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
 		if (exists)
-			update_connection (NMS_KEYFILE_PLUGIN (config), NULL, full_path, connection, TRUE, NULL, NULL);
+			update_connection (NMS_KEYFILE_PLUGIN (config), NULL, full_path, NULL, connection, TRUE, NULL, NULL);
 		break;
 	default:
 		break;
@@ -397,23 +452,122 @@ _paths_from_connections (GHashTable *connections)
 }
 
 static int
-_sort_paths (const char **f1, const char **f2, GHashTable *paths)
+_sort_paths (gconstpointer a, gconstpointer b, gpointer user_data)
 {
-	struct stat st;
-	gboolean c1, c2;
-	gint64 m1, m2;
+	const ReadData *d1 = a;
+	const ReadData *d2 = b;
+
+	if (d1->loaded != d2->loaded)
+		return d1->loaded ? -1 : 1;
 
-	c1 = !!g_hash_table_contains (paths, *f1);
-	c2 = !!g_hash_table_contains (paths, *f2);
-	if (c1 != c2)
-		return c1 ? -1 : 1;
+	if (d1->mtime != d2->mtime)
+		return d1->mtime > d2->mtime ? -1 : 1;
 
-	m1 = stat (*f1, &st) == 0 ? (gint64) st.st_mtime : G_MININT64;
-	m2 = stat (*f2, &st) == 0 ? (gint64) st.st_mtime : G_MININT64;
-	if (m1 != m2)
-		return m1 > m2 ? -1 : 1;
+	return strcmp (d1->full_path, d2->full_path);
+}
 
-	return strcmp (*f1, *f2);
+static GHashTable *
+_snapshot_load (void)
+{
+	gs_free_error GError *error = NULL;
+	GHashTable *snapshot;
+
+	snapshot = nms_keyfile_snapshot_load (SNAPSHOT_FILE, VERSION, &error);
+	if (!snapshot) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			_LOGD ("snapshot: ignore \"%s\": %s", SNAPSHOT_FILE, error->message);
+		return NULL;
+	}
+
+	_LOGD ("snapshot: loaded %u profiles", g_hash_table_size (snapshot));
+	return snapshot;
+}
+
+static void
+_snapshot_save (const ReadData *read_datas, guint len)
+{
+	gs_free_error GError *error = NULL;
+	GVariantBuilder builder;
+	guint i;
+
+	nms_keyfile_snapshot_builder_init (&builder);
+	for (i = 0; i < len; i++) {
+		const ReadData *read_data = &read_datas[i];
+
+		if (read_data->dict)
+			nms_keyfile_snapshot_builder_add (&builder, read_data->full_path, &read_data->st, read_data->dict);
+	}
+
+	if (!nms_keyfile_snapshot_save (SNAPSHOT_FILE, VERSION, &builder, &error)) {
+		_LOGW ("snapshot: cannot write \"%s\": %s", SNAPSHOT_FILE, error->message);
+		return;
+	}
+
+	_LOGD ("snapshot: saved");
+}
+
+static void
+_read_data_thread (gpointer data, gpointer user_data)
+{
+	ReadData *read_data = data;
+	const ReadContext *ctx = user_data;
+
+	if (read_data->dict) {
+		/* the file did not change since we wrote the snapshot. */
+		read_data->connection = nms_keyfile_snapshot_connection_new (read_data->dict,
+		                                                             &read_data->st,
+		                                                             NULL);
+		if (read_data->connection) {
+			read_data->from_snapshot = TRUE;
+			return;
+		}
+		nm_clear_pointer (&read_data->dict, g_variant_unref);
+	}
+
+	read_data->warnings = g_array_new (FALSE, FALSE, sizeof (NMSKeyfileReadWarning));
+	g_array_set_clear_func (read_data->warnings, nms_keyfile_read_warning_clear);
+
+	read_data->connection = nms_keyfile_connection_read (read_data->full_path,
+	                                                     ctx->profile_dir,
+	                                                     read_data->warnings,
+	                                                     &read_data->error);
+
+	if (   ctx->snapshot
+	    && read_data->connection
+	    && read_data->has_st) {
+		read_data->dict = g_variant_ref_sink (nm_connection_to_dbus (read_data->connection,
+		                                                             NM_CONNECTION_SERIALIZE_ALL));
+	}
+}
+
+static void
+_read_datas_parallel (ReadData *read_datas, guint len, gboolean snapshot)
+{
+	ReadContext ctx = {
+		.profile_dir = nms_keyfile_utils_get_path (),
+		.snapshot    = snapshot,
+	};
+	GThreadPool *pool = NULL;
+	guint n_threads;
+	guint i;
+
+	n_threads = MIN (g_get_num_processors (), len / READ_PARALLEL_MIN_FILES);
+	if (n_threads > 1)
+		pool = g_thread_pool_new (_read_data_thread, &ctx, n_threads, FALSE, NULL);
+
+	if (!pool) {
+		for (i = 0; i < len; i++)
+			_read_data_thread (&read_datas[i], &ctx);
+		return;
+	}
+
+	_LOGD ("reading %u files with %u threads", len, n_threads);
+
+	for (i = 0; i < len; i++)
+		g_thread_pool_push (pool, &read_datas[i], NULL);
+
+	/* wait for all files to be read. */
+	g_thread_pool_free (pool, FALSE, TRUE);
 }
 
 static void
@@ -453,6 +607,10 @@ read_connections (NMSettingsPlugin *config)
 	guint i;
 	GPtrArray *filenames;
 	GHashTable *paths;
+	ReadData *read_datas;
+	gs_unref_hashtable GHashTable *snapshot = NULL;
+	gboolean snapshot_enabled;
+	guint n_from_snapshot = 0;
 
 	filenames = g_ptr_array_new_with_free_func (g_free);
 
@@ -467,15 +625,59 @@ read_connections (NMSettingsPlugin *config)
 	 * To have sensible, reproducible behavior, sort the paths by last modification
 	 * time preferring older files.
 	 */
+	snapshot_enabled = nm_config_data_get_value_boolean (NM_CONFIG_GET_DATA,
+	                                                     NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                                     NM_CONFIG_KEYFILE_KEY_KEYFILE_SNAPSHOT,
+	                                                     FALSE);
+	if (snapshot_enabled)
+		snapshot = _snapshot_load ();
+
 	paths = _paths_from_connections (priv->connections);
-	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
+	read_datas = g_new0 (ReadData, filenames->len);
+	for (i = 0; i < filenames->len; i++) {
+		ReadData *read_data = &read_datas[i];
+
+		read_data->full_path = filenames->pdata[i];
+		read_data->loaded = g_hash_table_contains (paths, read_data->full_path);
+		read_data->has_st = stat (read_data->full_path, &read_data->st) == 0;
+		read_data->mtime = read_data->has_st ? (gint64) read_data->st.st_mtime : G_MININT64;
+		if (read_data->has_st)
+			read_data->dict = nms_keyfile_snapshot_lookup (snapshot, read_data->full_path, &read_data->st);
+	}
 	g_hash_table_destroy (paths);
+	g_qsort_with_data (read_datas, filenames->len, sizeof (ReadData), _sort_paths, NULL);
+
+	/* Reading, parsing and verifying the files is independent of the
+	 * plugin state. Do that first (possibly in parallel) and merge the
+	 * results afterwards in the sorted order. */
+	_read_datas_parallel (read_datas, filenames->len, snapshot_enabled);
 
 	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (self, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+		ReadData *read_data = &read_datas[i];
+
+		if (read_data->from_snapshot)
+			n_from_snapshot++;
+		connection = update_connection (self, NULL, read_data->full_path, read_data, NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
+		g_clear_object (&read_data->connection);
+		g_clear_error (&read_data->error);
+		nm_clear_pointer (&read_data->warnings, g_array_unref);
 	}
+
+	if (snapshot_enabled) {
+		_LOGD ("snapshot: %u of %u profiles unchanged", n_from_snapshot, filenames->len);
+
+		/* only rewrite the snapshot if it is outdated. */
+		if (   !snapshot
+		    || n_from_snapshot != filenames->len
+		    || n_from_snapshot != g_hash_table_size (snapshot))
+			_snapshot_save (read_datas, filenames->len);
+	}
+
+	for (i = 0; i < filenames->len; i++)
+		nm_clear_pointer (&read_datas[i].dict, g_variant_unref);
+	g_free (read_datas);
 	g_ptr_array_free (filenames, TRUE);
 
 	g_hash_table_iter_init (&iter, priv->connections);
@@ -529,7 +731,7 @@ load_connection (NMSettingsPlugin *config,
 	if (nm_keyfile_utils_ignore_filename (filename, require_extension))
 		return FALSE;
 
-	connection = update_connection (self, NULL, filename, find_by_path (self, filename), TRUE, NULL, NULL);
+	connection = update_connection (self, NULL, filename, NULL, find_by_path (self, filename), TRUE, NULL, NULL);
 
 	return (connection != NULL);
 }
@@ -560,7 +762,7 @@ add_connection (NMSettingsPlugin *config,
 	                                    error))
 		return NULL;
 
-	return NM_SETTINGS_CONNECTION (update_connection (self, reread ?: connection, path, NULL, FALSE, NULL, error));
+	return NM_SETTINGS_CONNECTION (update_connection (self, reread ?: connection, path, NULL, NULL, FALSE, NULL, error));
 }
 
 static GSList *
@@ -58,8 +58,41 @@ _fmt_warn (const char *group, NMSetting *setting, const char *property_name, con
 
 typedef struct {
 	bool verbose;
+	GArray *warnings;
 } HandlerReadData;
 
+void
+nms_keyfile_read_warning_clear (gpointer data)
+{
+	NMSKeyfileReadWarning *warning = data;
+
+	nm_clear_g_free (&warning->uuid);
+	nm_clear_g_free (&warning->message);
+}
+
+/**
+ * nms_keyfile_read_warnings_log:
+ * @warnings: (allow-none): the warnings collected by
+ *   nms_keyfile_reader_from_file()
+ *
+ * Logs the collected warnings. Must be called on the main thread.
+ */
+void
+nms_keyfile_read_warnings_log (GArray *warnings)
+{
+	guint i;
+
+	if (!warnings)
+		return;
+
+	for (i = 0; i < warnings->len; i++) {
+		const NMSKeyfileReadWarning *warning = &g_array_index (warnings, NMSKeyfileReadWarning, i);
+
+		nm_log (warning->level, LOGD_SETTINGS, NULL, warning->uuid,
+		        "keyfile: %s", warning->message);
+	}
+}
+
 static gboolean
 _handler_read (GKeyFile *keyfile,
                NMConnection *connection,
@@ -87,6 +120,22 @@ _handler_read (GKeyFile *keyfile,
 		else
 			level = LOGL_INFO;
 
+		if (handler_data->warnings) {
+			NMSKeyfileReadWarning warning = {
+				.level = level,
+				.uuid  = g_strdup (nm_connection_get_uuid (connection)),
+			};
+
+			/* we might run on a worker thread, which must not log. Leave
+			 * it to the caller to log the warnings on the main thread. */
+			warning.message = g_strdup (_fmt_warn (warn_data->group, warn_data->setting,
+			                                       warn_data->property_name, warn_data->message,
+			                                       &message_free));
+			g_free (message_free);
+			g_array_append_val (handler_data->warnings, warning);
+			return TRUE;
+		}
+
 		nm_log (level, LOGD_SETTINGS, NULL,
 		        nm_connection_get_uuid (connection),
 		        "keyfile: %s",
@@ -99,17 +148,19 @@ _handler_read (GKeyFile *keyfile,
 	return FALSE;
 }
 
-NMConnection *
-nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
-                                 const char *filename,
-                                 const char *base_dir,
-                                 const char *profile_dir,
-                                 gboolean verbose,
-                                 GError **error)
+static NMConnection *
+_reader_from_keyfile (GKeyFile *key_file,
+                      const char *filename,
+                      const char *base_dir,
+                      const char *profile_dir,
+                      gboolean verbose,
+                      GArray *out_warnings,
+                      GError **error)
 {
 	NMConnection *connection;
 	HandlerReadData data = {
-		.verbose = verbose,
+		.verbose  = verbose,
+		.warnings = out_warnings,
 	};
 	gs_free char *base_dir_free = NULL;
 	gs_free char *profile_filename_free = NULL;
@@ -159,9 +210,33 @@ nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
 	return connection;
 }
 
+NMConnection *
+nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
+                                 const char *filename,
+                                 const char *base_dir,
+                                 const char *profile_dir,
+                                 gboolean verbose,
+                                 GError **error)
+{
+	return _reader_from_keyfile (key_file, filename, base_dir, profile_dir, verbose, NULL, error);
+}
+
+/**
+ * nms_keyfile_reader_from_file:
+ * @full_filename: the keyfile to read
+ * @profile_dir: (allow-none): the directory for persistent profiles
+ * @out_warnings: (allow-none): if given, an array of #NMSKeyfileReadWarning
+ *   to which the warnings are appended instead of logging them. This
+ *   makes the function safe to call from a worker thread.
+ * @error: error in case of failure
+ *
+ * Returns: (transfer full): the normalized connection or %NULL on failure.
+ */
+
 NMConnection *
 nms_keyfile_reader_from_file (const char *full_filename,
                               const char *profile_dir,
+                              GArray *out_warnings,
                               GError **error)
 {
 	gs_unref_keyfile GKeyFile *key_file = NULL;
@@ -181,7 +256,7 @@ nms_keyfile_reader_from_file (const char *full_filename,
 	if (!g_key_file_load_from_file (key_file, full_filename, G_KEY_FILE_NONE, error))
 		return NULL;
 
-	connection = nms_keyfile_reader_from_keyfile (key_file, full_filename, NULL, profile_dir, TRUE, error);
+	connection = _reader_from_keyfile (key_file, full_filename, NULL, profile_dir, TRUE, out_warnings, error);
 	if (!connection)
 		return NULL;
 
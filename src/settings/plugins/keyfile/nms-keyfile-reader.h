@@ -31,8 +31,19 @@ NMConnection *nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
                                                gboolean verbose,
                                                GError **error);
 
+typedef struct {
+	NMLogLevel level;
+	char *uuid;
+	char *message;
+} NMSKeyfileReadWarning;
+
+void nms_keyfile_read_warning_clear (gpointer data);
+
+void nms_keyfile_read_warnings_log (GArray *warnings);
+
 NMConnection *nms_keyfile_reader_from_file (const char *full_filename,
                                             const char *profile_dir,
+                                            GArray *out_warnings,
                                             GError **error);
 
 #endif /* __NMS_KEYFILE_READER_H__ */
@@ -26,6 +26,8 @@
 #include <sys/stat.h>
 
 #include "nm-keyfile-internal.h"
+#include "nm-core-internal.h"
+#include "nm-glib-aux/nm-io-utils.h"
 #include "nm-utils.h"
 #include "nm-setting-wired.h"
 #include "nm-setting-wireless.h"
@@ -298,6 +300,210 @@ nms_keyfile_utils_check_file_permissions (NMSKeyfileFiletype filetype,
 
 /*****************************************************************************/
 
+/* The snapshot contains the serialized profiles of the last full read,
+ * keyed by the path and stat data of the file they were read from. */
+#define SNAPSHOT_ENTRY_TYPE    "(stttt@a{sa{sv}})"
+#define SNAPSHOT_VARIANT_TYPE  "(sa(stttta{sa{sv}}))"
+
+static guint64
+_stat_mtime_ns (const struct stat *st)
+{
+	return (((guint64) st->st_mtim.tv_sec) * NM_UTILS_NS_PER_SECOND) + (guint64) st->st_mtim.tv_nsec;
+}
+
+/**
+ * nms_keyfile_snapshot_load:
+ * @filename: the snapshot file
+ * @version: the version that must have written the snapshot
+ * @error: the failure reason
+ *
+ * Returns: (transfer full): a hash table from the path of the keyfile
+ *   to its snapshot entry, or %NULL if the snapshot cannot be read or was
+ *   written by another version. A missing file fails with
+ *   %G_FILE_ERROR_NOENT.
+ */
+GHashTable *
+nms_keyfile_snapshot_load (const char *filename,
+                           const char *version,
+                           GError **error)
+{
+	gs_unref_variant GVariant *snapshot = NULL;
+	gs_unref_variant GVariant *entries = NULL;
+	GHashTable *hash;
+	const char *snapshot_version;
+	char *contents;
+	gsize len;
+	gsize i, n;
+
+	g_return_val_if_fail (filename, NULL);
+	g_return_val_if_fail (version, NULL);
+
+	if (!g_file_get_contents (filename, &contents, &len, error))
+		return NULL;
+
+	snapshot = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE (SNAPSHOT_VARIANT_TYPE),
+	                                                        contents, len, FALSE,
+	                                                        g_free, contents));
+
+	g_variant_get (snapshot, "(&s@a(stttta{sa{sv}}))", &snapshot_version, &entries);
+	if (!nm_streq (snapshot_version, version)) {
+		/* the snapshot was written by another version, which might serialize
+		 * or normalize connections differently. */
+		nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN,
+		                    "snapshot has version \"%s\"", snapshot_version);
+		return NULL;
+	}
+
+	n = g_variant_n_children (entries);
+	hash = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+	for (i = 0; i < n; i++) {
+		GVariant *entry = g_variant_get_child_value (entries, i);
+		const char *path;
+
+		g_variant_get_child (entry, 0, "&s", &path);
+		g_hash_table_insert (hash, (gpointer) path, entry);
+	}
+
+	return hash;
+}
+
+/**
+ * nms_keyfile_snapshot_lookup:
+ * @snapshot: (allow-none): the snapshot from nms_keyfile_snapshot_load()
+ * @full_path: the path of the keyfile
+ * @st: the current stat data of @full_path
+ *
+ * Returns: (transfer full): the serialized connection of the snapshot,
+ *   or %NULL if there is none or the file changed since the snapshot
+ *   was written.
+ */
+GVariant *
+nms_keyfile_snapshot_lookup (GHashTable *snapshot,
+                             const char *full_path,
+                             const struct stat *st)
+{
+	GVariant *entry;
+	guint64 mtime_ns, ino, dev, size;
+	GVariant *dict;
+
+	g_return_val_if_fail (full_path, NULL);
+	g_return_val_if_fail (st, NULL);
+
+	if (!snapshot)
+		return NULL;
+
+	entry = g_hash_table_lookup (snapshot, full_path);
+	if (!entry)
+		return NULL;
+
+	g_variant_get (entry, SNAPSHOT_ENTRY_TYPE, NULL, &mtime_ns, &ino, &dev, &size, &dict);
+	if (   mtime_ns != _stat_mtime_ns (st)
+	    || ino != (guint64) st->st_ino
+	    || dev != (guint64) st->st_dev
+	    || size != (guint64) st->st_size) {
+		g_variant_unref (dict);
+		return NULL;
+	}
+
+	return dict;
+}
+
+/**
+ * nms_keyfile_snapshot_connection_new:
+ * @dict: the serialized connection from nms_keyfile_snapshot_lookup()
+ * @st: the current stat data of the keyfile
+ * @error: the failure reason
+ *
+ * The permissions of the file are not part of the snapshot. They
+ * are checked again, like when reading the keyfile.
+ *
+ * Returns: (transfer full): the connection, or %NULL if the file
+ *   may not be loaded or @dict is not a valid connection.
+ */
+NMConnection *
+nms_keyfile_snapshot_connection_new (GVariant *dict,
+                                     const struct stat *st,
+                                     GError **error)
+{
+	gs_unref_object NMConnection *connection = NULL;
+
+	g_return_val_if_fail (dict, NULL);
+	g_return_val_if_fail (st, NULL);
+
+	if (!nms_keyfile_utils_check_file_permissions_stat (NMS_KEYFILE_FILETYPE_KEYFILE,
+	                                                    st,
+	                                                    error))
+		return NULL;
+
+	connection = _nm_simple_connection_new_from_dbus (dict,
+	                                                  NM_SETTING_PARSE_FLAGS_NONE,
+	                                                  error);
+	if (!connection)
+		return NULL;
+
+	if (!nm_connection_get_uuid (connection)) {
+		nm_utils_error_set (error, NM_UTILS_ERROR_UNKNOWN,
+		                    "connection has no UUID");
+		return NULL;
+	}
+
+	return g_steal_pointer (&connection);
+}
+
+void
+nms_keyfile_snapshot_builder_init (GVariantBuilder *builder)
+{
+	g_variant_builder_init (builder, G_VARIANT_TYPE ("a(stttta{sa{sv}})"));
+}
+
+void
+nms_keyfile_snapshot_builder_add (GVariantBuilder *builder,
+                                  const char *full_path,
+                                  const struct stat *st,
+                                  GVariant *dict)
+{
+	g_variant_builder_add (builder, SNAPSHOT_ENTRY_TYPE,
+	                       full_path,
+	                       _stat_mtime_ns (st),
+	                       (guint64) st->st_ino,
+	                       (guint64) st->st_dev,
+	                       (guint64) st->st_size,
+	                       dict);
+}
+
+/**
+ * nms_keyfile_snapshot_save:
+ * @filename: the snapshot file
+ * @version: the version to record in the snapshot
+ * @builder: the entries, initialized with nms_keyfile_snapshot_builder_init().
+ *   The builder is cleared.
+ * @error: the failure reason
+ *
+ * Returns: whether the snapshot was written.
+ */
+gboolean
+nms_keyfile_snapshot_save (const char *filename,
+                           const char *version,
+                           GVariantBuilder *builder,
+                           GError **error)
+{
+	gs_unref_variant GVariant *snapshot = NULL;
+
+	g_return_val_if_fail (filename, FALSE);
+	g_return_val_if_fail (version, FALSE);
+
+	snapshot = g_variant_ref_sink (g_variant_new ("(sa(stttta{sa{sv}}))", version, builder));
+
+	/* the profiles contain secrets. */
+	return nm_utils_file_set_contents (filename,
+	                                   g_variant_get_data (snapshot),
+	                                   g_variant_get_size (snapshot),
+	                                   0600,
+	                                   error);
+}
+
+/*****************************************************************************/
+
 const char *
 nms_keyfile_utils_get_path (void)
 {
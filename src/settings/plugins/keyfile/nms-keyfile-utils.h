@@ -72,4 +72,30 @@ gboolean nms_keyfile_utils_check_file_permissions (NMSKeyfileFiletype filetype,
                                                    struct stat *out_st,
                                                    GError **error);
 
+/*****************************************************************************/
+
+GHashTable *nms_keyfile_snapshot_load (const char *filename,
+                                       const char *version,
+                                       GError **error);
+
+GVariant *nms_keyfile_snapshot_lookup (GHashTable *snapshot,
+                                       const char *full_path,
+                                       const struct stat *st);
+
+NMConnection *nms_keyfile_snapshot_connection_new (GVariant *dict,
+                                                   const struct stat *st,
+                                                   GError **error);
+
+void nms_keyfile_snapshot_builder_init (GVariantBuilder *builder);
+
+void nms_keyfile_snapshot_builder_add (GVariantBuilder *builder,
+                                       const char *full_path,
+                                       const struct stat *st,
+                                       GVariant *dict);
+
+gboolean nms_keyfile_snapshot_save (const char *filename,
+                                    const char *version,
+                                    GVariantBuilder *builder,
+                                    GError **error);
+
 #endif /* __NMS_KEYFILE_UTILS_H__ */
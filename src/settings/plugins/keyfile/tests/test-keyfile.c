@@ -23,6 +23,8 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
@@ -72,6 +74,7 @@ check_ip_route (NMSettingIPConfig *config, int idx, const char *destination, int
 	g_assert (full_filename && full_filename[0] == '/'); \
 	\
 	_connection = nms_keyfile_reader_from_file (full_filename, \
+	                                            NULL, \
 	                                            NULL, \
 	                                            (nmtst_get_rand_int () % 2) ? &_error : NULL); \
 	nmtst_assert_success (_connection, _error); \
@@ -2610,6 +2613,117 @@ test_loaded_uuid (void)
 
 /*****************************************************************************/
 
+static void
+_assert_snapshot_changed (GHashTable *snapshot,
+                          const char *full_path,
+                          const struct timespec *mtime)
+{
+	struct timespec times[2] = {
+		{ .tv_nsec = UTIME_OMIT },
+		*mtime,
+	};
+	struct stat st;
+	gs_unref_variant GVariant *dict = NULL;
+
+	g_assert_cmpint (utimensat (AT_FDCWD, full_path, times, 0), ==, 0);
+	g_assert_cmpint (stat (full_path, &st), ==, 0);
+
+	dict = nms_keyfile_snapshot_lookup (snapshot, full_path, &st);
+	g_assert (!dict);
+}
+
+static void
+test_snapshot (void)
+{
+	const char *snapshot_file = TEST_SCRATCH_DIR"/snapshot-test";
+	const char *full_path = TEST_SCRATCH_DIR"/Test_Snapshot";
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMConnection *connection2 = NULL;
+	gs_unref_variant GVariant *dict = NULL;
+	gs_unref_variant GVariant *dict2 = NULL;
+	gs_unref_hashtable GHashTable *snapshot = NULL;
+	gs_unref_hashtable GHashTable *snapshot2 = NULL;
+	GError *error = NULL;
+	GVariantBuilder builder;
+	struct stat st;
+	struct stat st_dir;
+	struct timespec mtime;
+	gboolean success;
+	FILE *f;
+
+	connection = nmtst_create_minimal_connection ("Test Snapshot", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	nmtst_connection_normalize (connection);
+	dict = g_variant_ref_sink (nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+
+	/* only the stat data of the keyfile matter, not its content. */
+	success = g_file_set_contents (full_path, "[connection]\n", -1, &error);
+	nmtst_assert_success (success, error);
+	g_assert_cmpint (stat (full_path, &st), ==, 0);
+
+	(void) unlink (snapshot_file);
+	snapshot = nms_keyfile_snapshot_load (snapshot_file, VERSION, &error);
+	g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+	g_assert (!snapshot);
+	g_clear_error (&error);
+
+	/* round trip */
+	nms_keyfile_snapshot_builder_init (&builder);
+	nms_keyfile_snapshot_builder_add (&builder, full_path, &st, dict);
+	success = nms_keyfile_snapshot_save (snapshot_file, VERSION, &builder, &error);
+	nmtst_assert_success (success, error);
+
+	snapshot = nms_keyfile_snapshot_load (snapshot_file, VERSION, &error);
+	nmtst_assert_success (snapshot, error);
+	g_assert_cmpint (g_hash_table_size (snapshot), ==, 1);
+
+	g_assert (!nms_keyfile_snapshot_lookup (snapshot, TEST_SCRATCH_DIR"/Test_Snapshot_missing", &st));
+
+	dict2 = nms_keyfile_snapshot_lookup (snapshot, full_path, &st);
+	g_assert (dict2);
+	connection2 = nms_keyfile_snapshot_connection_new (dict2, &st, &error);
+	nmtst_assert_success (connection2, error);
+	nmtst_assert_connection_equals (connection, FALSE, connection2, FALSE);
+	g_clear_object (&connection2);
+
+	/* the permissions are not part of the snapshot and are checked
+	 * again. The owner and mode checks are disabled while testing,
+	 * but a file that is no regular file must still be rejected. */
+	g_assert_cmpint (stat (TEST_SCRATCH_DIR, &st_dir), ==, 0);
+	connection2 = nms_keyfile_snapshot_connection_new (dict2, &st_dir, &error);
+	g_assert_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION);
+	g_assert (!connection2);
+	g_clear_error (&error);
+
+	/* a different modification time requires parsing the file again. */
+	mtime = st.st_mtim;
+	mtime.tv_sec++;
+	_assert_snapshot_changed (snapshot, full_path, &mtime);
+
+	/* a different size requires parsing the file again. Restore the
+	 * modification time, so that only the size differs. */
+	f = fopen (full_path, "a");
+	g_assert (f);
+	g_assert_cmpint (fputs ("\n", f), >=, 0);
+	g_assert_cmpint (fclose (f), ==, 0);
+	_assert_snapshot_changed (snapshot, full_path, &st.st_mtim);
+
+	/* a snapshot of another version is ignored. */
+	nms_keyfile_snapshot_builder_init (&builder);
+	nms_keyfile_snapshot_builder_add (&builder, full_path, &st, dict);
+	success = nms_keyfile_snapshot_save (snapshot_file, "0.0.0-other", &builder, &error);
+	nmtst_assert_success (success, error);
+
+	snapshot2 = nms_keyfile_snapshot_load (snapshot_file, VERSION, &error);
+	g_assert_error (error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN);
+	g_assert (!snapshot2);
+	g_clear_error (&error);
+
+	(void) unlink (snapshot_file);
+	(void) unlink (full_path);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -2699,5 +2813,7 @@ int main (int argc, char **argv)
 
 	g_test_add_func ("/keyfile/test_loaded_uuid", test_loaded_uuid);
 
+	g_test_add_func ("/keyfile/test_snapshot", test_snapshot);
+
 	return g_test_run ();
 }
@@ -44,8 +44,11 @@
 /*****************************************************************************/
 
 typedef struct {
-	GDBusProxy *proxy;
-	gulong change_id;
+	char *object_path;
+
+	/* the (merged) a{sv} properties of the BSS. %NULL until we
+	 * received them, either with the BSSAdded signal or by GetAll. */
+	GVariant *properties;
 } BssData;
 
 typedef struct {
@@ -156,9 +159,14 @@ typedef struct {
 	AssocData *    assoc_data;
 
 	char *         net_path;
-	GHashTable *   bss_proxies;
+	GHashTable *   bss_datas;
 	char *         current_bss;
 
+	/* a single subscription to the PropertiesChanged signals of all
+	 * BSS objects, instead of a GDBusProxy per BSS. */
+	GDBusConnection *bss_dbus_connection;
+	guint          bss_properties_changed_id;
+
 	GHashTable *   peer_proxies;
 
 	gint64         last_scan; /* timestamp as returned by nm_utils_get_monotonic_timestamp_ms() */
@@ -226,121 +234,222 @@ bss_data_destroy (gpointer user_data)
 {
 	BssData *bss_data = user_data;
 
-	nm_clear_g_signal_handler (bss_data->proxy, &bss_data->change_id);
-	g_object_unref (bss_data->proxy);
+	g_free (bss_data->object_path);
+	nm_g_variant_unref (bss_data->properties);
 	g_slice_free (BssData, bss_data);
 }
 
+static GVariant *
+bss_properties_merge (GVariant *properties, GVariant *changed_properties)
+{
+	GVariantBuilder builder;
+	GVariantIter iter;
+	const char *name;
+	GVariant *value;
+
+	if (!properties)
+		return g_variant_ref (changed_properties);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+
+	g_variant_iter_init (&iter, properties);
+	while (g_variant_iter_next (&iter, "{&sv}", &name, &value)) {
+		gs_unref_variant GVariant *v_changed = NULL;
+
+		/* properties that changed are added below. */
+		v_changed = g_variant_lookup_value (changed_properties, name, NULL);
+		if (!v_changed)
+			g_variant_builder_add (&builder, "{sv}", name, value);
+		g_variant_unref (value);
+	}
+
+	g_variant_iter_init (&iter, changed_properties);
+	while (g_variant_iter_next (&iter, "{&sv}", &name, &value)) {
+		g_variant_builder_add (&builder, "{sv}", name, value);
+		g_variant_unref (value);
+	}
+
+	return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
 static void
-bss_proxy_properties_changed_cb (GDBusProxy *proxy,
-                                 GVariant *changed_properties,
-                                 char **invalidated_properties,
-                                 gpointer user_data)
+bss_update_properties (NMSupplicantInterface *self,
+                       BssData *bss_data,
+                       GVariant *changed_properties)
 {
-	NMSupplicantInterface *self = NM_SUPPLICANT_INTERFACE (user_data);
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	gboolean initialized = !!bss_data->properties;
+	GVariant *properties;
 
-	if (priv->scanning)
-		priv->last_scan = nm_utils_get_monotonic_timestamp_ms ();
+	properties = bss_properties_merge (bss_data->properties, changed_properties);
+	nm_g_variant_unref (bss_data->properties);
+	bss_data->properties = properties;
 
 	g_signal_emit (self, signals[BSS_UPDATED], 0,
-	               g_dbus_proxy_get_object_path (proxy),
-	               changed_properties);
+	               bss_data->object_path,
+	               initialized ? changed_properties : bss_data->properties);
+
+	if (   !initialized
+	    && priv->scan_done_pending)
+		scan_done_emit_signal (self);
 }
 
-static GVariant *
-bss_proxy_get_properties (NMSupplicantInterface *self, GDBusProxy *proxy)
+static void
+bss_properties_changed_cb (GDBusConnection *connection,
+                           const char *sender_name,
+                           const char *object_path,
+                           const char *interface_name,
+                           const char *signal_name,
+                           GVariant *parameters,
+                           gpointer user_data)
 {
-	gs_strfreev char **properties = NULL;
-	GVariantBuilder builder;
-	char **iter;
+	NMSupplicantInterface *self = NM_SUPPLICANT_INTERFACE (user_data);
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	gs_unref_variant GVariant *changed_properties = NULL;
+	BssData *bss_data;
 
-	iter = properties = g_dbus_proxy_get_cached_property_names (proxy);
+	if (!g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(sa{sv}as)")))
+		return;
 
-	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
-	if (iter) {
-		while (*iter) {
-			GVariant *copy = g_dbus_proxy_get_cached_property (proxy, *iter);
+	/* the subscription is for all BSS objects of wpa_supplicant. Only consider
+	 * those that we track for this interface. */
+	bss_data = g_hash_table_lookup (priv->bss_datas, object_path);
+	if (!bss_data)
+		return;
 
-			g_variant_builder_add (&builder, "{sv}", *iter++, copy);
-			g_variant_unref (copy);
-		}
+	if (!bss_data->properties) {
+		/* still waiting for the initial GetAll. It will contain the change. */
+		return;
 	}
-	return g_variant_builder_end (&builder);
+
+	if (priv->scanning)
+		priv->last_scan = nm_utils_get_monotonic_timestamp_ms ();
+
+	changed_properties = g_variant_get_child_value (parameters, 1);
+	bss_update_properties (self, bss_data, changed_properties);
 }
 
 static void
-bss_proxy_acquired_cb (GDBusProxy *proxy, GAsyncResult *result, gpointer user_data)
+bss_get_all_cb (GObject *source, GAsyncResult *result, gpointer user_data)
 {
 	NMSupplicantInterface *self;
 	NMSupplicantInterfacePrivate *priv;
+	gs_free char *object_path = NULL;
+	gs_unref_variant GVariant *res = NULL;
+	gs_unref_variant GVariant *properties = NULL;
 	gs_free_error GError *error = NULL;
-	GVariant *props = NULL;
-	const char *object_path;
 	BssData *bss_data;
-	gboolean success;
 
-	success = g_async_initable_init_finish (G_ASYNC_INITABLE (proxy), result, &error);
-	if (   !success
-	    && g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+	nm_utils_user_data_unpack (user_data, &self, &object_path);
+
+	res = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &error);
+	if (nm_utils_error_is_cancelled (error, FALSE))
 		return;
 
-	self = NM_SUPPLICANT_INTERFACE (user_data);
 	priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
-	if (!success) {
-		_LOGD ("failed to acquire BSS proxy: (%s)", error->message);
-		g_hash_table_remove (priv->bss_proxies,
-		                     g_dbus_proxy_get_object_path (proxy));
-		return;
-	}
-
-	object_path = g_dbus_proxy_get_object_path (proxy);
-	bss_data = g_hash_table_lookup (priv->bss_proxies, object_path);
+	bss_data = g_hash_table_lookup (priv->bss_datas, object_path);
 	if (!bss_data)
 		return;
 
-	bss_data->change_id = g_signal_connect (proxy, "g-properties-changed", G_CALLBACK (bss_proxy_properties_changed_cb), self);
+	if (!res) {
+		_LOGD ("failed to get properties of BSS %s: (%s)", object_path, error->message);
+		g_hash_table_remove (priv->bss_datas, object_path);
+		if (priv->scan_done_pending)
+			scan_done_emit_signal (self);
+		return;
+	}
 
-	props = bss_proxy_get_properties (self, proxy);
-	g_signal_emit (self, signals[BSS_UPDATED], 0,
-	               g_dbus_proxy_get_object_path (proxy),
-	               g_variant_ref_sink (props));
-	g_variant_unref (props);
+	if (bss_data->properties) {
+		/* we already got the properties via BSSAdded. */
+		return;
+	}
 
-	if (priv->scan_done_pending)
-		scan_done_emit_signal (self);
+	properties = g_variant_get_child_value (res, 0);
+	bss_update_properties (self, bss_data, properties);
 }
 
 static void
-bss_add_new (NMSupplicantInterface *self, const char *object_path)
+bss_add_new (NMSupplicantInterface *self,
+             const char *object_path,
+             GVariant *properties)
 {
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
-	GDBusProxy *bss_proxy;
 	BssData *bss_data;
 
 	g_return_if_fail (object_path != NULL);
 
-	if (g_hash_table_lookup (priv->bss_proxies, object_path))
+	if (!priv->bss_dbus_connection)
 		return;
 
-	bss_proxy = g_object_new (G_TYPE_DBUS_PROXY,
-	                          "g-bus-type", G_BUS_TYPE_SYSTEM,
-	                          "g-flags", G_DBUS_PROXY_FLAGS_NONE,
-	                          "g-name", WPAS_DBUS_SERVICE,
-	                          "g-object-path", object_path,
-	                          "g-interface-name", WPAS_DBUS_IFACE_BSS,
-	                          NULL);
+	bss_data = g_hash_table_lookup (priv->bss_datas, object_path);
+	if (bss_data) {
+		if (   properties
+		    && !bss_data->properties)
+			bss_update_properties (self, bss_data, properties);
+		return;
+	}
+
 	bss_data = g_slice_new0 (BssData);
-	bss_data->proxy = bss_proxy;
-	g_hash_table_insert (priv->bss_proxies,
-	                     (char *) g_dbus_proxy_get_object_path (bss_proxy),
-	                     bss_data);
-	g_async_initable_init_async (G_ASYNC_INITABLE (bss_proxy),
-	                             G_PRIORITY_DEFAULT,
-	                             priv->other_cancellable,
-	                             (GAsyncReadyCallback) bss_proxy_acquired_cb,
-	                             self);
+	bss_data->object_path = g_strdup (object_path);
+	g_hash_table_insert (priv->bss_datas, bss_data->object_path, bss_data);
+
+	if (properties) {
+		/* BSSAdded carries all properties. No need to ask for them. */
+		bss_update_properties (self, bss_data, properties);
+		return;
+	}
+
+	g_dbus_connection_call (priv->bss_dbus_connection,
+	                        WPAS_DBUS_SERVICE,
+	                        object_path,
+	                        DBUS_INTERFACE_PROPERTIES,
+	                        "GetAll",
+	                        g_variant_new ("(s)", WPAS_DBUS_IFACE_BSS),
+	                        G_VARIANT_TYPE ("(a{sv})"),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        -1,
+	                        priv->other_cancellable,
+	                        bss_get_all_cb,
+	                        nm_utils_user_data_pack (self, g_strdup (object_path)));
+}
+
+static void
+bss_subscribe (NMSupplicantInterface *self)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+
+	nm_assert (priv->iface_proxy);
+
+	if (priv->bss_dbus_connection)
+		return;
+
+	priv->bss_dbus_connection = g_object_ref (g_dbus_proxy_get_connection (priv->iface_proxy));
+	priv->bss_properties_changed_id = g_dbus_connection_signal_subscribe (priv->bss_dbus_connection,
+	                                                                      WPAS_DBUS_SERVICE,
+	                                                                      DBUS_INTERFACE_PROPERTIES,
+	                                                                      "PropertiesChanged",
+	                                                                      NULL,
+	                                                                      WPAS_DBUS_IFACE_BSS,
+	                                                                      G_DBUS_SIGNAL_FLAGS_NONE,
+	                                                                      bss_properties_changed_cb,
+	                                                                      self,
+	                                                                      NULL);
+}
+
+static void
+bss_unsubscribe (NMSupplicantInterface *self)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+
+	if (!priv->bss_dbus_connection)
+		return;
+
+	if (priv->bss_properties_changed_id) {
+		g_dbus_connection_signal_unsubscribe (priv->bss_dbus_connection,
+		                                      nm_steal_int (&priv->bss_properties_changed_id));
+	}
+	g_clear_object (&priv->bss_dbus_connection);
 }
 
 static void
@@ -486,6 +595,7 @@ set_state (NMSupplicantInterface *self, NMSupplicantInterfaceState new_state)
 
 		if (priv->iface_proxy)
 			g_signal_handlers_disconnect_by_data (priv->iface_proxy, self);
+		bss_unsubscribe (self);
 	}
 
 	priv->state = new_state;
@@ -1178,30 +1288,26 @@ static void
 scan_done_emit_signal (NMSupplicantInterface *self)
 {
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
-	const char *object_path;
 	BssData *bss_data;
 	gboolean success;
 	GHashTableIter iter;
 
-	g_hash_table_iter_init (&iter, priv->bss_proxies);
+	g_hash_table_iter_init (&iter, priv->bss_datas);
 	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &bss_data)) {
 		/* we have some BSS' that need to be initialized first. Delay
 		 * emitting signal. */
-		if (!bss_data->change_id) {
+		if (!bss_data->properties) {
 			priv->scan_done_pending = TRUE;
 			return;
 		}
 	}
 
 	/* Emit BSS_UPDATED so that wifi device has the APs (in case it removed them) */
-	g_hash_table_iter_init (&iter, priv->bss_proxies);
-	while (g_hash_table_iter_next (&iter, (gpointer *) &object_path, (gpointer *) &bss_data)) {
-		gs_unref_variant GVariant *props = NULL;
-
-		props = bss_proxy_get_properties (self, bss_data->proxy);
+	g_hash_table_iter_init (&iter, priv->bss_datas);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &bss_data)) {
 		g_signal_emit (self, signals[BSS_UPDATED], 0,
-		               object_path,
-		               g_variant_ref_sink (props));
+		               bss_data->object_path,
+		               bss_data->properties);
 	}
 
 	success = priv->scan_done_success;
@@ -1236,7 +1342,7 @@ wpas_iface_bss_added (GDBusProxy *proxy,
 	if (priv->scanning)
 		priv->last_scan = nm_utils_get_monotonic_timestamp_ms ();
 
-	bss_add_new (self, path);
+	bss_add_new (self, path, props);
 }
 
 static void
@@ -1248,10 +1354,10 @@ wpas_iface_bss_removed (GDBusProxy *proxy,
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 	BssData *bss_data;
 
-	bss_data = g_hash_table_lookup (priv->bss_proxies, path);
+	bss_data = g_hash_table_lookup (priv->bss_datas, path);
 	if (!bss_data)
 		return;
-	g_hash_table_steal (priv->bss_proxies, path);
+	g_hash_table_steal (priv->bss_datas, path);
 	g_signal_emit (self, signals[BSS_REMOVED], 0, path);
 	bss_data_destroy (bss_data);
 }
@@ -1301,7 +1407,7 @@ props_changed_cb (GDBusProxy *proxy,
 	if (g_variant_lookup (changed_properties, "BSSs", "^a&o", &array)) {
 		iter = array;
 		while (*iter)
-			bss_add_new (self, *iter++);
+			bss_add_new (self, *iter++, NULL);
 		g_free (array);
 	}
 
@@ -1604,6 +1710,8 @@ on_iface_proxy_acquired (GDBusProxy *proxy, GAsyncResult *result, gpointer user_
 	self = NM_SUPPLICANT_INTERFACE (user_data);
 	priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
+	bss_subscribe (self);
+
 	_nm_dbus_signal_connect (priv->iface_proxy, "ScanDone", G_VARIANT_TYPE ("(b)"),
 	                         G_CALLBACK (wpas_iface_scan_done), self);
 	_nm_dbus_signal_connect (priv->iface_proxy, "BSSAdded", G_VARIANT_TYPE ("(oa{sv})"),
@@ -2697,7 +2805,7 @@ nm_supplicant_interface_init (NMSupplicantInterface * self)
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
 	priv->state = NM_SUPPLICANT_INTERFACE_STATE_INIT;
-	priv->bss_proxies = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, bss_data_destroy);
+	priv->bss_datas = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, bss_data_destroy);
 	priv->peer_proxies = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, peer_data_destroy);
 }
 
@@ -2768,7 +2876,8 @@ dispose (GObject *object)
 	if (priv->wpas_proxy)
 		g_signal_handlers_disconnect_by_data (priv->wpas_proxy, object);
 	g_clear_object (&priv->wpas_proxy);
-	g_clear_pointer (&priv->bss_proxies, g_hash_table_destroy);
+	bss_unsubscribe (self);
+	g_clear_pointer (&priv->bss_datas, g_hash_table_destroy);
 	g_clear_pointer (&priv->peer_proxies, g_hash_table_destroy);
 
 	g_clear_pointer (&priv->net_path, g_free);
@@ -1093,24 +1093,49 @@ test_connection_sort_autoconnect_priority (void)
 
 #define MATCH_S390 "S390:"
 #define MATCH_DRIVER "DRIVER:"
+#define MATCH_HWADDR "HWADDR:"
 
 static NMMatchSpecMatchType
 _test_match_spec_device (const GSList *specs, const char *match_str)
 {
+	NMMatchSpecDeviceData data = { 0 };
+	NMMatchSpecMatchType m;
+	NMMatchSpecDevice *compiled;
+	gs_free char *s = NULL;
+
 	if (match_str && g_str_has_prefix (match_str, MATCH_S390))
-		return nm_match_spec_device (specs, NULL, NULL, NULL, NULL, NULL, &match_str[NM_STRLEN (MATCH_S390)], NULL);
-	if (match_str && g_str_has_prefix (match_str, MATCH_DRIVER)) {
-		gs_free char *s = g_strdup (&match_str[NM_STRLEN (MATCH_DRIVER)]);
+		data.s390_subchannels = &match_str[NM_STRLEN (MATCH_S390)];
+	else if (match_str && g_str_has_prefix (match_str, MATCH_DRIVER)) {
 		char *t;
 
+		s = g_strdup (&match_str[NM_STRLEN (MATCH_DRIVER)]);
 		t = strchr (s, '|');
 		if (t) {
 			t[0] = '\0';
 			t++;
 		}
-		return nm_match_spec_device (specs, NULL, NULL, s, t, NULL, NULL, NULL);
-	}
-	return nm_match_spec_device (specs, match_str, NULL, NULL, NULL, NULL, NULL, NULL);
+		data.driver = s;
+		data.driver_version = t;
+	} else if (match_str && g_str_has_prefix (match_str, MATCH_HWADDR))
+		data.hwaddr = &match_str[NM_STRLEN (MATCH_HWADDR)];
+	else
+		data.interface_name = match_str;
+
+	m = nm_match_spec_device (specs,
+	                          data.interface_name,
+	                          data.device_type,
+	                          data.driver,
+	                          data.driver_version,
+	                          data.hwaddr,
+	                          data.s390_subchannels,
+	                          data.dhcp_plugin);
+
+	/* the precompiled matcher must always agree. */
+	compiled = nm_match_spec_device_compile (specs);
+	g_assert_cmpint (m, ==, nm_match_spec_device_compiled_match (compiled, &data));
+	nm_match_spec_device_free (compiled);
+
+	return m;
 }
 
 static void
@@ -1283,6 +1308,23 @@ test_match_spec_device (void)
 	                            NM_MAKE_STRV (MATCH_DRIVER"DRV/|1.5", MATCH_DRIVER"DRV/|1.5.2"),
 	                            NM_MAKE_STRV (MATCH_DRIVER"DRV/", MATCH_DRIVER"DRV/|1.6", MATCH_DRIVER"DR", MATCH_DRIVER"DR*"),
 	                            NULL);
+
+	_do_test_match_spec_device ("mac:00:11:22:33:44:aa",
+	                            NM_MAKE_STRV (MATCH_HWADDR"00:11:22:33:44:aa", MATCH_HWADDR"00:11:22:33:44:AA"),
+	                            NM_MAKE_STRV (MATCH_HWADDR"00:11:22:33:44:ab", MATCH_HWADDR"00:11:22:33:44", "em1"),
+	                            NULL);
+	_do_test_match_spec_device ("*,except:mac:00:11:22:33:44:aa",
+	                            NULL,
+	                            NM_MAKE_STRV (NULL),
+	                            NM_MAKE_STRV (MATCH_HWADDR"00:11:22:33:44:aa"));
+
+	/* for InfiniBand addresses only the last 8 bytes are compared. */
+	_do_test_match_spec_device ("mac:80:00:02:08:fe:80:00:00:00:00:00:00:00:02:c9:03:00:00:0f:65",
+	                            NM_MAKE_STRV (MATCH_HWADDR"80:00:02:08:fe:80:00:00:00:00:00:00:00:02:c9:03:00:00:0f:65",
+	                                          MATCH_HWADDR"80:00:00:48:fe:80:00:00:00:00:00:00:00:02:c9:03:00:00:0f:65"),
+	                            NM_MAKE_STRV (MATCH_HWADDR"80:00:02:08:fe:80:00:00:00:00:00:00:00:02:c9:03:00:00:0f:66",
+	                                          MATCH_HWADDR"00:02:c9:03:00:00:0f:65"),
+	                            NULL);
 }
 
 /*****************************************************************************/